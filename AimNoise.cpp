@@ -0,0 +1,105 @@
+#include "AimNoise.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+AimNoise::AimNoise(float error, std::uint32_t period, std::uint64_t seed, std::uint64_t matchId) :
+m_error(static_cast<MatchDefinitions::Fixed>(std::max(error, 0.f) * MatchDefinitions::FixedOne)),
+m_range(static_cast<std::uint32_t>(m_error) * 2 + 1),
+m_period(std::max(period, std::uint32_t{1})),
+m_philox(seed),
+m_matchId(matchId),
+m_blocks(),
+m_aims()
+{
+    draw();
+}
+
+
+////////////////////////////////////////////////////////////
+void AimNoise::step()
+{
+    if (++m_ticks == m_period)
+    {
+        m_ticks = 0;
+        draw();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint32_t AimNoise::getSteadyTicks() const
+{
+    return m_period - m_ticks;
+}
+
+
+////////////////////////////////////////////////////////////
+void AimNoise::advance(std::uint32_t ticks)
+{
+    assert(ticks <= getSteadyTicks() && "Advancing past a draw");
+
+    m_ticks += ticks;
+    if (m_ticks == m_period)
+    {
+        m_ticks = 0;
+        draw();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+MatchDefinitions::Fixed AimNoise::getAim(std::size_t side) const
+{
+    return m_aims[side];
+}
+
+
+////////////////////////////////////////////////////////////
+void AimNoise::draw()
+{
+    // Draw n happens at tick n * period; the next ones are generated along with it
+    const std::size_t batchSize = std::size(m_blocks);
+    const std::size_t index     = m_draws % batchSize;
+    if (index == 0)
+        m_philox.generate(m_matchId,
+                          m_draws * m_period,
+                          m_period,
+                          static_cast<std::uint32_t>(MatchDefinitions::Draw::Aim),
+                          m_blocks,
+                          batchSize);
+
+    // Each draw moves both aims, one word each
+    const Philox::Block& block = m_blocks[index];
+    m_aims[MatchDefinitions::Left]  = static_cast<MatchDefinitions::Fixed>(block[0] % m_range) - m_error;
+    m_aims[MatchDefinitions::Right] = static_cast<MatchDefinitions::Fixed>(block[1] % m_range) - m_error;
+    ++m_draws;
+}
+
+
+////////////////////////////////////////////////////////////
+MatchDefinitions::State playNoisyMatch(const PaddleAi& left,
+                                       const PaddleAi& right,
+                                       float           aimError,
+                                       std::uint32_t   aimTicks,
+                                       std::uint32_t   maxTicks,
+                                       std::uint64_t   seed,
+                                       std::uint64_t   matchId)
+{
+    ClassicMatch match(ClassicRules(), seed, matchId);
+    AimNoise     noise(aimError, aimTicks, seed, matchId);
+    match.start();
+
+    std::uint32_t tick = 0;
+    while ((tick < maxTicks) && (match.getState().phase != MatchDefinitions::Phase::Over))
+        tick += playNoisyTicks(match, left, right, noise, maxTicks - tick);
+
+    return match.getState();
+}
+
+} // namespace pong
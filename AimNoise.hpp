@@ -0,0 +1,196 @@
+#pragma once
+
+#include "Match.hpp"
+#include "PaddleAi.hpp"
+#include "Philox.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Random aim errors of two computer players
+///
+/// Two PaddleAi players following the ball's center never miss
+/// it, so simulated matches between them replay the same rally
+/// forever. With aim noise, each player aims at a random point
+/// around the ball, drawn again every few ticks, and sometimes
+/// misses; matches end, and the better player wins more often.
+///
+/// The offsets are Philox draws keyed by the seed, the match's
+/// id and the tick of the draw, so a simulated match only
+/// depends on its seed and id, and matches sharing a seed but
+/// not an id are independent. Draws are generated in batches.
+///
+/// Usage example:
+/// \code
+/// pong::AimNoise noise(24.f, 30, seed, matchId);
+/// while (match.getState().phase != pong::Match::Phase::Over)
+/// {
+///     match.step(left.decide(match, pong::Match::Left, noise.getAim(pong::Match::Left)),
+///                right.decide(match, pong::Match::Right, noise.getAim(pong::Match::Right)));
+///     noise.step();
+/// }
+/// \endcode
+///
+/// \see playNoisyMatch, playNoisyTicks
+///
+////////////////////////////////////////////////////////////
+class AimNoise
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the noise and draw the first aims
+    ///
+    /// \param error   Largest distance between the ball and the point aimed at, in pixels
+    /// \param period  Ticks between changes of the points aimed at, at least 1
+    /// \param seed    Seed of the offsets
+    /// \param matchId Index of the match among the ones sharing its seed
+    ///
+    ////////////////////////////////////////////////////////////
+    AimNoise(float error, std::uint32_t period, std::uint64_t seed, std::uint64_t matchId = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Move to the next tick, drawing new aims every period
+    ///
+    ////////////////////////////////////////////////////////////
+    void step();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of next ticks with the current aims
+    ///
+    /// \return Number of ticks before the next draw, at least 1
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint32_t getSteadyTicks() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Move several ticks ahead, as many calls to step() would
+    ///
+    /// \param ticks Number of ticks, at most getSteadyTicks()
+    ///
+    ////////////////////////////////////////////////////////////
+    void advance(std::uint32_t ticks);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the aim offset of a side, for PaddleAi::decide()
+    ///
+    /// \param side Match::Left or Match::Right
+    ///
+    /// \return Offset from the ball's center, in fixed pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    MatchDefinitions::Fixed getAim(std::size_t side) const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the aims of both sides
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    MatchDefinitions::Fixed m_error;     //!< Largest offset, in fixed pixels
+    std::uint32_t           m_range;     //!< Number of possible offsets
+    std::uint32_t           m_period;    //!< Ticks between draws
+    std::uint32_t           m_ticks{};   //!< Ticks since the last draw
+    std::uint32_t           m_draws{};   //!< Number of draws so far
+    Philox                  m_philox;    //!< Generator of the offsets
+    std::uint64_t           m_matchId;   //!< Stream of the offsets
+    Philox::Block           m_blocks[8]; //!< Random numbers of the current batch of draws
+    MatchDefinitions::Fixed m_aims[2];   //!< Current offset of each side
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Play a ClassicMatch between two computer players with aim noise
+///
+/// The match and the noise share the seed and the id, the
+/// purposes of their draws tell them apart; the match only
+/// depends on the arguments.
+///
+/// \param left     Player of the left paddle
+/// \param right    Player of the right paddle
+/// \param aimError Largest distance between the ball and the point aimed at, in pixels
+/// \param aimTicks Ticks between changes of the points aimed at
+/// \param maxTicks Ticks after which the match stops, over or not
+/// \param seed     Seed of the match and of the noise
+/// \param matchId  Index of the match among the ones sharing its seed
+///
+/// \return Final state of the match, whose tick is the number of ticks played
+///
+////////////////////////////////////////////////////////////
+MatchDefinitions::State playNoisyMatch(const PaddleAi& left,
+                                       const PaddleAi& right,
+                                       float           aimError,
+                                       std::uint32_t   aimTicks,
+                                       std::uint32_t   maxTicks,
+                                       std::uint64_t   seed,
+                                       std::uint64_t   matchId = 0);
+
+////////////////////////////////////////////////////////////
+/// \brief Play a match between two computer players with aim noise, up to its next event
+///
+/// Event-driven equivalent of calling step() on the match and
+/// the noise, with the players' decisions, for up to \a maxTicks
+/// ticks. While the ball flies straight and the aims don't
+/// change, the players are only asked for the moves of their
+/// paddles over the whole stretch, which is then simulated at
+/// once with BasicMatch::advance(); ticks that may have an
+/// event are simulated with step(). Repeated calls play the
+/// match exactly as tick by tick, in far fewer steps.
+///
+/// \param match    Match being played, with any rules
+/// \param left     Player of the left paddle
+/// \param right    Player of the right paddle
+/// \param noise    Aim noise of the players
+/// \param maxTicks Largest number of ticks to play
+///
+/// \return Number of ticks played, at least 1 unless \a maxTicks is 0
+///
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+std::uint32_t playNoisyTicks(BasicMatch<RulesPolicy>& match,
+                             const PaddleAi&          left,
+                             const PaddleAi&          right,
+                             AimNoise&                noise,
+                             std::uint32_t            maxTicks);
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+std::uint32_t playNoisyTicks(BasicMatch<RulesPolicy>& match,
+                             const PaddleAi&          left,
+                             const PaddleAi&          right,
+                             AimNoise&                noise,
+                             std::uint32_t            maxTicks)
+{
+    constexpr std::size_t leftSide  = MatchDefinitions::Left;
+    constexpr std::size_t rightSide = MatchDefinitions::Right;
+
+    if (maxTicks == 0)
+        return 0;
+
+    const std::uint32_t quiet = std::min({match.getQuietTicks(), noise.getSteadyTicks(), maxTicks});
+    if (quiet == 0)
+    {
+        match.step(left.decide(match, leftSide, noise.getAim(leftSide)),
+                   right.decide(match, rightSide, noise.getAim(rightSide)));
+        noise.step();
+        return 1;
+    }
+
+    // Both courses cover all the quiet ticks
+    const MatchDefinitions::Course leftCourse  = left.plan(match, leftSide, quiet, noise.getAim(leftSide));
+    const MatchDefinitions::Course rightCourse = right.plan(match, rightSide, quiet, noise.getAim(rightSide));
+
+    match.advance(leftCourse, rightCourse);
+    noise.advance(quiet);
+    return quiet;
+}
+
+} // namespace pong
@@ -0,0 +1,73 @@
+#include "BinaryIo.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace
+{
+constexpr std::size_t magicLength = 7;
+constexpr std::size_t maxLength   = 0xFF;
+
+} // namespace
+
+
+namespace pong::binary
+{
+////////////////////////////////////////////////////////////
+void writeHeader(std::ostream& stream, const char* magic, std::uint8_t version)
+{
+    stream.write(magic, magicLength);
+    write(stream, version);
+}
+
+
+////////////////////////////////////////////////////////////
+bool readHeader(std::istream& stream, const char* magic, std::uint8_t version)
+{
+    char         fileMagic[magicLength] = {};
+    std::uint8_t fileVersion            = 0;
+    stream.read(fileMagic, magicLength);
+    read(stream, fileVersion);
+
+    return stream && (std::memcmp(fileMagic, magic, magicLength) == 0) && (fileVersion == version);
+}
+
+
+////////////////////////////////////////////////////////////
+void write(std::ostream& stream, float value)
+{
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    write(stream, bits);
+}
+
+
+////////////////////////////////////////////////////////////
+void write(std::ostream& stream, const std::string& value)
+{
+    const std::size_t length = std::min(value.size(), maxLength);
+    write(stream, static_cast<std::uint8_t>(length));
+    stream.write(value.data(), static_cast<std::streamsize>(length));
+}
+
+
+////////////////////////////////////////////////////////////
+void read(std::istream& stream, float& value)
+{
+    std::uint32_t bits = 0;
+    read(stream, bits);
+    std::memcpy(&value, &bits, sizeof(value));
+}
+
+
+////////////////////////////////////////////////////////////
+void read(std::istream& stream, std::string& value)
+{
+    std::uint8_t length = 0;
+    read(stream, length);
+    value.resize(length);
+    stream.read(value.data(), length);
+}
+
+} // namespace pong::binary
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+
+namespace pong::binary
+{
+////////////////////////////////////////////////////////////
+// Little-endian binary files
+//
+// Results and checkpoints are written field by field, as
+// little-endian unsigned integers and IEEE floats, so that
+// files are compact and portable whatever the layout of the
+// structures they come from. Files start with a 7-character
+// magic string and a version byte.
+//
+// Reads past the end of a stream set its failbit: read every
+// field, then check the stream once.
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+/// \brief Write the magic string and the version of a file
+///
+/// \param magic 7 characters identifying the kind of file
+///
+////////////////////////////////////////////////////////////
+void writeHeader(std::ostream& stream, const char* magic, std::uint8_t version);
+
+////////////////////////////////////////////////////////////
+/// \brief Read the header of a file and check it
+///
+/// \return True if the magic string and the version match
+///
+////////////////////////////////////////////////////////////
+bool readHeader(std::istream& stream, const char* magic, std::uint8_t version);
+
+////////////////////////////////////////////////////////////
+/// \brief Write an unsigned integer
+///
+////////////////////////////////////////////////////////////
+template <typename T>
+void write(std::ostream& stream, T value);
+
+////////////////////////////////////////////////////////////
+/// \brief Write a float
+///
+////////////////////////////////////////////////////////////
+void write(std::ostream& stream, float value);
+
+////////////////////////////////////////////////////////////
+/// \brief Write a string, with its length in a byte
+///
+/// Strings are truncated to 255 bytes.
+///
+////////////////////////////////////////////////////////////
+void write(std::ostream& stream, const std::string& value);
+
+////////////////////////////////////////////////////////////
+/// \brief Read an unsigned integer
+///
+////////////////////////////////////////////////////////////
+template <typename T>
+void read(std::istream& stream, T& value);
+
+////////////////////////////////////////////////////////////
+/// \brief Read a float
+///
+////////////////////////////////////////////////////////////
+void read(std::istream& stream, float& value);
+
+////////////////////////////////////////////////////////////
+/// \brief Read a string written by write()
+///
+////////////////////////////////////////////////////////////
+void read(std::istream& stream, std::string& value);
+
+
+////////////////////////////////////////////////////////////
+template <typename T>
+void write(std::ostream& stream, T value)
+{
+    static_assert(std::is_unsigned_v<T>, "only unsigned integers are written as is");
+
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        stream.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename T>
+void read(std::istream& stream, T& value)
+{
+    static_assert(std::is_unsigned_v<T>, "only unsigned integers are read as is");
+
+    value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        value |= static_cast<T>(static_cast<T>(static_cast<unsigned char>(stream.get())) << (i * 8));
+}
+
+} // namespace pong::binary
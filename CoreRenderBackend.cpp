@@ -0,0 +1,393 @@
+#include "CoreRenderBackend.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Attribute locations are fixed in the shader so that the
+// vertex array can be set up before linking is even checked.
+////////////////////////////////////////////////////////////
+constexpr pong::gl::GLuint positionAttribute  = 0;
+constexpr pong::gl::GLuint colorAttribute     = 1;
+constexpr pong::gl::GLuint texCoordsAttribute = 2;
+
+constexpr const char* vertexShaderSource = R"(
+#version 330 core
+
+uniform mat4 transform;
+uniform vec2 textureScale;
+
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec4 color;
+layout(location = 2) in vec2 texCoords;
+
+out vec4 vertexColor;
+out vec2 vertexTexCoords;
+
+void main()
+{
+    gl_Position     = transform * vec4(position, 0.0, 1.0);
+    vertexColor     = color;
+    vertexTexCoords = texCoords * textureScale;
+}
+)";
+
+constexpr const char* fragmentShaderSource = R"(
+#version 330 core
+
+uniform sampler2D texture0;
+uniform bool      textured;
+
+in vec4 vertexColor;
+in vec2 vertexTexCoords;
+
+out vec4 fragmentColor;
+
+void main()
+{
+    fragmentColor = textured ? texture(texture0, vertexTexCoords) * vertexColor : vertexColor;
+}
+)";
+
+
+////////////////////////////////////////////////////////////
+// Compile a shader stage, returning 0 on failure
+////////////////////////////////////////////////////////////
+pong::gl::GLuint compileShader(pong::gl::GLenum type, const char* source)
+{
+    namespace gl = pong::gl;
+
+    const gl::GLuint shader = gl::CreateShader(type);
+    gl::ShaderSource(shader, 1, &source, nullptr);
+    gl::CompileShader(shader);
+
+    gl::GLint success = 0;
+    gl::GetShaderiv(shader, gl::COMPILE_STATUS, &success);
+
+    if (!success)
+    {
+        char log[1024];
+        gl::GetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        sf::err() << "Failed to compile the core profile "
+                  << (type == gl::VERTEX_SHADER ? "vertex" : "fragment") << " shader:\n"
+                  << log << std::endl;
+
+        gl::DeleteShader(shader);
+        return 0;
+    }
+
+    return shader;
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+CoreRenderBackend::CoreRenderBackend(sf::RenderTarget& target) : m_target(target)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+CoreRenderBackend::~CoreRenderBackend()
+{
+    if (!m_program)
+        return;
+
+    gl::DeleteVertexArrays(1, &m_vertexArray);
+    gl::DeleteProgram(m_program);
+}
+
+
+////////////////////////////////////////////////////////////
+bool CoreRenderBackend::create(std::size_t frameCapacity, bool persistent)
+{
+    if (!isAvailable())
+    {
+        sf::err() << "Core profile rendering is not supported by the current context" << std::endl;
+        return false;
+    }
+
+    const gl::GLuint vertexShader   = compileShader(gl::VERTEX_SHADER, vertexShaderSource);
+    const gl::GLuint fragmentShader = compileShader(gl::FRAGMENT_SHADER, fragmentShaderSource);
+
+    if (!vertexShader || !fragmentShader)
+    {
+        if (vertexShader)
+            gl::DeleteShader(vertexShader);
+        if (fragmentShader)
+            gl::DeleteShader(fragmentShader);
+        return false;
+    }
+
+    const gl::GLuint program = gl::CreateProgram();
+    gl::AttachShader(program, vertexShader);
+    gl::AttachShader(program, fragmentShader);
+    gl::LinkProgram(program);
+
+    // The program keeps the stages alive as long as it needs them
+    gl::DeleteShader(vertexShader);
+    gl::DeleteShader(fragmentShader);
+
+    gl::GLint success = 0;
+    gl::GetProgramiv(program, gl::LINK_STATUS, &success);
+
+    if (!success)
+    {
+        char log[1024];
+        gl::GetProgramInfoLog(program, sizeof(log), nullptr, log);
+        sf::err() << "Failed to link the core profile shader:\n" << log << std::endl;
+
+        gl::DeleteProgram(program);
+        return false;
+    }
+
+    m_program               = program;
+    m_uniforms.transform    = gl::GetUniformLocation(m_program, "transform");
+    m_uniforms.textureScale = gl::GetUniformLocation(m_program, "textureScale");
+    m_uniforms.texture      = gl::GetUniformLocation(m_program, "texture0");
+    m_uniforms.textured     = gl::GetUniformLocation(m_program, "textured");
+
+    gl::UseProgram(m_program);
+    gl::Uniform1i(m_uniforms.texture, 0);
+
+    // The vertex layout never changes: only the buffer it points to may
+    gl::GenVertexArrays(1, &m_vertexArray);
+    gl::BindVertexArray(m_vertexArray);
+    gl::EnableVertexAttribArray(positionAttribute);
+    gl::EnableVertexAttribArray(colorAttribute);
+    gl::EnableVertexAttribArray(texCoordsAttribute);
+
+    if (!m_stream.create(frameCapacity, persistent))
+        return false;
+
+    m_attributeBuffer  = 0;
+    m_streamGeneration = m_stream.getGeneration();
+    bindAttributes(m_stream.getBuffer());
+
+    m_statesValid = false;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool CoreRenderBackend::isAvailable()
+{
+    return gl::isCoreProfileAvailable();
+}
+
+
+////////////////////////////////////////////////////////////
+const StreamingVertexRing::Statistics& CoreRenderBackend::getStreamingStatistics() const
+{
+    return m_stream.getStatistics();
+}
+
+
+////////////////////////////////////////////////////////////
+bool CoreRenderBackend::isStreamPersistent() const
+{
+    return m_stream.isPersistent();
+}
+
+
+////////////////////////////////////////////////////////////
+sf::RenderTarget& CoreRenderBackend::getTarget()
+{
+    return m_target;
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderBackend::clear(const sf::Color& color)
+{
+    // Another context may have been loaded since the last frame
+    gl::load();
+
+    m_stream.nextFrame();
+    resetStates();
+    applyViewport();
+
+    gl::ClearColor(color.r / 255.f, color.g / 255.f, color.b / 255.f, color.a / 255.f);
+    gl::Clear(gl::COLOR_BUFFER_BIT);
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderBackend::draw(const sf::Vertex*       vertices,
+                             std::size_t             vertexCount,
+                             sf::PrimitiveType       type,
+                             const sf::RenderStates& states)
+{
+    if (!vertices || (vertexCount == 0))
+        return;
+
+    sf::Vertex* stream = reserve(vertexCount);
+    if (!stream)
+        return;
+
+    std::memcpy(stream, vertices, vertexCount * sizeof(sf::Vertex));
+    drawReserved(vertexCount, type, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderBackend::draw(const sf::VertexBuffer& vertexBuffer,
+                             std::size_t             firstVertex,
+                             std::size_t             vertexCount,
+                             const sf::RenderStates& states)
+{
+    const std::size_t bufferSize = vertexBuffer.getVertexCount();
+    if (!m_program || !vertexBuffer.getNativeHandle() || (firstVertex >= bufferSize))
+        return;
+
+    vertexCount = std::min(vertexCount, bufferSize - firstVertex);
+    if (vertexCount == 0)
+        return;
+
+    // The buffer already lives on the GPU: draw it in place instead of copying it to the stream
+    applyStates(states);
+    bindAttributes(vertexBuffer.getNativeHandle());
+    gl::DrawArrays(gl::primitiveTypeToGl(vertexBuffer.getPrimitiveType()),
+                   static_cast<gl::GLint>(firstVertex),
+                   static_cast<gl::GLsizei>(vertexCount));
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Vertex* CoreRenderBackend::reserve(std::size_t vertexCount)
+{
+    if (!m_program || (vertexCount == 0))
+        return nullptr;
+
+    return m_stream.map(vertexCount);
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderBackend::drawReserved(std::size_t vertexCount, sf::PrimitiveType type, const sf::RenderStates& states)
+{
+    const gl::GLint first = m_stream.unmap(vertexCount);
+    if (vertexCount == 0)
+        return;
+
+    // A grown stream buffer may reuse the old name, but deleting the old one unbound it from the vertex array
+    if (m_stream.getGeneration() != m_streamGeneration)
+    {
+        m_attributeBuffer  = 0;
+        m_streamGeneration = m_stream.getGeneration();
+    }
+
+    applyStates(states);
+    bindAttributes(m_stream.getBuffer());
+    gl::DrawArrays(gl::primitiveTypeToGl(type), first, static_cast<gl::GLsizei>(vertexCount));
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderBackend::resetStates()
+{
+    gl::UseProgram(m_program);
+    gl::BindVertexArray(m_vertexArray);
+
+    // Force every state to be set again by the next draw
+    m_viewport  = sf::IntRect({-1, -1}, {-1, -1});
+    m_texture   = 0;
+    m_transform = sf::Transform::Identity;
+    m_blendMode = sf::BlendAlpha;
+
+    gl::UniformMatrix4fv(m_uniforms.transform, 1, false, m_transform.getMatrix());
+    gl::applyBlendMode(m_blendMode);
+    gl::BindTexture(gl::TEXTURE_2D, 0);
+    gl::Uniform1i(m_uniforms.textured, 0);
+    gl::Uniform2f(m_uniforms.textureScale, 0.f, 0.f);
+
+    m_statesValid = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderBackend::applyViewport()
+{
+    const sf::IntRect viewport = m_target.getViewport(m_target.getView());
+    if (viewport == m_viewport)
+        return;
+
+    // OpenGL's origin is the bottom-left corner
+    const int top = static_cast<int>(m_target.getSize().y) - (viewport.top + viewport.height);
+    gl::Viewport(viewport.left, top, viewport.width, viewport.height);
+    m_viewport = viewport;
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderBackend::applyTexture(const sf::Texture* texture)
+{
+    const gl::GLuint handle = texture ? texture->getNativeHandle() : 0;
+    if (handle == m_texture)
+        return;
+
+    gl::ActiveTexture(gl::TEXTURE0);
+    gl::BindTexture(gl::TEXTURE_2D, handle);
+    gl::Uniform1i(m_uniforms.textured, handle != 0);
+
+    if (handle)
+    {
+        const sf::Vector2u size = texture->getSize();
+        gl::Uniform2f(m_uniforms.textureScale, 1.f / static_cast<float>(size.x), 1.f / static_cast<float>(size.y));
+    }
+
+    m_texture = handle;
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderBackend::applyStates(const sf::RenderStates& states)
+{
+    if (!m_statesValid)
+        resetStates();
+
+    applyViewport();
+    applyTexture(states.texture);
+
+    const sf::Transform transform = m_target.getView().getTransform() * states.transform;
+    if (transform != m_transform)
+    {
+        gl::UniformMatrix4fv(m_uniforms.transform, 1, false, transform.getMatrix());
+        m_transform = transform;
+    }
+
+    if (states.blendMode != m_blendMode)
+    {
+        gl::applyBlendMode(states.blendMode);
+        m_blendMode = states.blendMode;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void CoreRenderBackend::bindAttributes(gl::GLuint buffer)
+{
+    if (buffer == m_attributeBuffer)
+        return;
+
+    // The attribute pointers capture the buffer bound to ARRAY_BUFFER
+    gl::BindVertexArray(m_vertexArray);
+    gl::BindBuffer(gl::ARRAY_BUFFER, buffer);
+
+    const auto stride = static_cast<gl::GLsizei>(sizeof(sf::Vertex));
+    gl::VertexAttribPointer(positionAttribute, 2, gl::FLOAT, false, stride, reinterpret_cast<const void*>(offsetof(sf::Vertex, position)));
+    gl::VertexAttribPointer(colorAttribute, 4, gl::UNSIGNED_BYTE, true, stride, reinterpret_cast<const void*>(offsetof(sf::Vertex, color)));
+    gl::VertexAttribPointer(texCoordsAttribute, 2, gl::FLOAT, false, stride, reinterpret_cast<const void*>(offsetof(sf::Vertex, texCoords)));
+
+    m_attributeBuffer = buffer;
+}
+
+} // namespace pong
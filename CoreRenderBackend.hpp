@@ -0,0 +1,181 @@
+#pragma once
+
+#include "GlFunctions.hpp"
+#include "RenderBackend.hpp"
+#include "StreamingVertexRing.hpp"
+#include "sfml.h"
+
+#include <cstddef>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief OpenGL 3.3 core profile rendering backend
+///
+/// sf::RenderTarget relies on the fixed-function pipeline and
+/// client-side vertex arrays, neither of which exist in a core
+/// profile context. This backend draws the same sf::Vertex
+/// arrays with a built-in GLSL 330 shader, a vertex array
+/// object set up once, and a single vertex buffer allocated
+/// once and filled front to back; when it is full it is
+/// orphaned and filling starts over, so the driver never has
+/// to wait for the GPU to release the range being written.
+///
+/// Textures, blend modes, transforms and the target's view are
+/// supported; custom sf::Shader objects are not, since they
+/// cannot be used in a core profile context, and are ignored.
+/// The textures' pixel coordinates are normalized with their
+/// size, which assumes that they are not flipped (textures of
+/// sf::RenderTexture are).
+///
+/// sf::VertexBuffer draws point the vertex array object at the
+/// buffer itself, so static geometry is never copied.
+///
+/// The backend tracks the OpenGL state it sets and skips
+/// redundant changes; clear() invalidates that cache, so
+/// external OpenGL code may run between frames.
+///
+/// Unlike SFML's resources, the backend doesn't depend on
+/// SFML's shared context, so it also draws to targets whose
+/// context SFML doesn't manage, like HeadlessRenderTarget.
+///
+////////////////////////////////////////////////////////////
+class CoreRenderBackend final : public RenderBackend
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the backend
+    ///
+    /// The OpenGL objects are created by create().
+    ///
+    /// \param target Render target to draw to
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit CoreRenderBackend(sf::RenderTarget& target);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// The target's context must be active.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~CoreRenderBackend() override;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    CoreRenderBackend(const CoreRenderBackend&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy assignment
+    ///
+    ////////////////////////////////////////////////////////////
+    CoreRenderBackend& operator=(const CoreRenderBackend&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compile the shader and create the buffers
+    ///
+    /// The target's context must be active.
+    ///
+    /// \param frameCapacity Number of vertices a frame is expected to stream
+    /// \param persistent    Map the vertex stream persistently if supported
+    ///
+    /// \return True if successful
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool create(std::size_t frameCapacity = 16384, bool persistent = true);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the current context supports this backend
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the vertex stream's counters
+    ///
+    ////////////////////////////////////////////////////////////
+    const StreamingVertexRing::Statistics& getStreamingStatistics() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the vertex stream is persistently mapped
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isStreamPersistent() const;
+
+    sf::RenderTarget& getTarget() override;
+    void              clear(const sf::Color& color = sf::Color::Black) override;
+    void              draw(const sf::Vertex*       vertices,
+                           std::size_t             vertexCount,
+                           sf::PrimitiveType       type,
+                           const sf::RenderStates& states) override;
+    void              draw(const sf::VertexBuffer& vertexBuffer,
+                           std::size_t             firstVertex,
+                           std::size_t             vertexCount,
+                           const sf::RenderStates& states) override;
+    sf::Vertex*       reserve(std::size_t vertexCount) override;
+    void              drawReserved(std::size_t vertexCount, sf::PrimitiveType type, const sf::RenderStates& states) override;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Bind the program and vertex array, and forget the cached states
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetStates();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the viewport if the target's view changed it
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyViewport();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bind a texture and set the matching uniforms if it changed
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyTexture(const sf::Texture* texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Apply the states of a draw
+    ///
+    ////////////////////////////////////////////////////////////
+    void applyStates(const sf::RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Point the vertex attributes at a buffer of sf::Vertex if it changed
+    ///
+    ////////////////////////////////////////////////////////////
+    void bindAttributes(gl::GLuint buffer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Uniform locations in m_program
+    ///
+    ////////////////////////////////////////////////////////////
+    struct UniformLocations
+    {
+        gl::GLint transform{-1};    //!< View-projection and model matrix
+        gl::GLint textureScale{-1}; //!< Factor from pixel to normalized texture coordinates
+        gl::GLint texture{-1};      //!< Texture sampler
+        gl::GLint textured{-1};     //!< Is a texture bound?
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    sf::RenderTarget&   m_target;             //!< Render target to draw to
+    gl::GLuint          m_program{};          //!< Built-in shader program
+    gl::GLuint          m_vertexArray{};      //!< Vertex array object describing sf::Vertex
+    StreamingVertexRing m_stream;             //!< Vertices of the current frame
+    gl::GLuint          m_attributeBuffer{};  //!< Buffer the vertex attributes point to
+    std::size_t         m_streamGeneration{}; //!< Generation of m_stream's buffer when m_attributeBuffer was set
+    UniformLocations    m_uniforms;           //!< Uniform locations in m_program
+    bool                m_statesValid{};      //!< Are the cached states below up to date?
+    sf::IntRect         m_viewport;           //!< Last viewport set
+    sf::Transform       m_transform;          //!< Last transform uniform set
+    gl::GLuint          m_texture{};          //!< Last texture bound, 0 for none
+    sf::BlendMode       m_blendMode;          //!< Last blend mode set
+};
+
+} // namespace pong
@@ -0,0 +1,267 @@
+#include "CrtPostProcess.hpp"
+
+#include <algorithm>
+#include <string>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// All the effects in one fragment shader; the enabled ones are
+// selected by the defines prepended to it. Coordinates are in
+// [0, 1] over the scene, as set up by SFML's texture matrix.
+////////////////////////////////////////////////////////////
+constexpr const char* fragmentShaderSource = R"(
+uniform sampler2D scene;
+uniform vec2      sceneSize;
+uniform float     scanlines;
+uniform float     curvature;
+uniform float     vignette;
+uniform float     colorBleed;
+
+void main()
+{
+    vec2 uv = gl_TexCoord[0].xy;
+
+#ifdef CURVATURE
+    vec2 centered = uv * 2.0 - 1.0;
+    centered *= 1.0 + curvature * centered.yx * centered.yx;
+    uv = centered * 0.5 + 0.5;
+
+    if (uv.x < 0.0 || uv.y < 0.0 || uv.x > 1.0 || uv.y > 1.0)
+    {
+        gl_FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+#endif
+
+    vec3 color = texture2D(scene, uv).rgb;
+
+#ifdef COLOR_BLEED
+    vec2 texel = vec2(1.0 / sceneSize.x, 0.0);
+    color.r = mix(color.r, texture2D(scene, uv - texel).r, colorBleed);
+    color.b = mix(color.b, texture2D(scene, uv + texel).b, colorBleed);
+#endif
+
+#ifdef SCANLINES
+    float line = sin(fract(uv.y * sceneSize.y) * 3.14159265);
+    color *= mix(1.0 - scanlines, 1.0, line);
+#endif
+
+#ifdef VIGNETTE
+    vec2 offset = uv - 0.5;
+    color *= clamp(1.0 - dot(offset, offset) * vignette, 0.0, 1.0);
+#endif
+
+    gl_FragColor = vec4(color, 1.0) * gl_Color;
+}
+)";
+
+
+////////////////////////////////////////////////////////////
+// Source of the variant enabling the given effects
+////////////////////////////////////////////////////////////
+std::string makeVariantSource(std::uint32_t effects)
+{
+    using Crt = pong::CrtPostProcess;
+
+    std::string source = "#version 120\n";
+
+    if (effects & Crt::Scanlines)
+        source += "#define SCANLINES\n";
+    if (effects & Crt::Curvature)
+        source += "#define CURVATURE\n";
+    if (effects & Crt::Vignette)
+        source += "#define VIGNETTE\n";
+    if (effects & Crt::ColorBleed)
+        source += "#define COLOR_BLEED\n";
+
+    return source + fragmentShaderSource;
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+CrtPostProcess::CrtPostProcess() : m_budget(sf::milliseconds(1))
+{
+}
+
+
+////////////////////////////////////////////////////////////
+CrtPostProcess::~CrtPostProcess() = default;
+
+
+////////////////////////////////////////////////////////////
+bool CrtPostProcess::create(const sf::Vector2u& sceneSize, std::uint32_t effects)
+{
+    if (!isAvailable())
+    {
+        sf::err() << "Failed to create the CRT post-process: shaders are not supported" << std::endl;
+        return false;
+    }
+
+    if (!m_scene.create(sceneSize))
+    {
+        sf::err() << "Failed to create the CRT post-process scene texture" << std::endl;
+        return false;
+    }
+
+    // Scaling must keep the pixels sharp, the shader does the softening
+    m_scene.setSmooth(false);
+
+    return setEffects(effects);
+}
+
+
+////////////////////////////////////////////////////////////
+bool CrtPostProcess::isAvailable()
+{
+    return sf::Shader::isAvailable();
+}
+
+
+////////////////////////////////////////////////////////////
+sf::RenderTexture& CrtPostProcess::getScene()
+{
+    return m_scene;
+}
+
+
+////////////////////////////////////////////////////////////
+bool CrtPostProcess::setEffects(std::uint32_t effects)
+{
+    effects &= All;
+    if (!getVariant(effects))
+        return false;
+
+    m_effects = effects;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint32_t CrtPostProcess::getEffects() const
+{
+    return m_effects;
+}
+
+
+////////////////////////////////////////////////////////////
+void CrtPostProcess::setParameters(const Parameters& parameters)
+{
+    m_parameters = parameters;
+}
+
+
+////////////////////////////////////////////////////////////
+void CrtPostProcess::setBudget(sf::Time budget)
+{
+    m_budget = budget;
+    m_warned = false;
+}
+
+
+////////////////////////////////////////////////////////////
+void CrtPostProcess::apply(sf::RenderTarget& output)
+{
+    m_scene.display();
+
+    sf::Shader* shader = getVariant(m_effects);
+    if (!shader)
+        return;
+
+    const sf::Vector2f sceneSize(m_scene.getSize());
+    shader->setUniform("scene", sf::Shader::CurrentTexture);
+    shader->setUniform("sceneSize", sceneSize);
+    shader->setUniform("scanlines", m_parameters.scanlines);
+    shader->setUniform("curvature", m_parameters.curvature);
+    shader->setUniform("vignette", m_parameters.vignette);
+    shader->setUniform("colorBleed", m_parameters.colorBleed);
+
+    // Fit the scene in the output, keeping its aspect ratio
+    const sf::Vector2f outputSize(output.getSize());
+    const float        scale = std::min(outputSize.x / sceneSize.x, outputSize.y / sceneSize.y);
+
+    sf::Sprite sprite(m_scene.getTexture());
+    sprite.setScale({scale, scale});
+    sprite.setPosition((outputSize - sceneSize * scale) / 2.f);
+
+    const sf::View view = output.getView();
+    output.setView(sf::View(sf::FloatRect({0.f, 0.f}, outputSize)));
+
+    // The queries belong to the output's context, which draw() activates
+    if (!output.setActive(true))
+        sf::err() << "Failed to activate the CRT post-process output" << std::endl;
+
+    if (!m_timer && GpuTimer::isAvailable())
+    {
+        m_timer = std::make_unique<GpuTimer>();
+        if (!m_timer->create())
+            m_timer.reset();
+    }
+
+    if (m_timer)
+        m_timer->begin();
+
+    output.clear();
+    output.draw(sprite, shader);
+
+    if (m_timer)
+        m_timer->end();
+
+    output.setView(view);
+
+    if (!m_warned && !isWithinBudget())
+    {
+        sf::err() << "CRT post-process takes " << getGpuTime().asSeconds() * 1000.f << " ms of GPU time, over its "
+                  << m_budget.asSeconds() * 1000.f << " ms budget" << std::endl;
+        m_warned = true;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Time CrtPostProcess::getGpuTime() const
+{
+    return m_timer ? m_timer->getAverageTime() : sf::Time::Zero;
+}
+
+
+////////////////////////////////////////////////////////////
+bool CrtPostProcess::isWithinBudget() const
+{
+    // Wait for a few results before judging the moving average
+    constexpr std::size_t minSamples = 8;
+
+    if (!m_timer || (m_timer->getSampleCount() < minSamples))
+        return true;
+
+    return m_timer->getAverageTime() <= m_budget;
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Shader* CrtPostProcess::getVariant(std::uint32_t effects)
+{
+    if (m_variants[effects])
+        return m_variants[effects].get();
+
+    if (m_failed[effects])
+        return nullptr;
+
+    auto shader = std::make_unique<sf::Shader>();
+    if (!shader->loadFromMemory(makeVariantSource(effects), sf::Shader::Type::Fragment))
+    {
+        sf::err() << "Failed to compile the CRT post-process variant " << effects << std::endl;
+        m_failed[effects] = true;
+        return nullptr;
+    }
+
+    m_variants[effects] = std::move(shader);
+    return m_variants[effects].get();
+}
+
+} // namespace pong
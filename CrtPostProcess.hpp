@@ -0,0 +1,182 @@
+#pragma once
+
+#include "GpuTimer.hpp"
+#include "sfml.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Arcade CRT look applied in a single pass
+///
+/// The scene is drawn at its native resolution (256x240 by
+/// default) into getScene(). apply() then draws it to the
+/// output at the output's resolution, scaled to fit, through
+/// one fused fragment shader that performs all the enabled
+/// effects at once: there is no intermediate target and each
+/// output pixel costs one to three texture fetches.
+///
+/// Each effect is a compile-time variant of the shader rather
+/// than a uniform branch, so disabled effects cost nothing.
+/// Variants are compiled on first use and cached.
+///
+/// The fused pass is timed with a GpuTimer; if its average GPU
+/// time exceeds the budget, isWithinBudget() returns false and
+/// a warning is printed once.
+///
+/// sf::Shader requires a compatibility context: this stage
+/// can't be used with the core profile backend.
+///
+////////////////////////////////////////////////////////////
+class CrtPostProcess
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Effects, combined as bit flags
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Effect : std::uint32_t
+    {
+        Scanlines  = 1 << 0, //!< Dark gaps between the scene's lines
+        Curvature  = 1 << 1, //!< Barrel distortion of the tube
+        Vignette   = 1 << 2, //!< Darker corners
+        ColorBleed = 1 << 3, //!< Horizontal smearing of red and blue
+
+        None = 0,                                           //!< Plain scaling
+        All  = Scanlines | Curvature | Vignette | ColorBleed //!< Every effect
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Strength of the effects, set as uniforms
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Parameters
+    {
+        float scanlines{0.35f};  //!< Brightness lost between lines, in [0, 1]
+        float curvature{0.06f};  //!< Amount of barrel distortion
+        float vignette{0.8f};    //!< Darkening factor at the corners
+        float colorBleed{0.4f};  //!< Weight of the neighbouring pixel for red and blue, in [0, 1]
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    CrtPostProcess();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~CrtPostProcess();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the scene texture and compile the initial variant
+    ///
+    /// \param sceneSize Native resolution of the scene
+    /// \param effects   Combination of Effect flags
+    ///
+    /// \return True if successful
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool create(const sf::Vector2u& sceneSize = {256, 240}, std::uint32_t effects = All);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the system supports the post-process stage
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the render texture the scene must be drawn to
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::RenderTexture& getScene();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Select the effects, compiling their variant if needed
+    ///
+    /// \param effects Combination of Effect flags
+    ///
+    /// \return True if the variant is available; the previous one is kept otherwise
+    ///
+    ////////////////////////////////////////////////////////////
+    bool setEffects(std::uint32_t effects);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the selected effects
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint32_t getEffects() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the strength of the effects
+    ///
+    ////////////////////////////////////////////////////////////
+    void setParameters(const Parameters& parameters);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the GPU time the fused pass may take per frame
+    ///
+    /// \param budget Budget; the default is 1 ms
+    ///
+    ////////////////////////////////////////////////////////////
+    void setBudget(sf::Time budget);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the scene texture and draw it to the output with the effects
+    ///
+    /// The output is cleared to black first. The output's view
+    /// is left unchanged.
+    ///
+    /// \param output Render target to draw to, usually the window
+    ///
+    ////////////////////////////////////////////////////////////
+    void apply(sf::RenderTarget& output);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the average GPU time of the fused pass
+    ///
+    /// \return Average time, zero if timer queries are not supported
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Time getGpuTime() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the fused pass fits in its budget
+    ///
+    /// Always true until the first results come in, and when
+    /// timer queries are not supported.
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isWithinBudget() const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the shader of a variant, compiling it if needed
+    ///
+    /// \return The shader, or null if it failed to compile
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Shader* getVariant(std::uint32_t effects);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    static constexpr std::size_t VariantCount{All + 1}; // NOLINT(readability-identifier-naming)
+
+    sf::RenderTexture           m_scene;                  //!< Scene at its native resolution
+    std::unique_ptr<sf::Shader> m_variants[VariantCount]; //!< Compiled variants, indexed by effects
+    bool                        m_failed[VariantCount]{}; //!< Variants that failed to compile
+    std::uint32_t               m_effects{None};          //!< Selected effects
+    Parameters                  m_parameters;             //!< Strength of the effects
+    sf::Time                    m_budget;                 //!< GPU time budget of the fused pass
+    std::unique_ptr<GpuTimer>   m_timer;                  //!< Times the fused pass, created with the output's context
+    bool                        m_warned{};               //!< Has the over-budget warning been printed?
+};
+
+} // namespace pong
@@ -0,0 +1,317 @@
+#include "EventLoop.hpp"
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <string>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Largest number of sources reported by one epoll_wait()
+constexpr int maxEvents = 16;
+
+// X servers listen on TCP port 6000 + display number
+constexpr int x11BasePort = 6000;
+constexpr int x11MaxPort  = 6063;
+
+
+////////////////////////////////////////////////////////////
+std::int64_t monotonicNanoseconds()
+{
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<std::int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+
+////////////////////////////////////////////////////////////
+timespec toTimespec(std::int64_t nanoseconds)
+{
+    timespec result{};
+    result.tv_sec  = static_cast<time_t>(nanoseconds / 1000000000);
+    result.tv_nsec = static_cast<long>(nanoseconds % 1000000000);
+    return result;
+}
+
+
+////////////////////////////////////////////////////////////
+// Is the socket connected to an X server, through its local
+// socket (possibly abstract) or TCP, e.g. with SSH forwarding?
+////////////////////////////////////////////////////////////
+bool isX11Connection(int fd)
+{
+    struct stat status{};
+    if ((fstat(fd, &status) != 0) || !S_ISSOCK(status.st_mode))
+        return false;
+
+    sockaddr_storage address{};
+    socklen_t        length = sizeof(address);
+    if (getpeername(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0)
+        return false;
+
+    if (address.ss_family == AF_UNIX)
+    {
+        // Abstract addresses start with a null character, skip it
+        const auto&       local  = reinterpret_cast<const sockaddr_un&>(address);
+        const std::size_t offset = offsetof(sockaddr_un, sun_path);
+        const std::size_t size   = (length > offset) ? length - offset : 0;
+        const std::string path(local.sun_path, std::min(size, sizeof(local.sun_path)));
+        return path.find(".X11-unix/X") != std::string::npos;
+    }
+
+    int port = 0;
+    if (address.ss_family == AF_INET)
+        port = ntohs(reinterpret_cast<const sockaddr_in&>(address).sin_port);
+    else if (address.ss_family == AF_INET6)
+        port = ntohs(reinterpret_cast<const sockaddr_in6&>(address).sin6_port);
+
+    return (port >= x11BasePort) && (port <= x11MaxPort);
+}
+
+
+////////////////////////////////////////////////////////////
+// The X connection SFML opened with its first window, or -1
+////////////////////////////////////////////////////////////
+int findX11Connection()
+{
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("/proc/self/fd", error))
+    {
+        const int fd = std::atoi(entry.path().filename().c_str());
+        if (isX11Connection(fd))
+            return fd;
+    }
+
+    return -1;
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+EventLoop::~EventLoop()
+{
+    for (const Source& source : m_sources)
+    {
+        if (source.timer)
+            close(source.fd);
+    }
+
+    if (m_epoll >= 0)
+        close(m_epoll);
+}
+
+
+////////////////////////////////////////////////////////////
+bool EventLoop::create()
+{
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll < 0)
+    {
+        sf::err() << "Failed to create the event loop: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool EventLoop::addWindow(Key key)
+{
+    Source source;
+    source.key = key;
+    source.fd  = findX11Connection();
+
+    if (source.fd < 0)
+    {
+        sf::err() << "Failed to find the window's connection to the X server" << std::endl;
+        return false;
+    }
+
+    return add(source);
+}
+
+
+////////////////////////////////////////////////////////////
+bool EventLoop::addSocket(Key key, int socket)
+{
+    Source source;
+    source.key = key;
+    source.fd  = socket;
+    return add(source);
+}
+
+
+////////////////////////////////////////////////////////////
+bool EventLoop::addTimer(Key key, sf::Time period)
+{
+    Source source;
+    source.key    = key;
+    source.fd     = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    source.timer  = true;
+    source.period = std::max<std::int64_t>(period.asMicroseconds() * 1000, 1);
+
+    if (source.fd < 0)
+    {
+        sf::err() << "Failed to create a timer: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (!arm(source) || !add(source))
+    {
+        close(source.fd);
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void EventLoop::resetTimer(Key key)
+{
+    Source* source = find(key);
+    if (source && source->timer)
+        static_cast<void>(arm(*source));
+}
+
+
+////////////////////////////////////////////////////////////
+void EventLoop::remove(Key key)
+{
+    const auto source = std::find_if(m_sources.begin(), m_sources.end(), [key](const Source& s) { return s.key == key; });
+    if (source == m_sources.end())
+        return;
+
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, source->fd, nullptr);
+    if (source->timer)
+        close(source->fd);
+
+    m_sources.erase(source);
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<EventLoop::Ready>& EventLoop::wait(sf::Time timeout)
+{
+    m_ready.clear();
+
+    // epoll counts in milliseconds: round up, so as not to return early
+    const std::int64_t microseconds = timeout.asMicroseconds();
+    const int          milliseconds = (microseconds < 0) ? -1 : static_cast<int>((microseconds + 999) / 1000);
+
+    epoll_event events[maxEvents];
+    const int   count = epoll_wait(m_epoll, events, maxEvents, milliseconds);
+    if (count <= 0)
+        return m_ready;
+
+    const std::int64_t now = monotonicNanoseconds();
+
+    for (int i = 0; i < count; ++i)
+    {
+        Source* source = find(static_cast<Key>(events[i].data.u64));
+        if (!source)
+            continue;
+
+        Ready ready;
+        ready.key = source->key;
+
+        if (source->timer)
+        {
+            // Spurious if the timer was reset meanwhile
+            std::uint64_t expirations = 0;
+            if ((read(source->fd, &expirations, sizeof(expirations)) != sizeof(expirations)) || (expirations == 0))
+                continue;
+
+            source->deadline += static_cast<std::int64_t>(expirations) * source->period;
+            ready.expirations = expirations;
+
+            const sf::Time jitter = sf::microseconds(std::max<std::int64_t>(now - source->deadline, 0) / 1000);
+            m_statistics.expirations += static_cast<std::size_t>(expirations);
+            m_statistics.missed += static_cast<std::size_t>(expirations - 1);
+            m_statistics.maxJitter = std::max(m_statistics.maxJitter, jitter);
+            m_statistics.totalJitter += jitter;
+        }
+
+        m_ready.push_back(ready);
+    }
+
+    if (!m_ready.empty())
+        ++m_statistics.wakeups;
+
+    return m_ready;
+}
+
+
+////////////////////////////////////////////////////////////
+const EventLoop::Statistics& EventLoop::getStatistics() const
+{
+    return m_statistics;
+}
+
+
+////////////////////////////////////////////////////////////
+bool EventLoop::add(const Source& source)
+{
+    epoll_event event{};
+    event.events   = EPOLLIN;
+    event.data.u64 = source.key;
+
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, source.fd, &event) != 0)
+    {
+        sf::err() << "Failed to add a source to the event loop: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    m_sources.push_back(source);
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool EventLoop::arm(Source& source)
+{
+    // Absolute deadlines: a late wake-up doesn't delay the next ones
+    const std::int64_t now = monotonicNanoseconds();
+
+    itimerspec specification{};
+    specification.it_interval = toTimespec(source.period);
+    specification.it_value    = toTimespec(now + source.period);
+
+    if (timerfd_settime(source.fd, TFD_TIMER_ABSTIME, &specification, nullptr) != 0)
+    {
+        sf::err() << "Failed to start a timer: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    source.deadline = now;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+EventLoop::Source* EventLoop::find(Key key)
+{
+    const auto source = std::find_if(m_sources.begin(), m_sources.end(), [key](const Source& s) { return s.key == key; });
+    return (source != m_sources.end()) ? &*source : nullptr;
+}
+
+} // namespace pong
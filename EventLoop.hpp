@@ -0,0 +1,233 @@
+#pragma once
+
+#include "sfml.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Waits on the window, timers and sockets at once
+///
+/// A thin layer over Linux's epoll: each source is registered
+/// with a key chosen by the caller, and wait() blocks until at
+/// least one of them is ready, then returns the keys of the
+/// ready ones. Nothing spins, and the thread sleeps in the
+/// kernel until something happens.
+///
+/// Timers are timerfds with absolute, periodic deadlines, so
+/// they don't drift. wait() reads them: a ready timer comes
+/// with the number of its periods that elapsed, and the delay
+/// between its last deadline and the wake-up is accumulated in
+/// the statistics.
+///
+/// SFML doesn't expose the connection its windows get their
+/// events from, so addWindow() looks for the process's socket
+/// connected to the X server. Xlib can read events into its own
+/// queue while the window is drawn to, leaving the socket
+/// empty: poll the window until it has no more events after
+/// every wait, not only when it is ready. Events queued that
+/// way are then handled by the next wait at the latest, which
+/// a periodic timer bounds.
+///
+/// Usage example:
+/// \code
+/// enum Key { Window, Tick, Network };
+///
+/// pong::EventLoop loop;
+/// if (!loop.create() || !loop.addWindow(Window) || !loop.addTimer(Tick, sf::seconds(1.f / 60.f)))
+///     return;
+/// loop.addSocket(Network, udpSocket);
+///
+/// for (const pong::EventLoop::Ready& ready : loop.wait())
+/// {
+///     if (ready.key == Tick)
+///         // step ready.expirations ticks...
+///     else if (ready.key == Network)
+///         // recvfrom() until EAGAIN...
+/// }
+/// // poll the window's events...
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class EventLoop
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Caller-chosen identifier of a source
+    ///
+    ////////////////////////////////////////////////////////////
+    using Key = std::uint32_t;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief A source found ready by wait()
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Ready
+    {
+        Key           key{};         //!< Key the source was registered with
+        std::uint64_t expirations{}; //!< Number of periods elapsed, for timers
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Accuracy of the timers since the loop was created
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Statistics
+    {
+        std::size_t wakeups{};     //!< Number of waits that returned ready sources
+        std::size_t expirations{}; //!< Number of timer periods elapsed
+        std::size_t missed{};      //!< Number of timer periods that elapsed without a wake-up
+        sf::Time    maxJitter;     //!< Largest delay between a timer's deadline and the wake-up
+        sf::Time    totalJitter;   //!< Sum of the delays between timers' deadlines and the wake-ups
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// The epoll instance is created by create().
+    ///
+    ////////////////////////////////////////////////////////////
+    EventLoop() = default;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// Closes the timers and the epoll instance, but not the
+    /// sockets.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~EventLoop();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    EventLoop(const EventLoop&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy assignment
+    ///
+    ////////////////////////////////////////////////////////////
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the epoll instance
+    ///
+    /// \return True if successful
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool create();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait for events of SFML's windows
+    ///
+    /// \param key Key returned by wait() when events arrive
+    ///
+    /// \return True if the connection to the X server was found
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool addWindow(Key key);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait for a socket, or any file descriptor, to be readable
+    ///
+    /// The socket should be non-blocking, so that it can be
+    /// read until empty once ready.
+    ///
+    /// \param key    Key returned by wait() when data arrives
+    /// \param socket File descriptor to watch, still owned by the caller
+    ///
+    /// \return True if successful
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool addSocket(Key key, int socket);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a periodic timer, the first deadline one period from now
+    ///
+    /// \param key    Key returned by wait() when periods elapse
+    /// \param period Time between two deadlines
+    ///
+    /// \return True if successful
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool addTimer(Key key, sf::Time period);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Restart a timer, the next deadline one period from now
+    ///
+    /// Elapsed periods that weren't waited for are dropped.
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetTimer(Key key);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop waiting for a source
+    ///
+    ////////////////////////////////////////////////////////////
+    void remove(Key key);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait until sources are ready
+    ///
+    /// \param timeout Longest wait, negative to wait as long as needed
+    ///
+    /// \return Ready sources, empty on timeout; valid until the next call
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<Ready>& wait(sf::Time timeout = sf::microseconds(-1));
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the statistics accumulated since creation
+    ///
+    ////////////////////////////////////////////////////////////
+    const Statistics& getStatistics() const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief A registered file descriptor
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Source
+    {
+        Key          key{};      //!< Key given at registration
+        int          fd{-1};     //!< Watched file descriptor
+        bool         timer{};    //!< Is the file descriptor a timer owned by the loop?
+        std::int64_t period{};   //!< Time between two deadlines of a timer, in nanoseconds
+        std::int64_t deadline{}; //!< Last deadline of a timer that was waited for, in CLOCK_MONOTONIC nanoseconds
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Register a file descriptor with epoll
+    ///
+    ////////////////////////////////////////////////////////////
+    bool add(const Source& source);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Arm a timer for one period from now
+    ///
+    ////////////////////////////////////////////////////////////
+    bool arm(Source& source);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find a source by key
+    ///
+    /// \return Pointer to the source, null if the key isn't registered
+    ///
+    ////////////////////////////////////////////////////////////
+    Source* find(Key key);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    int                 m_epoll{-1};  //!< epoll instance
+    std::vector<Source> m_sources;    //!< Registered sources
+    std::vector<Ready>  m_ready;      //!< Sources found ready by the last wait
+    Statistics          m_statistics; //!< Accumulated statistics
+};
+
+} // namespace pong
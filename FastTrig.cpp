@@ -0,0 +1,293 @@
+#include "FastTrig.hpp"
+
+#include <cmath>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define PONG_TRIG_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// 2/pi, and pi/2 split in three parts (Cody and Waite): the
+// first two have few enough significant bits that their
+// products with the quadrant number are exact
+constexpr float twoOverPi  = 0.63661977236758134f;
+constexpr float halfPiHigh = 1.5703125f;
+constexpr float halfPiMid  = 4.837512969970703125e-4f;
+constexpr float halfPiLow  = 7.54978995489188216e-8f;
+
+
+////////////////////////////////////////////////////////////
+// Coefficients of P and Q, with sin(r) = r + r * z * P(z) and
+// cos(r) = 1 + z * Q(z), where z = r * r and |r| <= pi/4.
+// Low and Medium are Taylor series; High is a minimax fit,
+// from the Cephes library.
+////////////////////////////////////////////////////////////
+template <pong::trig::Accuracy>
+struct Coefficients;
+
+template <>
+struct Coefficients<pong::trig::Accuracy::Low>
+{
+    static constexpr float sine[]   = {-1.f / 6.f};
+    static constexpr float cosine[] = {-0.5f, 1.f / 24.f};
+};
+
+template <>
+struct Coefficients<pong::trig::Accuracy::Medium>
+{
+    static constexpr float sine[]   = {-1.f / 6.f, 1.f / 120.f};
+    static constexpr float cosine[] = {-0.5f, 1.f / 24.f, -1.f / 720.f};
+};
+
+template <>
+struct Coefficients<pong::trig::Accuracy::High>
+{
+    static constexpr float sine[]   = {-1.6666654611e-1f, 8.3321608736e-3f, -1.9515295891e-4f};
+    static constexpr float cosine[] = {-0.5f, 4.166664568298827e-2f, -1.388731625493765e-3f, 2.443315711809948e-5f};
+};
+
+
+////////////////////////////////////////////////////////////
+// Arithmetic on floats and SSE registers alike, so that the
+// polynomials are written once
+////////////////////////////////////////////////////////////
+template <typename T>
+T splat(float value);
+
+template <>
+float splat<float>(float value)
+{
+    return value;
+}
+
+float add(float a, float b)
+{
+    return a + b;
+}
+
+float mul(float a, float b)
+{
+    return a * b;
+}
+
+#ifdef PONG_TRIG_SSE2
+template <>
+__m128 splat<__m128>(float value)
+{
+    return _mm_set1_ps(value);
+}
+
+__m128 add(__m128 a, __m128 b)
+{
+    return _mm_add_ps(a, b);
+}
+
+__m128 mul(__m128 a, __m128 b)
+{
+    return _mm_mul_ps(a, b);
+}
+#endif
+
+
+////////////////////////////////////////////////////////////
+template <typename T, std::size_t N>
+T horner(T z, const float (&coefficients)[N])
+{
+    T result = splat<T>(coefficients[N - 1]);
+    for (std::size_t i = N - 1; i > 0; --i)
+        result = add(mul(result, z), splat<T>(coefficients[i - 1]));
+
+    return result;
+}
+
+
+////////////////////////////////////////////////////////////
+// Sine and cosine of a reduced angle
+////////////////////////////////////////////////////////////
+template <pong::trig::Accuracy A, typename T>
+void evaluate(T r, T& sine, T& cosine)
+{
+    const T z = mul(r, r);
+    sine      = add(r, mul(mul(r, z), horner(z, Coefficients<A>::sine)));
+    cosine    = add(splat<T>(1.f), mul(z, horner(z, Coefficients<A>::cosine)));
+}
+
+
+////////////////////////////////////////////////////////////
+template <pong::trig::Accuracy A>
+void approximate(float radians, float& sine, float& cosine)
+{
+    // radians = r + quadrant * pi/2, with |r| <= pi/4
+    const float quadrant = std::nearbyint(radians * twoOverPi);
+    const float r        = ((radians - quadrant * halfPiHigh) - quadrant * halfPiMid) - quadrant * halfPiLow;
+
+    float s = 0.f;
+    float c = 0.f;
+    evaluate<A>(r, s, c);
+
+    const int q = static_cast<int>(quadrant);
+    if (q & 1)
+        std::swap(s, c);
+
+    sine   = (q & 2) ? -s : s;
+    cosine = ((q + 1) & 2) ? -c : c;
+}
+
+
+////////////////////////////////////////////////////////////
+// Angle of an element of a batch, in radians
+////////////////////////////////////////////////////////////
+float toRadians(float radians)
+{
+    return radians;
+}
+
+float toRadians(const sf::Angle& angle)
+{
+    return angle.asRadians();
+}
+
+
+////////////////////////////////////////////////////////////
+template <pong::trig::Accuracy A, typename Value>
+void approximate(const Value* angles, float* sines, float* cosines, std::size_t count)
+{
+    std::size_t i = 0;
+
+#ifdef PONG_TRIG_SSE2
+    // Same steps as the scalar version, with the quadrant's swap
+    // and signs applied as masks
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i two = _mm_set1_epi32(2);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 radians = _mm_setr_ps(toRadians(angles[i]),
+                                           toRadians(angles[i + 1]),
+                                           toRadians(angles[i + 2]),
+                                           toRadians(angles[i + 3]));
+
+        const __m128i q        = _mm_cvtps_epi32(_mm_mul_ps(radians, _mm_set1_ps(twoOverPi)));
+        const __m128  quadrant = _mm_cvtepi32_ps(q);
+
+        __m128 r = _mm_sub_ps(radians, _mm_mul_ps(quadrant, _mm_set1_ps(halfPiHigh)));
+        r        = _mm_sub_ps(r, _mm_mul_ps(quadrant, _mm_set1_ps(halfPiMid)));
+        r        = _mm_sub_ps(r, _mm_mul_ps(quadrant, _mm_set1_ps(halfPiLow)));
+
+        __m128 s;
+        __m128 c;
+        evaluate<A>(r, s, c);
+
+        const __m128 swap   = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, one), one));
+        const __m128 sine   = _mm_or_ps(_mm_and_ps(swap, c), _mm_andnot_ps(swap, s));
+        const __m128 cosine = _mm_or_ps(_mm_and_ps(swap, s), _mm_andnot_ps(swap, c));
+
+        const __m128i sineSign   = _mm_slli_epi32(_mm_and_si128(q, two), 30);
+        const __m128i cosineSign = _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(q, one), two), 30);
+        _mm_storeu_ps(sines + i, _mm_xor_ps(sine, _mm_castsi128_ps(sineSign)));
+        _mm_storeu_ps(cosines + i, _mm_xor_ps(cosine, _mm_castsi128_ps(cosineSign)));
+    }
+#endif
+
+    for (; i < count; ++i)
+        approximate<A>(toRadians(angles[i]), sines[i], cosines[i]);
+}
+
+} // namespace
+
+
+namespace pong::trig
+{
+////////////////////////////////////////////////////////////
+float sin(float radians, Accuracy accuracy)
+{
+    float sine   = 0.f;
+    float cosine = 0.f;
+    sincos(radians, sine, cosine, accuracy);
+    return sine;
+}
+
+
+////////////////////////////////////////////////////////////
+float cos(float radians, Accuracy accuracy)
+{
+    float sine   = 0.f;
+    float cosine = 0.f;
+    sincos(radians, sine, cosine, accuracy);
+    return cosine;
+}
+
+
+////////////////////////////////////////////////////////////
+void sincos(float radians, float& sine, float& cosine, Accuracy accuracy)
+{
+    switch (accuracy)
+    {
+        case Accuracy::Low:
+            return approximate<Accuracy::Low>(radians, sine, cosine);
+        case Accuracy::Medium:
+            return approximate<Accuracy::Medium>(radians, sine, cosine);
+        case Accuracy::High:
+            return approximate<Accuracy::High>(radians, sine, cosine);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void sincos(const float* radians, float* sines, float* cosines, std::size_t count, Accuracy accuracy)
+{
+    switch (accuracy)
+    {
+        case Accuracy::Low:
+            return approximate<Accuracy::Low>(radians, sines, cosines, count);
+        case Accuracy::Medium:
+            return approximate<Accuracy::Medium>(radians, sines, cosines, count);
+        case Accuracy::High:
+            return approximate<Accuracy::High>(radians, sines, cosines, count);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void sincos(const sf::Angle* angles, float* sines, float* cosines, std::size_t count, Accuracy accuracy)
+{
+    switch (accuracy)
+    {
+        case Accuracy::Low:
+            return approximate<Accuracy::Low>(angles, sines, cosines, count);
+        case Accuracy::Medium:
+            return approximate<Accuracy::Medium>(angles, sines, cosines, count);
+        case Accuracy::High:
+            return approximate<Accuracy::High>(angles, sines, cosines, count);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Transform getTransform(const sf::Transformable& object, Accuracy accuracy)
+{
+    // Same computation as sf::Transformable::getTransform()
+    float sine   = 0.f;
+    float cosine = 0.f;
+    sincos(-object.getRotation().asRadians(), sine, cosine, accuracy);
+
+    const sf::Vector2f& position = object.getPosition();
+    const sf::Vector2f& scale    = object.getScale();
+    const sf::Vector2f& origin   = object.getOrigin();
+
+    const float sxc = scale.x * cosine;
+    const float syc = scale.y * cosine;
+    const float sxs = scale.x * sine;
+    const float sys = scale.y * sine;
+    const float tx  = -origin.x * sxc - origin.y * sys + position.x;
+    const float ty  = origin.x * sxs - origin.y * syc + position.y;
+
+    return sf::Transform(sxc, sys, tx, -sxs, syc, ty, 0.f, 0.f, 1.f);
+}
+
+} // namespace pong::trig
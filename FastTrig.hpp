@@ -0,0 +1,120 @@
+#pragma once
+
+#include "sfml.h"
+
+#include <cstddef>
+
+
+namespace pong::trig
+{
+////////////////////////////////////////////////////////////
+// Polynomial sine and cosine
+//
+// Angles are reduced to [-pi/4, pi/4] around the nearest
+// multiple of pi/2, then both functions are evaluated with a
+// polynomial whose degree depends on the requested accuracy.
+// The reduction is exact enough for |angle| <= 8192 radians;
+// the error bounds below hold over that range.
+//
+// Objects opt in one by one: draw a rotating object with
+// getTransform(object, accuracy) in its render states instead
+// of object.getTransform(), or compute many angles at once
+// with the batch sincos(). Low is plenty for particles and
+// small sprites, whose errors stay well under a pixel.
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+/// \brief Degree of the polynomials, from fastest to most accurate
+///
+////////////////////////////////////////////////////////////
+enum class Accuracy
+{
+    Low,    //!< Degrees 3 and 4
+    Medium, //!< Degrees 5 and 6
+    High    //!< Degrees 7 and 8, within about an ulp of the exact values
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Largest absolute error of sin() and cos() at an accuracy
+///
+/// These bounds are checked against std::sin and std::cos
+/// by the fast-trig benchmark.
+///
+////////////////////////////////////////////////////////////
+constexpr float getMaxError(Accuracy accuracy)
+{
+    switch (accuracy)
+    {
+        case Accuracy::Low:
+            return 2.5e-3f;
+        case Accuracy::Medium:
+            return 4e-5f;
+        case Accuracy::High:
+            break;
+    }
+
+    return 1.5e-7f;
+}
+
+////////////////////////////////////////////////////////////
+/// \brief Approximate the sine of an angle
+///
+////////////////////////////////////////////////////////////
+float sin(float radians, Accuracy accuracy = Accuracy::High);
+
+////////////////////////////////////////////////////////////
+/// \brief Approximate the cosine of an angle
+///
+////////////////////////////////////////////////////////////
+float cos(float radians, Accuracy accuracy = Accuracy::High);
+
+////////////////////////////////////////////////////////////
+/// \brief Approximate the sine and cosine of an angle at once
+///
+////////////////////////////////////////////////////////////
+void sincos(float radians, float& sine, float& cosine, Accuracy accuracy = Accuracy::High);
+
+////////////////////////////////////////////////////////////
+/// \brief Approximate the sines and cosines of an array of angles in radians
+///
+/// Computed four at a time with SSE2 when available.
+///
+/// \param radians  Angles to compute, in radians
+/// \param sines    Receives the sine of each angle
+/// \param cosines  Receives the cosine of each angle
+/// \param count    Number of angles
+/// \param accuracy Degree of the polynomials
+///
+////////////////////////////////////////////////////////////
+void sincos(const float* radians, float* sines, float* cosines, std::size_t count, Accuracy accuracy = Accuracy::High);
+
+////////////////////////////////////////////////////////////
+/// \brief Approximate the sines and cosines of an array of angles
+///
+/// Angles are read with asRadians(), and computed four at a
+/// time with SSE2 when available.
+///
+/// \param angles   Angles to compute
+/// \param sines    Receives the sine of each angle
+/// \param cosines  Receives the cosine of each angle
+/// \param count    Number of angles
+/// \param accuracy Degree of the polynomials
+///
+////////////////////////////////////////////////////////////
+void sincos(const sf::Angle* angles, float* sines, float* cosines, std::size_t count, Accuracy accuracy = Accuracy::High);
+
+////////////////////////////////////////////////////////////
+/// \brief Compute the transform of an object with polynomial trigonometry
+///
+/// Same matrix as object.getTransform(), except for the error
+/// of the sine and cosine of its rotation. It is recomputed on
+/// every call, which suits objects that rotate every frame.
+///
+/// \param object   Object to compute the transform of
+/// \param accuracy Degree of the polynomials
+///
+////////////////////////////////////////////////////////////
+sf::Transform getTransform(const sf::Transformable& object, Accuracy accuracy);
+
+} // namespace pong::trig
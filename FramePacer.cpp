@@ -0,0 +1,104 @@
+#include "FramePacer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Time left before a deadline that is spun rather than slept
+const sf::Time spinTime = sf::milliseconds(1);
+
+// Largest number of periods caught up with after a stall
+constexpr std::uint64_t maxCatchUp = 4;
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+FramePacer::FramePacer(sf::Time period) :
+m_period(std::max<std::uint64_t>(TscClock::toTicks(period), 1)),
+m_deadline(TscClock::now() + m_period)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void FramePacer::setPeriod(sf::Time period)
+{
+    m_deadline -= m_period;
+    m_period = std::max<std::uint64_t>(TscClock::toTicks(period), 1);
+    m_deadline += m_period;
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Time FramePacer::getPeriod() const
+{
+    return TscClock::toTime(m_period);
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t FramePacer::wait()
+{
+    std::uint64_t now = TscClock::now();
+
+    if (now < m_deadline)
+    {
+        const sf::Time remaining = TscClock::toTime(m_deadline - now);
+        if (remaining > spinTime)
+            std::this_thread::sleep_for(std::chrono::microseconds((remaining - spinTime).asMicroseconds()));
+
+        now = TscClock::now();
+        while (now < m_deadline)
+            now = TscClock::now();
+    }
+
+    const std::uint64_t late    = now - m_deadline;
+    const std::uint64_t periods = 1 + late / m_period;
+    const sf::Time      jitter  = TscClock::toTime(late % m_period);
+
+    ++m_statistics.frames;
+    m_statistics.missed += static_cast<std::size_t>(periods - 1);
+    m_statistics.maxJitter = std::max(m_statistics.maxJitter, jitter);
+    m_statistics.totalJitter += jitter;
+
+    // After a stall, give up on the missed deadlines beyond a few
+    if (periods > maxCatchUp)
+    {
+        m_deadline = now + m_period;
+        return static_cast<std::size_t>(maxCatchUp);
+    }
+
+    m_deadline += periods * m_period;
+    return static_cast<std::size_t>(periods);
+}
+
+
+////////////////////////////////////////////////////////////
+void FramePacer::restart()
+{
+    m_deadline = TscClock::now() + m_period;
+}
+
+
+////////////////////////////////////////////////////////////
+void FramePacer::reset()
+{
+    restart();
+    m_statistics = Statistics();
+}
+
+
+////////////////////////////////////////////////////////////
+const FramePacer::Statistics& FramePacer::getStatistics() const
+{
+    return m_statistics;
+}
+
+} // namespace pong
@@ -0,0 +1,113 @@
+#pragma once
+
+#include "TscClock.hpp"
+#include "sfml.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Waits for fixed-rate frame deadlines
+///
+/// Deadlines are a whole number of periods apart, so the frame
+/// rate doesn't drift however late each wait returns. wait()
+/// sleeps until shortly before the deadline, then spins on a
+/// TscClock to return close to it: sleeping alone overshoots
+/// by the scheduler's granularity, often a millisecond.
+///
+/// When a frame misses deadlines, wait() returns immediately
+/// with the number of periods that went by, for the caller to
+/// simulate as many ticks. After a long stall, the deadlines
+/// are moved to the present rather than caught up with.
+///
+/// Usage example:
+/// \code
+/// pong::FramePacer pacer(sf::seconds(1.f / 60.f));
+/// while (running)
+/// {
+///     for (std::size_t ticks = pacer.wait(); ticks > 0; --ticks)
+///         match.step(left, right);
+///     // draw...
+/// }
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class FramePacer
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Accuracy of the waits since the last reset
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Statistics
+    {
+        std::size_t frames{};    //!< Number of waits
+        std::size_t missed{};    //!< Number of deadlines that went by without a wait
+        sf::Time    maxJitter;   //!< Largest delay between a deadline and the end of its wait
+        sf::Time    totalJitter; //!< Sum of the delays between deadlines and the ends of their waits
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the pacer, the first deadline one period from now
+    ///
+    /// \param period Time between two deadlines
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit FramePacer(sf::Time period = sf::seconds(1.f / 60.f));
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change the time between two deadlines
+    ///
+    /// The next deadline is one new period after the last one.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPeriod(sf::Time period);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the time between two deadlines
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Time getPeriod() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait for the next deadline
+    ///
+    /// \return Number of periods since the previous wait, at least 1
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t wait();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the next deadline one period from now, keeping the statistics
+    ///
+    /// Deadlines missed while the caller wasn't waiting, e.g.
+    /// while it was idle, then aren't counted as missed.
+    ///
+    ////////////////////////////////////////////////////////////
+    void restart();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the next deadline one period from now and clear the statistics
+    ///
+    ////////////////////////////////////////////////////////////
+    void reset();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the statistics accumulated since the last reset
+    ///
+    ////////////////////////////////////////////////////////////
+    const Statistics& getStatistics() const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::uint64_t m_period;     //!< Time between two deadlines, in TscClock ticks
+    std::uint64_t m_deadline;   //!< Next deadline, in TscClock ticks
+    Statistics    m_statistics; //!< Accumulated statistics
+};
+
+} // namespace pong
@@ -0,0 +1,334 @@
+#include "FrameProfiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <ostream>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Entry of the pass stack for passes that aren't timed on the GPU
+constexpr std::size_t notTimed = std::numeric_limits<std::size_t>::max();
+
+// Weight of each new frame in the moving averages
+constexpr float averageWeight = 1.f / 16.f;
+
+
+////////////////////////////////////////////////////////////
+// Convert a GPU timestamp, in nanoseconds, to the CPU timeline
+////////////////////////////////////////////////////////////
+sf::Time toTimeline(pong::gl::GLuint64 timestamp, sf::Time offset)
+{
+    return sf::microseconds(static_cast<std::int64_t>(timestamp / 1000)) + offset;
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+FrameProfiler::~FrameProfiler()
+{
+    if (!m_gpu)
+        return;
+
+    for (Slot& slot : m_slots)
+    {
+        if (!slot.queries.empty())
+            gl::deleteQueries(m_context, static_cast<gl::GLsizei>(slot.queries.size()), slot.queries.data());
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+bool FrameProfiler::create()
+{
+    m_gpu     = isAvailable();
+    m_context = gl::getActiveContextId();
+    return m_gpu;
+}
+
+
+////////////////////////////////////////////////////////////
+bool FrameProfiler::isAvailable()
+{
+    return gl::isTimestampQueryAvailable();
+}
+
+
+////////////////////////////////////////////////////////////
+void FrameProfiler::beginFrame()
+{
+    assert(m_zoneStack.empty() && m_passStack.empty() && "A frame is already being recorded");
+
+    collect();
+
+    m_frame.index = m_frameCount++;
+    m_frame.begin = now();
+    m_frame.end   = sf::Time::Zero;
+    m_frame.zones.clear();
+
+    // Every slot is still in flight: skip the GPU side of this frame rather than stall
+    m_slot = nullptr;
+    if (m_gpu && !m_slots[m_nextSlot].pending)
+    {
+        m_slot              = &m_slots[m_nextSlot];
+        m_slot->usedQueries = 0;
+        m_slot->passes.clear();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void FrameProfiler::endFrame()
+{
+    assert(m_zoneStack.empty() && m_passStack.empty() && "Every zone must be ended before the frame");
+
+    m_frame.end = now();
+
+    if (m_slot && !m_slot->passes.empty())
+    {
+        // Wait for the GPU; the slot's previous frame lends its storage to the next one
+        std::swap(m_slot->frame, m_frame);
+        m_slot->pending = true;
+        m_nextSlot      = (m_nextSlot + 1) % SlotCount;
+    }
+    else
+    {
+        complete(m_frame);
+    }
+
+    m_slot = nullptr;
+}
+
+
+////////////////////////////////////////////////////////////
+void FrameProfiler::beginZone(const char* name)
+{
+    Zone zone;
+    zone.name   = name;
+    zone.domain = Domain::Cpu;
+    zone.depth  = static_cast<unsigned int>(m_zoneStack.size());
+    zone.begin  = now();
+
+    m_zoneStack.push_back(m_frame.zones.size());
+    m_frame.zones.push_back(zone);
+}
+
+
+////////////////////////////////////////////////////////////
+void FrameProfiler::endZone()
+{
+    assert(!m_zoneStack.empty() && "No zone to end");
+
+    m_frame.zones[m_zoneStack.back()].end = now();
+    m_zoneStack.pop_back();
+}
+
+
+////////////////////////////////////////////////////////////
+void FrameProfiler::beginPass(const char* name)
+{
+    beginZone(name);
+
+    if (!m_slot)
+    {
+        m_passStack.push_back(notTimed);
+        return;
+    }
+
+    // Both clocks sampled back to back; GPU timestamps are in nanoseconds
+    if (m_slot->passes.empty())
+    {
+        gl::GLint64 gpuNow = 0;
+        gl::GetInteger64v(gl::TIMESTAMP, &gpuNow);
+        m_slot->gpuOffset = now() - toTimeline(static_cast<gl::GLuint64>(gpuNow), sf::Time::Zero);
+    }
+
+    PendingPass pass;
+    pass.name       = name;
+    pass.depth      = static_cast<unsigned int>(m_passStack.size());
+    pass.beginQuery = issueTimestamp();
+
+    m_passStack.push_back(m_slot->passes.size());
+    m_slot->passes.push_back(pass);
+}
+
+
+////////////////////////////////////////////////////////////
+void FrameProfiler::endPass()
+{
+    assert(!m_passStack.empty() && "No pass to end");
+
+    const std::size_t index = m_passStack.back();
+    m_passStack.pop_back();
+
+    if (index != notTimed)
+        m_slot->passes[index].endQuery = issueTimestamp();
+
+    endZone();
+}
+
+
+////////////////////////////////////////////////////////////
+const FrameProfiler::Frame* FrameProfiler::getLastFrame() const
+{
+    if (m_completed == 0)
+        return nullptr;
+
+    return &m_history[(m_completed - 1) % HistorySize];
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<FrameProfiler::Average>& FrameProfiler::getAverages() const
+{
+    return m_averages;
+}
+
+
+////////////////////////////////////////////////////////////
+void FrameProfiler::writeTrace(std::ostream& stream) const
+{
+    // Complete events ("ph":"X") with microsecond timestamps; thread 1 is the CPU, thread 2 the GPU
+    const auto writeEvent = [&stream](const char* name, int thread, sf::Time begin, sf::Time end)
+    {
+        stream << ",\n{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread
+               << ",\"ts\":" << begin.asMicroseconds() << ",\"dur\":" << (end - begin).asMicroseconds() << '}';
+    };
+
+    stream << "{\"traceEvents\":[\n"
+           << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n"
+           << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+
+    // Oldest first
+    const std::size_t first = m_completed - m_history.size();
+    for (std::size_t i = first; i < m_completed; ++i)
+    {
+        const Frame& frame = m_history[i % HistorySize];
+        writeEvent("frame", 1, frame.begin, frame.end);
+
+        for (const Zone& zone : frame.zones)
+            writeEvent(zone.name, (zone.domain == Domain::Cpu) ? 1 : 2, zone.begin, zone.end);
+    }
+
+    stream << "\n]}\n";
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Time FrameProfiler::now() const
+{
+    return m_clock.getElapsedTime();
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t FrameProfiler::issueTimestamp()
+{
+    Slot& slot = *m_slot;
+
+    // The pool only grows, until it fits the busiest frame
+    if (slot.usedQueries == slot.queries.size())
+    {
+        const std::size_t count = std::max<std::size_t>(slot.queries.size(), 8);
+        slot.queries.resize(slot.queries.size() + count);
+        gl::GenQueries(static_cast<gl::GLsizei>(count), &slot.queries[slot.queries.size() - count]);
+    }
+
+    gl::QueryCounter(slot.queries[slot.usedQueries], gl::TIMESTAMP);
+    return slot.usedQueries++;
+}
+
+
+////////////////////////////////////////////////////////////
+void FrameProfiler::collect()
+{
+    if (!m_gpu)
+        return;
+
+    // Oldest first; a frame can't be ready before the ones submitted earlier
+    for (std::size_t i = 0; i < SlotCount; ++i)
+    {
+        Slot& slot = m_slots[(m_nextSlot + i) % SlotCount];
+        if (!slot.pending)
+            continue;
+
+        // Timestamps are written in submission order: the last one being available means they all are
+        gl::GLint available = 0;
+        gl::GetQueryObjectiv(slot.queries[slot.usedQueries - 1], gl::QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+
+        for (const PendingPass& pass : slot.passes)
+        {
+            gl::GLuint64 begin = 0;
+            gl::GLuint64 end   = 0;
+            gl::GetQueryObjectui64v(slot.queries[pass.beginQuery], gl::QUERY_RESULT, &begin);
+            gl::GetQueryObjectui64v(slot.queries[pass.endQuery], gl::QUERY_RESULT, &end);
+
+            Zone zone;
+            zone.name   = pass.name;
+            zone.domain = Domain::Gpu;
+            zone.depth  = pass.depth;
+            zone.begin  = toTimeline(begin, slot.gpuOffset);
+            zone.end    = toTimeline(end, slot.gpuOffset);
+            slot.frame.zones.push_back(zone);
+        }
+
+        slot.pending = false;
+        complete(slot.frame);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void FrameProfiler::complete(Frame& frame)
+{
+    // Sum each zone over the frame first, so that repeated zones count once per frame
+    for (const Zone& zone : frame.zones)
+    {
+        const auto it = std::find_if(m_averages.begin(),
+                                     m_averages.end(),
+                                     [&zone](const Average& average)
+                                     { return (average.domain == zone.domain) && (std::strcmp(average.name, zone.name) == 0); });
+
+        const auto index = static_cast<std::size_t>(it - m_averages.begin());
+        if (it == m_averages.end())
+        {
+            m_averages.push_back({zone.name, zone.domain, sf::Time::Zero});
+            m_averageStates.emplace_back();
+        }
+
+        AverageState& state = m_averageStates[index];
+        state.frameSeconds  = std::max(state.frameSeconds, 0.f) + (zone.end - zone.begin).asSeconds();
+    }
+
+    for (std::size_t i = 0; i < m_averages.size(); ++i)
+    {
+        AverageState& state = m_averageStates[i];
+        if (state.frameSeconds < 0.f)
+            continue;
+
+        state.seconds = (state.samples == 0) ? state.frameSeconds
+                                             : state.seconds + (state.frameSeconds - state.seconds) * averageWeight;
+        state.frameSeconds = -1.f;
+        ++state.samples;
+
+        m_averages[i].time = sf::seconds(state.seconds);
+    }
+
+    // Copy rather than move, so that the frame keeps its storage for reuse
+    if (m_history.size() < HistorySize)
+        m_history.push_back(frame);
+    else
+        m_history[m_completed % HistorySize] = frame;
+
+    ++m_completed;
+}
+
+} // namespace pong
@@ -0,0 +1,312 @@
+#pragma once
+
+#include "GlFunctions.hpp"
+#include "TscClock.hpp"
+#include "sfml.h"
+
+#include <cstddef>
+#include <iosfwd>
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Per-frame timeline of CPU zones and GPU passes
+///
+/// CPU zones are timed with a TscClock, cheap enough to time
+/// even tiny zones. Render passes are timed on the CPU as well
+/// as on the GPU, with a TIMESTAMP query at each end.
+/// Timestamps can overlap and nest, unlike TIME_ELAPSED
+/// queries, so passes don't interfere with GpuTimer.
+///
+/// Query results are never waited for. A frame's queries go to
+/// one of a few slots that are read back at the start of later
+/// frames, once the GPU has executed them. If every slot is
+/// still in flight, the frame is recorded without GPU passes.
+/// GPU times are converted to the CPU clock with an offset
+/// sampled when the frame's first pass starts, so both kinds
+/// of zones share one timeline.
+///
+/// A frame is complete once its GPU passes are known, which is
+/// usually two or three frames after endFrame(). The last
+/// HistorySize complete frames are kept, together with the
+/// moving average of each zone.
+///
+/// Zone names are not copied: use string literals. Queries are
+/// not shared between contexts: create and use the profiler
+/// with the same context active. It can be destroyed with any
+/// context active, or none; its queries are then deleted the
+/// next time their context is loaded by gl::load().
+///
+/// Usage example:
+/// \code
+/// profiler.beginFrame();
+///
+/// profiler.beginZone("simulate");
+/// // ...
+/// profiler.endZone();
+///
+/// profiler.beginPass("world");
+/// // draw...
+/// profiler.endPass();
+///
+/// profiler.endFrame();
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class FrameProfiler : sf::GlResource
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Clock a zone was measured with
+    ///
+    ////////////////////////////////////////////////////////////
+    enum class Domain
+    {
+        Cpu, //!< Measured on the thread calling the profiler
+        Gpu  //!< Measured with GPU timestamps
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief A measured section of a frame
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Zone
+    {
+        const char*  name{};   //!< Name of the zone
+        Domain       domain{}; //!< Clock the zone was measured with
+        unsigned int depth{};  //!< Nesting depth, 0 for outermost zones
+        sf::Time     begin;    //!< Start time, relative to the profiler's creation
+        sf::Time     end;      //!< End time, relative to the profiler's creation
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief A complete frame
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Frame
+    {
+        std::size_t       index{}; //!< Number of frames begun before this one
+        sf::Time          begin;   //!< Time beginFrame() was called
+        sf::Time          end;     //!< Time endFrame() was called
+        std::vector<Zone> zones;   //!< CPU zones in order of beginning, followed by GPU passes in the same order
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Moving average of a zone's duration
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Average
+    {
+        const char* name{};   //!< Name of the zone
+        Domain      domain{}; //!< Clock the zone was measured with
+        sf::Time    time;     //!< Exponential moving average of the zone's duration, summed over the frame
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Number of complete frames kept for writeTrace()
+    ///
+    ////////////////////////////////////////////////////////////
+    static constexpr std::size_t HistorySize{128}; // NOLINT(readability-identifier-naming)
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// CPU zones can be measured right away; GPU passes need
+    /// create().
+    ///
+    ////////////////////////////////////////////////////////////
+    FrameProfiler() = default;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~FrameProfiler();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    FrameProfiler(const FrameProfiler&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy assignment
+    ///
+    ////////////////////////////////////////////////////////////
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable GPU timing of the passes
+    ///
+    /// \return True if timestamp queries are supported
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool create();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether timestamp queries are supported by the current context
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start a frame
+    ///
+    /// Also collects the GPU results of earlier frames that are
+    /// ready.
+    ///
+    ////////////////////////////////////////////////////////////
+    void beginFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief End the frame
+    ///
+    /// Every zone and pass must have been ended.
+    ///
+    ////////////////////////////////////////////////////////////
+    void endFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start a CPU zone, nested in the current one if any
+    ///
+    /// \param name Name of the zone, must outlive the profiler
+    ///
+    ////////////////////////////////////////////////////////////
+    void beginZone(const char* name);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief End the innermost CPU zone
+    ///
+    ////////////////////////////////////////////////////////////
+    void endZone();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start a render pass, timed on both the CPU and the GPU
+    ///
+    /// \param name Name of the pass, must outlive the profiler
+    ///
+    ////////////////////////////////////////////////////////////
+    void beginPass(const char* name);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief End the innermost render pass
+    ///
+    ////////////////////////////////////////////////////////////
+    void endPass();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the most recently completed frame
+    ///
+    /// \return Pointer to the frame, or null if no frame is complete yet
+    ///
+    ////////////////////////////////////////////////////////////
+    const Frame* getLastFrame() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the moving averages of the zones
+    ///
+    /// Each complete frame has a weight of 1/16. Zones are
+    /// listed in order of first appearance.
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<Average>& getAverages() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Write the kept frames in the Trace Event format
+    ///
+    /// The output can be loaded in chrome://tracing or Perfetto;
+    /// CPU zones and GPU passes appear as two threads.
+    ///
+    /// \param stream Stream to write to
+    ///
+    ////////////////////////////////////////////////////////////
+    void writeTrace(std::ostream& stream) const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief A pass waiting for its timestamps
+    ///
+    ////////////////////////////////////////////////////////////
+    struct PendingPass
+    {
+        const char*  name{};       //!< Name of the pass
+        unsigned int depth{};      //!< Nesting depth among passes
+        std::size_t  beginQuery{}; //!< Index of the query issued by beginPass in the slot
+        std::size_t  endQuery{};   //!< Index of the query issued by endPass in the slot
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Frame waiting for its GPU results
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Slot
+    {
+        std::vector<gl::GLuint>  queries;       //!< Query pool, two per pass
+        std::vector<PendingPass> passes;        //!< Passes of the frame
+        std::size_t              usedQueries{}; //!< Number of queries issued for the frame
+        Frame                    frame;         //!< CPU part of the frame
+        sf::Time                 gpuOffset;     //!< CPU time minus GPU time when the frame's first pass started
+        bool                     pending{};     //!< Is the slot waiting for the GPU?
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Accumulator behind an Average
+    ///
+    ////////////////////////////////////////////////////////////
+    struct AverageState
+    {
+        float       frameSeconds{-1.f}; //!< Duration summed over the frame being completed, negative if absent
+        float       seconds{};          //!< Moving average, in seconds
+        std::size_t samples{};          //!< Number of frames averaged
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the current time on the profiler's timeline
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Time now() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Issue a timestamp query in the current slot
+    ///
+    /// \return Index of the query in the slot
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t issueTimestamp();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read the results of the slots that are ready, oldest first
+    ///
+    ////////////////////////////////////////////////////////////
+    void collect();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a frame to the history and the averages
+    ///
+    ////////////////////////////////////////////////////////////
+    void complete(Frame& frame);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    static constexpr std::size_t SlotCount{4}; // NOLINT(readability-identifier-naming)
+
+    TscClock                  m_clock;            //!< Timeline origin
+    bool                      m_gpu{};            //!< Were timestamp queries enabled by create()?
+    gl::ContextId             m_context;          //!< Context active in create(), which owns the queries
+    Slot                      m_slots[SlotCount]; //!< Frames in flight, used in a ring
+    std::size_t               m_nextSlot{};       //!< Slot used by the next frame
+    Slot*                     m_slot{};           //!< Slot available to the current frame, null if the GPU isn't timed
+    Frame                     m_frame;            //!< Frame being recorded
+    std::vector<std::size_t>  m_zoneStack;        //!< Open CPU zones, as indices in m_frame.zones
+    std::vector<std::size_t>  m_passStack;        //!< Open passes, as indices in m_slot->passes, or npos if not timed
+    std::size_t               m_frameCount{};     //!< Number of frames begun
+    std::vector<Frame>        m_history;          //!< Complete frames, used as a ring
+    std::size_t               m_completed{};      //!< Number of frames completed
+    std::vector<Average>      m_averages;         //!< Moving average of each zone
+    std::vector<AverageState> m_averageStates;    //!< Accumulators of m_averages
+};
+
+} // namespace pong
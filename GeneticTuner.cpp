@@ -0,0 +1,448 @@
+#include "GeneticTuner.hpp"
+
+#include "AimNoise.hpp"
+#include "BinaryIo.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Parameters evolved, and their ranges
+////////////////////////////////////////////////////////////
+struct Gene
+{
+    using Field = float pong::PaddleAi::Parameters::*;
+
+    Field field;
+    float min;
+    float max;
+};
+
+constexpr Gene genes[] = {{&pong::PaddleAi::Parameters::deadZone, 0.f, 16.f},
+                          {&pong::PaddleAi::Parameters::reactionDelay, 0.f, 20.f},
+                          {&pong::PaddleAi::Parameters::aimBias, -16.f, 16.f},
+                          {&pong::PaddleAi::Parameters::speed, 0.5f, 1.f}};
+
+
+////////////////////////////////////////////////////////////
+// File format, all little-endian, after the header:
+//   settings (52 bytes) and generations evaluated (u32)
+//   u32 population size, then for each candidate: f32 per
+//     gene, f32 fitness
+//   u8 batch count, then for each: u32 generation, u32
+//     candidate count, then f32 per gene per candidate
+////////////////////////////////////////////////////////////
+constexpr char         fileMagic[] = "PONGGAT";
+constexpr std::uint8_t fileVersion = 1;
+
+
+////////////////////////////////////////////////////////////
+// SplitMix64, as in Match
+////////////////////////////////////////////////////////////
+std::uint64_t nextRandom(std::uint64_t& state)
+{
+    std::uint64_t value = (state += 0x9E3779B97F4A7C15);
+    value               = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value               = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+
+////////////////////////////////////////////////////////////
+// Uniform in [0, 1)
+////////////////////////////////////////////////////////////
+float nextUniform(std::uint64_t& state)
+{
+    return static_cast<float>(nextRandom(state) >> 40) / 16777216.f;
+}
+
+
+////////////////////////////////////////////////////////////
+// Standard normal, with the Box-Muller transform
+////////////////////////////////////////////////////////////
+float nextGaussian(std::uint64_t& state)
+{
+    const float radius = std::sqrt(-2.f * std::log(1.f - nextUniform(state)));
+    return radius * std::cos(6.2831853f * nextUniform(state));
+}
+
+
+////////////////////////////////////////////////////////////
+// Keep the settings usable: at least two candidates, and a game each
+////////////////////////////////////////////////////////////
+void sanitize(pong::GeneticTuner::Settings& settings)
+{
+    settings.populationSize    = std::max(settings.populationSize, 2u);
+    settings.eliteCount        = std::min(settings.eliteCount, settings.populationSize);
+    settings.gamesPerCandidate = std::max(settings.gamesPerCandidate, 1u);
+}
+
+
+////////////////////////////////////////////////////////////
+void writeParameters(std::ostream& stream, const pong::PaddleAi::Parameters& parameters)
+{
+    for (const Gene& gene : genes)
+        pong::binary::write(stream, parameters.*gene.field);
+}
+
+
+////////////////////////////////////////////////////////////
+void readParameters(std::istream& stream, pong::PaddleAi::Parameters& parameters)
+{
+    for (const Gene& gene : genes)
+        pong::binary::read(stream, parameters.*gene.field);
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+GeneticTuner::GeneticTuner(ThreadPool& pool) : GeneticTuner(pool, Settings())
+{
+}
+
+
+////////////////////////////////////////////////////////////
+GeneticTuner::GeneticTuner(ThreadPool& pool, const Settings& settings) :
+m_pool(pool),
+m_settings(settings),
+m_generation(0)
+{
+    sanitize(m_settings);
+}
+
+
+////////////////////////////////////////////////////////////
+void GeneticTuner::evolve(std::uint32_t generations, const std::function<void(const GeneticTuner&)>& onGeneration)
+{
+    // Two generations are always queued: the one being evaluated and the next one
+    if (m_batches.empty())
+    {
+        breed(m_generation);
+        breed(m_generation + 1);
+    }
+
+    const std::uint32_t target = m_generation + generations;
+    m_pool.run([&](std::size_t /* thread */) { work(target, onGeneration); });
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint32_t GeneticTuner::getGeneration() const
+{
+    return m_generation;
+}
+
+
+////////////////////////////////////////////////////////////
+GeneticTuner::Candidate GeneticTuner::getBest() const
+{
+    return m_population.empty() ? Candidate() : m_population.front();
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<GeneticTuner::Candidate>& GeneticTuner::getPopulation() const
+{
+    return m_population;
+}
+
+
+////////////////////////////////////////////////////////////
+const GeneticTuner::Settings& GeneticTuner::getSettings() const
+{
+    return m_settings;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GeneticTuner::saveToFile(const std::filesystem::path& filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        sf::err() << "Failed to open tuner checkpoint " << filename << " for writing" << std::endl;
+        return false;
+    }
+
+    using binary::write;
+    binary::writeHeader(file, fileMagic, fileVersion);
+
+    write(file, m_settings.populationSize);
+    write(file, m_settings.eliteCount);
+    write(file, m_settings.gamesPerCandidate);
+    write(file, m_settings.mutation);
+    writeParameters(file, m_settings.opponent);
+    write(file, m_settings.aimError);
+    write(file, m_settings.aimTicks);
+    write(file, m_settings.maxTicks);
+    write(file, m_settings.seed);
+    write(file, m_generation);
+
+    write(file, static_cast<std::uint32_t>(m_population.size()));
+    for (const Candidate& candidate : m_population)
+    {
+        writeParameters(file, candidate.parameters);
+        write(file, candidate.fitness);
+    }
+
+    write(file, static_cast<std::uint8_t>(m_batches.size()));
+    for (const Batch& batch : m_batches)
+    {
+        write(file, batch.generation);
+        write(file, static_cast<std::uint32_t>(batch.candidates.size()));
+        for (const PaddleAi::Parameters& parameters : batch.candidates)
+            writeParameters(file, parameters);
+    }
+
+    if (!file.flush())
+    {
+        sf::err() << "Failed to write tuner checkpoint " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GeneticTuner::loadFromFile(const std::filesystem::path& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        sf::err() << "Failed to open tuner checkpoint " << filename << std::endl;
+        return false;
+    }
+
+    using binary::read;
+    if (!binary::readHeader(file, fileMagic, fileVersion))
+    {
+        sf::err() << "Failed to load tuner checkpoint " << filename << ": not a version " << int{fileVersion}
+                  << " tuner checkpoint" << std::endl;
+        return false;
+    }
+
+    Settings      settings;
+    std::uint32_t generation = 0;
+    read(file, settings.populationSize);
+    read(file, settings.eliteCount);
+    read(file, settings.gamesPerCandidate);
+    read(file, settings.mutation);
+    readParameters(file, settings.opponent);
+    read(file, settings.aimError);
+    read(file, settings.aimTicks);
+    read(file, settings.maxTicks);
+    read(file, settings.seed);
+    read(file, generation);
+    sanitize(settings);
+
+    std::uint32_t populationSize = 0;
+    read(file, populationSize);
+    std::vector<Candidate> population(std::min(populationSize, settings.populationSize));
+    for (Candidate& candidate : population)
+    {
+        readParameters(file, candidate.parameters);
+        read(file, candidate.fitness);
+    }
+
+    std::uint8_t batchCount = 0;
+    read(file, batchCount);
+    std::deque<Batch> batches(batchCount);
+    for (Batch& batch : batches)
+    {
+        std::uint32_t candidateCount = 0;
+        read(file, batch.generation);
+        read(file, candidateCount);
+        batch.candidates.resize(std::min(candidateCount, settings.populationSize));
+        for (PaddleAi::Parameters& parameters : batch.candidates)
+            readParameters(file, parameters);
+
+        batch.results.resize(batch.candidates.size() * settings.gamesPerCandidate);
+    }
+
+    // Queued generations must be the two after the last one evaluated
+    bool consistent = (populationSize == population.size()) && (batches.empty() || (batches.size() == 2));
+    for (std::size_t i = 0; i < batches.size(); ++i)
+        consistent &= (batches[i].generation == generation + i) && !batches[i].candidates.empty();
+
+    if (!file || !consistent)
+    {
+        sf::err() << "Failed to load tuner checkpoint " << filename << ": the file is truncated or corrupt"
+                  << std::endl;
+        return false;
+    }
+
+    m_settings   = settings;
+    m_generation = generation;
+    m_population = std::move(population);
+    m_batches    = std::move(batches);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void GeneticTuner::breed(std::uint32_t generation)
+{
+    std::uint64_t random = m_settings.seed ^ ((generation + std::uint64_t{1}) * 0xD1B54A32D192ED03);
+
+    Batch batch;
+    batch.generation = generation;
+    batch.candidates.resize(m_settings.populationSize);
+    batch.results.resize(batch.candidates.size() * m_settings.gamesPerCandidate);
+
+    for (std::size_t i = 0; i < batch.candidates.size(); ++i)
+    {
+        PaddleAi::Parameters& child = batch.candidates[i];
+
+        // The first generations are drawn uniformly
+        if (m_population.empty())
+        {
+            for (const Gene& gene : genes)
+                child.*gene.field = gene.min + (gene.max - gene.min) * nextUniform(random);
+
+            continue;
+        }
+
+        if (i < m_settings.eliteCount)
+        {
+            child = m_population[std::min(i, m_population.size() - 1)].parameters;
+            continue;
+        }
+
+        // Parents win a tournament between two random candidates;
+        // the population is sorted, so the lowest index wins
+        const auto pick = [&]
+        {
+            const auto a = static_cast<std::size_t>(nextRandom(random) % m_population.size());
+            const auto b = static_cast<std::size_t>(nextRandom(random) % m_population.size());
+            return m_population[std::min(a, b)].parameters;
+        };
+        const PaddleAi::Parameters first  = pick();
+        const PaddleAi::Parameters second = pick();
+
+        // Blend crossover, which may extrapolate a little, then mutation
+        for (const Gene& gene : genes)
+        {
+            const float blend    = nextUniform(random) * 1.5f - 0.25f;
+            const float mutation = nextGaussian(random) * m_settings.mutation * (gene.max - gene.min);
+            const float value    = first.*gene.field + blend * (second.*gene.field - first.*gene.field) + mutation;
+            child.*gene.field    = std::clamp(value, gene.min, gene.max);
+        }
+    }
+
+    m_batches.push_back(std::move(batch));
+}
+
+
+////////////////////////////////////////////////////////////
+void GeneticTuner::select(const Batch& batch)
+{
+    const std::uint32_t games = m_settings.gamesPerCandidate;
+
+    std::vector<Candidate> population(batch.candidates.size());
+    for (std::size_t i = 0; i < population.size(); ++i)
+    {
+        int total = 0;
+        for (std::uint32_t game = 0; game < games; ++game)
+            total += batch.results[i * games + game];
+
+        population[i].parameters = batch.candidates[i];
+        population[i].fitness    = static_cast<float>(total) / static_cast<float>(games);
+    }
+
+    std::stable_sort(population.begin(),
+                     population.end(),
+                     [](const Candidate& a, const Candidate& b) { return a.fitness > b.fitness; });
+
+    m_population = std::move(population);
+}
+
+
+////////////////////////////////////////////////////////////
+void GeneticTuner::work(std::uint32_t target, const std::function<void(const GeneticTuner&)>& onGeneration)
+{
+    const PaddleAi      opponent(m_settings.opponent);
+    const std::uint32_t games = m_settings.gamesPerCandidate;
+
+    std::unique_lock lock(m_mutex);
+    for (;;)
+    {
+        // Hand out the first game not started, oldest generation first
+        Batch*      batch = nullptr;
+        std::size_t index = 0;
+        for (Batch& queued : m_batches)
+        {
+            if (queued.generation >= target)
+                break;
+
+            if (queued.started < queued.results.size())
+            {
+                batch = &queued;
+                index = queued.started++;
+                break;
+            }
+        }
+
+        if (!batch)
+        {
+            if (m_generation >= target)
+                return;
+
+            // Wait for the next generation to be bred
+            m_bred.wait(lock);
+            continue;
+        }
+
+        lock.unlock();
+
+        // Every candidate of a generation plays the same games, with
+        // the same random streams, and alternates sides from one to the next
+        const PaddleAi      candidate(batch->candidates[index / games]);
+        const auto          game  = static_cast<std::uint32_t>(index % games);
+        const bool          left  = (game % 2 == 0);
+        const std::uint64_t match = (std::uint64_t{batch->generation} << 32) | game;
+
+        const MatchDefinitions::State state = playNoisyMatch(left ? candidate : opponent,
+                                                             left ? opponent : candidate,
+                                                             m_settings.aimError,
+                                                             m_settings.aimTicks,
+                                                             m_settings.maxTicks,
+                                                             m_settings.seed,
+                                                             match);
+
+        const int difference = static_cast<int>(state.scores[MatchDefinitions::Left]) -
+                               static_cast<int>(state.scores[MatchDefinitions::Right]);
+        batch->results[index] = left ? difference : -difference;
+
+        lock.lock();
+        ++batch->finished;
+
+        // Generations are selected in order, each one breeding the one after next
+        bool bred = false;
+        while (!m_batches.empty() && (m_batches.front().generation < target) &&
+               (m_batches.front().finished == m_batches.front().results.size()))
+        {
+            select(m_batches.front());
+            m_batches.pop_front();
+            ++m_generation;
+            breed(m_generation + 1);
+            bred = true;
+
+            if (onGeneration)
+                onGeneration(*this);
+        }
+
+        if (bred)
+            m_bred.notify_all();
+    }
+}
+
+} // namespace pong
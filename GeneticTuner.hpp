@@ -0,0 +1,201 @@
+#pragma once
+
+#include "PaddleAi.hpp"
+#include "ThreadPool.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Genetic algorithm evolving the parameters of PaddleAi
+///
+/// Each generation is a population of candidate parameters,
+/// bred from the previous one: its best candidates are carried
+/// over as is and evaluated again, the others are crossed over
+/// and mutated with Gaussian noise. A candidate's fitness is
+/// its mean point difference over a batch of games against a
+/// reference opponent, played on a ThreadPool with aim noise;
+/// all the candidates of a generation play the same games
+/// (same seeds) so that they are compared fairly.
+///
+/// Evaluations are pipelined: generation g + 2 is bred as soon
+/// as generation g is evaluated, while generation g + 1 is
+/// being played, so threads don't wait for the slowest games
+/// of a generation. Evolution is deterministic all the same,
+/// whatever the number of threads.
+///
+/// A checkpoint can be saved after every generation, from the
+/// callback of evolve(); a tuner loaded from it evolves exactly
+/// as if it never stopped.
+///
+/// Usage example:
+/// \code
+/// pong::ThreadPool   pool;
+/// pong::GeneticTuner tuner(pool);
+/// tuner.evolve(50, [](const pong::GeneticTuner& tuner)
+/// {
+///     tuner.saveToFile("tuner.bin");
+/// });
+///
+/// const pong::PaddleAi best(tuner.getBest().parameters);
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class GeneticTuner
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Evolution and evaluation settings
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Settings
+    {
+        std::uint32_t        populationSize{32};    //!< Candidates per generation
+        std::uint32_t        eliteCount{4};         //!< Best candidates carried over as is to the next generation
+        std::uint32_t        gamesPerCandidate{16}; //!< Games against the opponent, alternating sides
+        float                mutation{0.1f};        //!< Standard deviation of mutations, relative to each range
+        PaddleAi::Parameters opponent;              //!< Reference opponent of every candidate
+        float                aimError{24.f};        //!< Aim noise of the players, see AimNoise
+        std::uint32_t        aimTicks{30};          //!< Ticks between changes of aim, see AimNoise
+        std::uint32_t        maxTicks{36000};       //!< Ticks after which a game stops, over or not
+        std::uint64_t        seed{};                //!< Seed of the evolution and of the games
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Evaluated parameters
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Candidate
+    {
+        PaddleAi::Parameters parameters; //!< Parameters of the player
+        float                fitness{};  //!< Mean points scored minus points conceded per game
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a tuner with the default settings
+    ///
+    /// \param pool Threads to play the games on
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit GeneticTuner(ThreadPool& pool);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a tuner
+    ///
+    /// \param pool     Threads to play the games on
+    /// \param settings Evolution and evaluation settings
+    ///
+    ////////////////////////////////////////////////////////////
+    GeneticTuner(ThreadPool& pool, const Settings& settings);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Evaluate a number of generations
+    ///
+    /// \param generations  Number of generations to evaluate
+    /// \param onGeneration Called after each generation is evaluated,
+    ///                     on one of the pool's threads, while the
+    ///                     others keep playing; may be empty
+    ///
+    ////////////////////////////////////////////////////////////
+    void evolve(std::uint32_t generations, const std::function<void(const GeneticTuner&)>& onGeneration = {});
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of generations evaluated so far
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint32_t getGeneration() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the best candidate of the last generation evaluated
+    ///
+    /// Before the first generation, the default parameters with
+    /// a fitness of 0.
+    ///
+    ////////////////////////////////////////////////////////////
+    Candidate getBest() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the last generation evaluated, best first
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<Candidate>& getPopulation() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the evolution and evaluation settings
+    ///
+    ////////////////////////////////////////////////////////////
+    const Settings& getSettings() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Save a checkpoint of the evolution
+    ///
+    /// Candidates being evaluated are saved without their
+    /// partial results, and evaluated again when resuming.
+    ///
+    /// \return True if saved
+    ///
+    ////////////////////////////////////////////////////////////
+    bool saveToFile(const std::filesystem::path& filename) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Resume from a checkpoint, settings included
+    ///
+    /// \return True if loaded, false if the tuner is unchanged
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFile(const std::filesystem::path& filename);
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Generation being played
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Batch
+    {
+        std::uint32_t                     generation{}; //!< Index of the generation
+        std::vector<PaddleAi::Parameters> candidates;   //!< Parameters to evaluate
+        std::vector<int>                  results;      //!< Point difference of each game, per candidate
+        std::size_t                       started{};    //!< Games handed out to threads
+        std::size_t                       finished{};   //!< Games played to the end
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Breed a generation from the last one evaluated, and queue it
+    ///
+    ////////////////////////////////////////////////////////////
+    void breed(std::uint32_t generation);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Rank the candidates of an evaluated generation into the population
+    ///
+    ////////////////////////////////////////////////////////////
+    void select(const Batch& batch);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Body of each thread during evolve()
+    ///
+    ////////////////////////////////////////////////////////////
+    void work(std::uint32_t target, const std::function<void(const GeneticTuner&)>& onGeneration);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    ThreadPool&             m_pool;       //!< Threads to play the games on
+    Settings                m_settings;   //!< Evolution and evaluation settings
+    std::uint32_t           m_generation; //!< Number of generations evaluated
+    std::vector<Candidate>  m_population; //!< Last generation evaluated, best first
+    std::deque<Batch>       m_batches;    //!< Generations bred but not evaluated yet, in order
+    std::mutex              m_mutex;      //!< Protects the batches during evolve()
+    std::condition_variable m_bred;       //!< Signals a new batch or the end of evolve()
+};
+
+} // namespace pong
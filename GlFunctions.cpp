@@ -0,0 +1,605 @@
+#include "GlFunctions.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <vector>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Optional features that a context actually has, found when
+// its entry points are resolved: loaders return non-null
+// stubs for entry points it doesn't support
+////////////////////////////////////////////////////////////
+struct Features
+{
+    bool instancing{};
+    bool bufferStorage{};
+    bool timerQuery{};
+    bool timestampQuery{};
+    bool textureRg{};
+};
+
+
+////////////////////////////////////////////////////////////
+// Entry points and features of one context. Contexts that
+// SFML manages are told apart by their ID, the others by the
+// key given to setContext()
+////////////////////////////////////////////////////////////
+struct Table
+{
+    const void*                        context{};   // Key given to setContext(), null for SFML's contexts
+    std::uint64_t                      contextId{}; // SFML's ID of the context, if context is null
+    std::vector<sf::GlFunctionPointer> entryPoints; // Every entry point, in the order load() resolves them
+    bool                               loaded{};    // Were the mandatory entry points found?
+    bool                               core{};      // Were the core profile entry points found?
+    Features                           features;
+    std::vector<pong::gl::GLuint>      orphans;     // Queries deleted while another context was active
+};
+
+
+////////////////////////////////////////////////////////////
+// Context that SFML doesn't manage, made current on this
+// thread with setContext()
+////////////////////////////////////////////////////////////
+struct Binding
+{
+    const void*      context{};
+    pong::gl::Loader loader{};
+};
+
+Binding& currentBinding()
+{
+    thread_local Binding binding;
+    return binding;
+}
+
+
+////////////////////////////////////////////////////////////
+// Tables of the contexts seen so far, and the one whose entry
+// points are in pong::gl
+////////////////////////////////////////////////////////////
+struct Tables
+{
+    std::mutex       mutex;
+    std::list<Table> tables;
+    Table*           current{};
+};
+
+Tables& getTables()
+{
+    static Tables tables;
+    return tables;
+}
+
+const Table& currentTable()
+{
+    // load() has just made it current
+    return *getTables().current;
+}
+
+
+////////////////////////////////////////////////////////////
+// Delete the queries that were deleted while another context
+// was active, once the table's context is active again
+////////////////////////////////////////////////////////////
+void deleteOrphans(Table& table)
+{
+    if (table.orphans.empty() || !table.loaded || !pong::gl::DeleteQueries)
+        return;
+
+    pong::gl::DeleteQueries(static_cast<pong::gl::GLsizei>(table.orphans.size()), table.orphans.data());
+    table.orphans.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+// Resolves entry points with a loader the first time a
+// context is seen, and restores them from its table after
+////////////////////////////////////////////////////////////
+class Resolver
+{
+public:
+    Resolver(Table& table, pong::gl::Loader loader) : m_table(table), m_loader(loader)
+    {
+    }
+
+    template <typename T>
+    bool operator()(T& function, const char* name, const char* fallback = nullptr)
+    {
+        sf::GlFunctionPointer address = nullptr;
+
+        if (m_next < m_table.entryPoints.size())
+        {
+            address = m_table.entryPoints[m_next];
+        }
+        else
+        {
+            address = m_loader(name);
+            if (!address && fallback)
+                address = m_loader(fallback);
+
+            m_table.entryPoints.push_back(address);
+        }
+
+        ++m_next;
+        function = reinterpret_cast<T>(address);
+        return function != nullptr;
+    }
+
+private:
+    Table&           m_table;
+    pong::gl::Loader m_loader;
+    std::size_t      m_next{};
+};
+
+
+////////////////////////////////////////////////////////////
+// Does the active context's version reach major.minor? The
+// version string works on every version, MAJOR_VERSION only
+// from OpenGL 3.0 on.
+////////////////////////////////////////////////////////////
+bool hasVersion(int major, int minor)
+{
+    const auto* version = reinterpret_cast<const char*>(pong::gl::GetString(pong::gl::VERSION));
+
+    int contextMajor = 0;
+    int contextMinor = 0;
+    if (!version || (std::sscanf(version, "%d.%d", &contextMajor, &contextMinor) != 2))
+        return false;
+
+    return (contextMajor > major) || ((contextMajor == major) && (contextMinor >= minor));
+}
+
+
+////////////////////////////////////////////////////////////
+// Does the active context list an extension? Core profiles
+// only list them one by one, compatibility contexts before
+// OpenGL 3.0 only as a single string.
+////////////////////////////////////////////////////////////
+bool hasExtension(const char* name)
+{
+    namespace gl = pong::gl;
+
+    gl::GLint count = 0;
+    if (gl::GetStringi)
+        gl::GetIntegerv(gl::NUM_EXTENSIONS, &count);
+
+    for (gl::GLint i = 0; i < count; ++i)
+    {
+        const auto* extension = gl::GetStringi(gl::EXTENSIONS, static_cast<gl::GLuint>(i));
+        if (extension && (std::strcmp(reinterpret_cast<const char*>(extension), name) == 0))
+            return true;
+    }
+
+    if (count > 0)
+        return false;
+
+    const char* const extensions = reinterpret_cast<const char*>(gl::GetString(gl::EXTENSIONS));
+    const std::size_t length     = std::strlen(name);
+    const char*       found      = extensions;
+
+    while (found && (found = std::strstr(found, name)))
+    {
+        const bool starts = (found == extensions) || (found[-1] == ' ');
+        const bool ends   = (found[length] == ' ') || (found[length] == '\0');
+        if (starts && ends)
+            return true;
+
+        found += length;
+    }
+
+    return false;
+}
+
+} // namespace
+
+
+namespace pong::gl
+{
+////////////////////////////////////////////////////////////
+void (*Viewport)(GLint, GLint, GLsizei, GLsizei)                 = nullptr;
+void (*Enable)(GLenum)                                           = nullptr;
+void (*Disable)(GLenum)                                          = nullptr;
+void (*BlendFuncSeparate)(GLenum, GLenum, GLenum, GLenum)        = nullptr;
+void (*BlendEquationSeparate)(GLenum, GLenum)                    = nullptr;
+void (*ClearColor)(GLfloat, GLfloat, GLfloat, GLfloat)           = nullptr;
+void (*Clear)(GLbitfield)                                        = nullptr;
+void (*DrawArrays)(GLenum, GLint, GLsizei)                       = nullptr;
+void (*ActiveTexture)(GLenum)                                    = nullptr;
+void (*BindTexture)(GLenum, GLuint)                              = nullptr;
+void (*TexImage2D)(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const void*) = nullptr;
+void (*TexSubImage2D)(GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, const void*) = nullptr;
+void (*PixelStorei)(GLenum, GLint)                               = nullptr;
+void (*GetIntegerv)(GLenum, GLint*)                              = nullptr;
+const GLubyte* (*GetString)(GLenum)                              = nullptr;
+const GLubyte* (*GetStringi)(GLenum, GLuint)                     = nullptr;
+void (*ReadPixels)(GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, void*) = nullptr;
+void (*Finish)()                                                 = nullptr;
+void (*GenBuffers)(GLsizei, GLuint*)                             = nullptr;
+void (*DeleteBuffers)(GLsizei, const GLuint*)                    = nullptr;
+void (*BindBuffer)(GLenum, GLuint)                               = nullptr;
+void (*BufferData)(GLenum, GLsizeiptr, const void*, GLenum)      = nullptr;
+void (*BufferSubData)(GLenum, GLintptr, GLsizeiptr, const void*) = nullptr;
+void* (*MapBufferRange)(GLenum, GLintptr, GLsizeiptr, GLbitfield) = nullptr;
+GLboolean (*UnmapBuffer)(GLenum)                                 = nullptr;
+void (*BufferStorage)(GLenum, GLsizeiptr, const void*, GLbitfield) = nullptr;
+void (*GenQueries)(GLsizei, GLuint*)                             = nullptr;
+void (*DeleteQueries)(GLsizei, const GLuint*)                    = nullptr;
+void (*BeginQuery)(GLenum, GLuint)                               = nullptr;
+void (*EndQuery)(GLenum)                                         = nullptr;
+void (*GetQueryObjectiv)(GLuint, GLenum, GLint*)                 = nullptr;
+void (*GetQueryObjectui64v)(GLuint, GLenum, GLuint64*)           = nullptr;
+void (*QueryCounter)(GLuint, GLenum)                             = nullptr;
+void (*GetInteger64v)(GLenum, GLint64*)                          = nullptr;
+GLsync (*FenceSync)(GLenum, GLbitfield)                          = nullptr;
+GLenum (*ClientWaitSync)(GLsync, GLbitfield, GLuint64)           = nullptr;
+void (*DeleteSync)(GLsync)                                       = nullptr;
+GLint (*GetAttribLocation)(GLuint, const char*)                  = nullptr;
+void (*EnableVertexAttribArray)(GLuint)                          = nullptr;
+void (*DisableVertexAttribArray)(GLuint)                         = nullptr;
+void (*VertexAttribPointer)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*) = nullptr;
+void (*VertexAttribDivisor)(GLuint, GLuint)                      = nullptr;
+void (*DrawArraysInstanced)(GLenum, GLint, GLsizei, GLsizei)     = nullptr;
+GLuint (*CreateShader)(GLenum)                                   = nullptr;
+void (*DeleteShader)(GLuint)                                     = nullptr;
+void (*ShaderSource)(GLuint, GLsizei, const char* const*, const GLint*) = nullptr;
+void (*CompileShader)(GLuint)                                    = nullptr;
+void (*GetShaderiv)(GLuint, GLenum, GLint*)                      = nullptr;
+void (*GetShaderInfoLog)(GLuint, GLsizei, GLsizei*, char*)       = nullptr;
+GLuint (*CreateProgram)()                                        = nullptr;
+void (*DeleteProgram)(GLuint)                                    = nullptr;
+void (*AttachShader)(GLuint, GLuint)                             = nullptr;
+void (*LinkProgram)(GLuint)                                      = nullptr;
+void (*GetProgramiv)(GLuint, GLenum, GLint*)                     = nullptr;
+void (*GetProgramInfoLog)(GLuint, GLsizei, GLsizei*, char*)      = nullptr;
+void (*UseProgram)(GLuint)                                       = nullptr;
+GLint (*GetUniformLocation)(GLuint, const char*)                 = nullptr;
+void (*Uniform1i)(GLint, GLint)                                  = nullptr;
+void (*Uniform2f)(GLint, GLfloat, GLfloat)                       = nullptr;
+void (*UniformMatrix4fv)(GLint, GLsizei, GLboolean, const GLfloat*) = nullptr;
+void (*GenFramebuffers)(GLsizei, GLuint*)                        = nullptr;
+void (*DeleteFramebuffers)(GLsizei, const GLuint*)               = nullptr;
+void (*BindFramebuffer)(GLenum, GLuint)                          = nullptr;
+GLenum (*CheckFramebufferStatus)(GLenum)                         = nullptr;
+void (*FramebufferRenderbuffer)(GLenum, GLenum, GLenum, GLuint)  = nullptr;
+void (*GenRenderbuffers)(GLsizei, GLuint*)                       = nullptr;
+void (*DeleteRenderbuffers)(GLsizei, const GLuint*)              = nullptr;
+void (*BindRenderbuffer)(GLenum, GLuint)                         = nullptr;
+void (*RenderbufferStorage)(GLenum, GLenum, GLsizei, GLsizei)    = nullptr;
+void (*GenVertexArrays)(GLsizei, GLuint*)                        = nullptr;
+void (*DeleteVertexArrays)(GLsizei, const GLuint*)               = nullptr;
+void (*BindVertexArray)(GLuint)                                  = nullptr;
+
+
+////////////////////////////////////////////////////////////
+void setContext(const void* context, Loader loader)
+{
+    Binding& binding = currentBinding();
+    binding.context  = context;
+    binding.loader   = context ? loader : nullptr;
+}
+
+
+////////////////////////////////////////////////////////////
+bool operator==(const ContextId& left, const ContextId& right)
+{
+    return (left.context == right.context) && (left.sfmlId == right.sfmlId);
+}
+
+
+////////////////////////////////////////////////////////////
+ContextId getActiveContextId()
+{
+    const Binding& binding = currentBinding();
+    return {binding.context, binding.context ? 0 : sf::Context::getActiveContextId()};
+}
+
+
+////////////////////////////////////////////////////////////
+void deleteQueries(const ContextId& owner, GLsizei count, const GLuint* queries)
+{
+    if (getActiveContextId() == owner)
+    {
+        if (load())
+            DeleteQueries(count, queries);
+        return;
+    }
+
+    // Left to the owner's next load(); if it was forgotten, the
+    // queries were destroyed with it
+    Tables&               tables = getTables();
+    const std::lock_guard lock(tables.mutex);
+
+    for (Table& table : tables.tables)
+    {
+        if ((table.context == owner.context) && (table.contextId == owner.sfmlId))
+            table.orphans.insert(table.orphans.end(), queries, queries + count);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void forgetContext(const void* context)
+{
+    Tables&               tables = getTables();
+    const std::lock_guard lock(tables.mutex);
+
+    if (tables.current && (tables.current->context == context))
+        tables.current = nullptr;
+
+    tables.tables.remove_if([&](const Table& table) { return table.context == context; });
+}
+
+
+////////////////////////////////////////////////////////////
+bool load()
+{
+    const Binding&      binding   = currentBinding();
+    const std::uint64_t contextId = binding.context ? 0 : sf::Context::getActiveContextId();
+
+    Tables&               tables = getTables();
+    const std::lock_guard lock(tables.mutex);
+
+    const auto isActive = [&](const Table& table)
+    { return (table.context == binding.context) && (table.contextId == contextId); };
+
+    if (tables.current && isActive(*tables.current))
+    {
+        deleteOrphans(*tables.current);
+        return tables.current->loaded;
+    }
+
+    const auto found = std::find_if(tables.tables.begin(), tables.tables.end(), isActive);
+    const bool known = found != tables.tables.end();
+    Table&     table = known ? *found : tables.tables.emplace_back();
+    if (!known)
+    {
+        table.context   = binding.context;
+        table.contextId = contextId;
+    }
+
+    // A context seen before gets its entry points back from its table
+    Resolver resolve(table, binding.loader ? binding.loader : &sf::Context::getFunction);
+    bool     ok = true;
+
+    ok &= resolve(Viewport, "glViewport");
+    ok &= resolve(Enable, "glEnable");
+    ok &= resolve(Disable, "glDisable");
+    ok &= resolve(BlendFuncSeparate, "glBlendFuncSeparate", "glBlendFuncSeparateEXT");
+    ok &= resolve(BlendEquationSeparate, "glBlendEquationSeparate", "glBlendEquationSeparateEXT");
+    ok &= resolve(ClearColor, "glClearColor");
+    ok &= resolve(Clear, "glClear");
+    ok &= resolve(DrawArrays, "glDrawArrays");
+    ok &= resolve(ActiveTexture, "glActiveTexture", "glActiveTextureARB");
+    ok &= resolve(BindTexture, "glBindTexture");
+    ok &= resolve(TexImage2D, "glTexImage2D");
+    ok &= resolve(TexSubImage2D, "glTexSubImage2D");
+    ok &= resolve(PixelStorei, "glPixelStorei");
+    ok &= resolve(GetIntegerv, "glGetIntegerv");
+    ok &= resolve(GetString, "glGetString");
+    ok &= resolve(ReadPixels, "glReadPixels");
+    ok &= resolve(Finish, "glFinish");
+    ok &= resolve(GenBuffers, "glGenBuffers", "glGenBuffersARB");
+    ok &= resolve(DeleteBuffers, "glDeleteBuffers", "glDeleteBuffersARB");
+    ok &= resolve(BindBuffer, "glBindBuffer", "glBindBufferARB");
+    ok &= resolve(BufferData, "glBufferData", "glBufferDataARB");
+    ok &= resolve(BufferSubData, "glBufferSubData", "glBufferSubDataARB");
+    ok &= resolve(GetAttribLocation, "glGetAttribLocation", "glGetAttribLocationARB");
+    ok &= resolve(EnableVertexAttribArray, "glEnableVertexAttribArray", "glEnableVertexAttribArrayARB");
+    ok &= resolve(DisableVertexAttribArray, "glDisableVertexAttribArray", "glDisableVertexAttribArrayARB");
+    ok &= resolve(VertexAttribPointer, "glVertexAttribPointer", "glVertexAttribPointerARB");
+
+    // Optional: only needed for instanced drawing
+    resolve(VertexAttribDivisor, "glVertexAttribDivisor", "glVertexAttribDivisorARB");
+    resolve(DrawArraysInstanced, "glDrawArraysInstanced", "glDrawArraysInstancedARB");
+
+    // Optional: only needed for core profile rendering
+    bool core = true;
+    core &= resolve(CreateShader, "glCreateShader");
+    core &= resolve(DeleteShader, "glDeleteShader");
+    core &= resolve(ShaderSource, "glShaderSource");
+    core &= resolve(CompileShader, "glCompileShader");
+    core &= resolve(GetShaderiv, "glGetShaderiv");
+    core &= resolve(GetShaderInfoLog, "glGetShaderInfoLog");
+    core &= resolve(CreateProgram, "glCreateProgram");
+    core &= resolve(DeleteProgram, "glDeleteProgram");
+    core &= resolve(AttachShader, "glAttachShader");
+    core &= resolve(LinkProgram, "glLinkProgram");
+    core &= resolve(GetProgramiv, "glGetProgramiv");
+    core &= resolve(GetProgramInfoLog, "glGetProgramInfoLog");
+    core &= resolve(UseProgram, "glUseProgram");
+    core &= resolve(GetUniformLocation, "glGetUniformLocation");
+    core &= resolve(Uniform1i, "glUniform1i");
+    core &= resolve(Uniform2f, "glUniform2f");
+    core &= resolve(UniformMatrix4fv, "glUniformMatrix4fv");
+    core &= resolve(GenVertexArrays, "glGenVertexArrays");
+    core &= resolve(DeleteVertexArrays, "glDeleteVertexArrays");
+    core &= resolve(BindVertexArray, "glBindVertexArray");
+    core &= resolve(MapBufferRange, "glMapBufferRange");
+    core &= resolve(UnmapBuffer, "glUnmapBuffer");
+
+    // Optional: only needed for GPU timing
+    resolve(GenQueries, "glGenQueries", "glGenQueriesARB");
+    resolve(DeleteQueries, "glDeleteQueries", "glDeleteQueriesARB");
+    resolve(BeginQuery, "glBeginQuery", "glBeginQueryARB");
+    resolve(EndQuery, "glEndQuery", "glEndQueryARB");
+    resolve(GetQueryObjectiv, "glGetQueryObjectiv", "glGetQueryObjectivARB");
+    resolve(GetQueryObjectui64v, "glGetQueryObjectui64v", "glGetQueryObjectui64vEXT");
+    resolve(QueryCounter, "glQueryCounter");
+    resolve(GetInteger64v, "glGetInteger64v");
+
+    // Optional: only needed for offscreen rendering
+    resolve(GenFramebuffers, "glGenFramebuffers");
+    resolve(DeleteFramebuffers, "glDeleteFramebuffers");
+    resolve(BindFramebuffer, "glBindFramebuffer");
+    resolve(CheckFramebufferStatus, "glCheckFramebufferStatus");
+    resolve(FramebufferRenderbuffer, "glFramebufferRenderbuffer");
+    resolve(GenRenderbuffers, "glGenRenderbuffers");
+    resolve(DeleteRenderbuffers, "glDeleteRenderbuffers");
+    resolve(BindRenderbuffer, "glBindRenderbuffer");
+    resolve(RenderbufferStorage, "glRenderbufferStorage");
+
+    // Optional: only needed for persistently mapped buffers
+    resolve(BufferStorage, "glBufferStorage");
+    resolve(FenceSync, "glFenceSync");
+    resolve(ClientWaitSync, "glClientWaitSync");
+    resolve(DeleteSync, "glDeleteSync");
+
+    // Optional: only needed to list the extensions of core profiles
+    resolve(GetStringi, "glGetStringi");
+
+    table.loaded   = ok;
+    table.core     = core;
+    tables.current = &table;
+
+    if (ok && !known)
+    {
+        Features& features      = table.features;
+        features.instancing     = hasVersion(3, 3) ||
+                                  (hasExtension("GL_ARB_instanced_arrays") &&
+                                   (hasVersion(3, 1) || hasExtension("GL_ARB_draw_instanced")));
+        features.bufferStorage  = (hasVersion(4, 4) || hasExtension("GL_ARB_buffer_storage")) &&
+                                  (hasVersion(3, 2) || hasExtension("GL_ARB_sync"));
+        features.timerQuery     = hasVersion(3, 3) || hasExtension("GL_ARB_timer_query") ||
+                                  hasExtension("GL_EXT_timer_query");
+        features.timestampQuery = hasVersion(3, 3) || hasExtension("GL_ARB_timer_query");
+        features.textureRg      = hasVersion(3, 0) || hasExtension("GL_ARB_texture_rg");
+    }
+
+    deleteOrphans(table);
+    return ok;
+}
+
+
+////////////////////////////////////////////////////////////
+bool isInstancingAvailable()
+{
+    return load() && currentTable().features.instancing && VertexAttribDivisor && DrawArraysInstanced;
+}
+
+
+////////////////////////////////////////////////////////////
+bool isCoreProfileAvailable()
+{
+    return load() && currentTable().core;
+}
+
+
+////////////////////////////////////////////////////////////
+bool isBufferStorageAvailable()
+{
+    return isCoreProfileAvailable() && currentTable().features.bufferStorage && BufferStorage && FenceSync &&
+           ClientWaitSync && DeleteSync;
+}
+
+
+////////////////////////////////////////////////////////////
+bool isFramebufferAvailable()
+{
+    return load() && GenFramebuffers && DeleteFramebuffers && BindFramebuffer && CheckFramebufferStatus &&
+           FramebufferRenderbuffer && GenRenderbuffers && DeleteRenderbuffers && BindRenderbuffer && RenderbufferStorage;
+}
+
+
+////////////////////////////////////////////////////////////
+bool isTimerQueryAvailable()
+{
+    return load() && currentTable().features.timerQuery && GenQueries && DeleteQueries && BeginQuery && EndQuery &&
+           GetQueryObjectiv && GetQueryObjectui64v;
+}
+
+
+////////////////////////////////////////////////////////////
+bool isTimestampQueryAvailable()
+{
+    return isTimerQueryAvailable() && currentTable().features.timestampQuery && QueryCounter && GetInteger64v;
+}
+
+
+////////////////////////////////////////////////////////////
+bool isTextureRgAvailable()
+{
+    return load() && currentTable().features.textureRg;
+}
+
+
+////////////////////////////////////////////////////////////
+GLenum primitiveTypeToGl(sf::PrimitiveType type)
+{
+    // clang-format off
+    switch (type)
+    {
+        case sf::PrimitiveType::Points:        return POINTS;
+        case sf::PrimitiveType::Lines:         return LINES;
+        case sf::PrimitiveType::LineStrip:     return LINE_STRIP;
+        case sf::PrimitiveType::Triangles:     return TRIANGLES;
+        case sf::PrimitiveType::TriangleStrip: return TRIANGLE_STRIP;
+        case sf::PrimitiveType::TriangleFan:   return TRIANGLE_FAN;
+    }
+    // clang-format on
+
+    assert(false && "Invalid value for sf::PrimitiveType");
+    return TRIANGLES;
+}
+
+
+////////////////////////////////////////////////////////////
+GLenum factorToGl(sf::BlendMode::Factor factor)
+{
+    // clang-format off
+    switch (factor)
+    {
+        case sf::BlendMode::Zero:             return ZERO;
+        case sf::BlendMode::One:              return ONE;
+        case sf::BlendMode::SrcColor:         return SRC_COLOR;
+        case sf::BlendMode::OneMinusSrcColor: return ONE_MINUS_SRC_COLOR;
+        case sf::BlendMode::DstColor:         return DST_COLOR;
+        case sf::BlendMode::OneMinusDstColor: return ONE_MINUS_DST_COLOR;
+        case sf::BlendMode::SrcAlpha:         return SRC_ALPHA;
+        case sf::BlendMode::OneMinusSrcAlpha: return ONE_MINUS_SRC_ALPHA;
+        case sf::BlendMode::DstAlpha:         return DST_ALPHA;
+        case sf::BlendMode::OneMinusDstAlpha: return ONE_MINUS_DST_ALPHA;
+    }
+    // clang-format on
+
+    assert(false && "Invalid value for sf::BlendMode::Factor");
+    return ZERO;
+}
+
+
+////////////////////////////////////////////////////////////
+GLenum equationToGl(sf::BlendMode::Equation equation)
+{
+    // clang-format off
+    switch (equation)
+    {
+        case sf::BlendMode::Add:             return FUNC_ADD;
+        case sf::BlendMode::Subtract:        return FUNC_SUBTRACT;
+        case sf::BlendMode::ReverseSubtract: return FUNC_REVERSE_SUBTRACT;
+        case sf::BlendMode::Min:             return MIN;
+        case sf::BlendMode::Max:             return MAX;
+    }
+    // clang-format on
+
+    assert(false && "Invalid value for sf::BlendMode::Equation");
+    return FUNC_ADD;
+}
+
+
+////////////////////////////////////////////////////////////
+void applyBlendMode(const sf::BlendMode& mode)
+{
+    Enable(BLEND);
+    BlendFuncSeparate(factorToGl(mode.colorSrcFactor),
+                      factorToGl(mode.colorDstFactor),
+                      factorToGl(mode.alphaSrcFactor),
+                      factorToGl(mode.alphaDstFactor));
+    BlendEquationSeparate(equationToGl(mode.colorEquation), equationToGl(mode.alphaEquation));
+}
+
+} // namespace pong::gl
@@ -0,0 +1,394 @@
+#pragma once
+
+#include "sfml.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace pong::gl
+{
+////////////////////////////////////////////////////////////
+// OpenGL types
+//
+// sfml.h doesn't pull in the system OpenGL headers, so the
+// few types and entry points the renderers need beyond what
+// sf::RenderTarget does are declared here and resolved at
+// runtime through sf::Context::getFunction, or through the
+// loader given to setContext().
+////////////////////////////////////////////////////////////
+using GLenum     = unsigned int;
+using GLbitfield = unsigned int;
+using GLuint     = unsigned int;
+using GLint      = int;
+using GLsizei    = int;
+using GLboolean  = unsigned char;
+using GLubyte    = unsigned char;
+using GLfloat    = float;
+using GLintptr   = std::ptrdiff_t;
+using GLsizeiptr = std::ptrdiff_t;
+using GLuint64   = std::uint64_t;
+using GLint64    = std::int64_t;
+using GLsync     = struct SyncObject*;
+
+////////////////////////////////////////////////////////////
+// OpenGL constants
+////////////////////////////////////////////////////////////
+constexpr GLenum FLOAT          = 0x1406;
+constexpr GLenum UNSIGNED_BYTE  = 0x1401;
+constexpr GLenum UNSIGNED_SHORT = 0x1403;
+
+constexpr GLenum POINTS         = 0x0000;
+constexpr GLenum LINES          = 0x0001;
+constexpr GLenum LINE_STRIP     = 0x0003;
+constexpr GLenum TRIANGLES      = 0x0004;
+constexpr GLenum TRIANGLE_STRIP = 0x0005;
+constexpr GLenum TRIANGLE_FAN   = 0x0006;
+constexpr GLenum BLEND          = 0x0BE2;
+
+constexpr GLbitfield COLOR_BUFFER_BIT = 0x00004000;
+
+constexpr GLenum TEXTURE_2D         = 0x0DE1;
+constexpr GLenum TEXTURE0           = 0x84C0;
+constexpr GLenum TEXTURE_BINDING_2D = 0x8069;
+constexpr GLenum UNPACK_ALIGNMENT   = 0x0CF5;
+
+constexpr GLenum PACK_ALIGNMENT = 0x0D05;
+constexpr GLenum MAJOR_VERSION  = 0x821B;
+constexpr GLenum MINOR_VERSION  = 0x821C;
+constexpr GLenum VERSION        = 0x1F02;
+constexpr GLenum EXTENSIONS     = 0x1F03;
+constexpr GLenum NUM_EXTENSIONS = 0x821D;
+
+constexpr GLenum RED        = 0x1903;
+constexpr GLenum RGBA       = 0x1908;
+constexpr GLenum LUMINANCE  = 0x1909;
+constexpr GLenum LUMINANCE8 = 0x8040;
+constexpr GLenum R8         = 0x8229;
+
+constexpr GLenum FRAGMENT_SHADER = 0x8B30;
+constexpr GLenum VERTEX_SHADER   = 0x8B31;
+constexpr GLenum COMPILE_STATUS  = 0x8B81;
+constexpr GLenum LINK_STATUS     = 0x8B82;
+
+constexpr GLenum ARRAY_BUFFER = 0x8892;
+constexpr GLenum STREAM_DRAW  = 0x88E0;
+constexpr GLenum STATIC_DRAW  = 0x88E4;
+
+constexpr GLbitfield MAP_WRITE_BIT            = 0x0002;
+constexpr GLbitfield MAP_INVALIDATE_RANGE_BIT = 0x0004;
+constexpr GLbitfield MAP_UNSYNCHRONIZED_BIT   = 0x0020;
+constexpr GLbitfield MAP_PERSISTENT_BIT       = 0x0040;
+constexpr GLbitfield MAP_COHERENT_BIT         = 0x0080;
+
+constexpr GLenum FRAMEBUFFER          = 0x8D40;
+constexpr GLenum RENDERBUFFER         = 0x8D41;
+constexpr GLenum COLOR_ATTACHMENT0    = 0x8CE0;
+constexpr GLenum FRAMEBUFFER_COMPLETE = 0x8CD5;
+constexpr GLenum RGBA8                = 0x8058;
+
+constexpr GLenum TIME_ELAPSED           = 0x88BF;
+constexpr GLenum TIMESTAMP              = 0x8E28;
+constexpr GLenum QUERY_RESULT           = 0x8866;
+constexpr GLenum QUERY_RESULT_AVAILABLE = 0x8867;
+
+constexpr GLenum     SYNC_GPU_COMMANDS_COMPLETE = 0x9117;
+constexpr GLbitfield SYNC_FLUSH_COMMANDS_BIT    = 0x0001;
+constexpr GLenum     ALREADY_SIGNALED           = 0x911A;
+constexpr GLenum     TIMEOUT_EXPIRED            = 0x911B;
+constexpr GLenum     CONDITION_SATISFIED        = 0x911C;
+constexpr GLenum     WAIT_FAILED                = 0x911D;
+
+constexpr GLenum ZERO                = 0;
+constexpr GLenum ONE                 = 1;
+constexpr GLenum SRC_COLOR           = 0x0300;
+constexpr GLenum ONE_MINUS_SRC_COLOR = 0x0301;
+constexpr GLenum SRC_ALPHA           = 0x0302;
+constexpr GLenum ONE_MINUS_SRC_ALPHA = 0x0303;
+constexpr GLenum DST_ALPHA           = 0x0304;
+constexpr GLenum ONE_MINUS_DST_ALPHA = 0x0305;
+constexpr GLenum DST_COLOR           = 0x0306;
+constexpr GLenum ONE_MINUS_DST_COLOR = 0x0307;
+
+constexpr GLenum FUNC_ADD              = 0x8006;
+constexpr GLenum MIN                   = 0x8007;
+constexpr GLenum MAX                   = 0x8008;
+constexpr GLenum FUNC_SUBTRACT         = 0x800A;
+constexpr GLenum FUNC_REVERSE_SUBTRACT = 0x800B;
+
+////////////////////////////////////////////////////////////
+// OpenGL entry points
+////////////////////////////////////////////////////////////
+extern void (*Viewport)(GLint x, GLint y, GLsizei width, GLsizei height);
+extern void (*Enable)(GLenum cap);
+extern void (*Disable)(GLenum cap);
+extern void (*BlendFuncSeparate)(GLenum srcRgb, GLenum dstRgb, GLenum srcAlpha, GLenum dstAlpha);
+extern void (*BlendEquationSeparate)(GLenum modeRgb, GLenum modeAlpha);
+extern void (*ClearColor)(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+extern void (*Clear)(GLbitfield mask);
+extern void (*DrawArrays)(GLenum mode, GLint first, GLsizei count);
+
+extern void (*ActiveTexture)(GLenum texture);
+extern void (*BindTexture)(GLenum target, GLuint texture);
+extern void (*TexImage2D)(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels);
+extern void (*TexSubImage2D)(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels);
+extern void (*PixelStorei)(GLenum name, GLint param);
+extern void (*GetIntegerv)(GLenum name, GLint* data);
+extern const GLubyte* (*GetString)(GLenum name);
+extern const GLubyte* (*GetStringi)(GLenum name, GLuint index);
+extern void (*ReadPixels)(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels);
+extern void (*Finish)();
+
+extern GLuint (*CreateShader)(GLenum type);
+extern void (*DeleteShader)(GLuint shader);
+extern void (*ShaderSource)(GLuint shader, GLsizei count, const char* const* string, const GLint* length);
+extern void (*CompileShader)(GLuint shader);
+extern void (*GetShaderiv)(GLuint shader, GLenum name, GLint* params);
+extern void (*GetShaderInfoLog)(GLuint shader, GLsizei bufferSize, GLsizei* length, char* infoLog);
+extern GLuint (*CreateProgram)();
+extern void (*DeleteProgram)(GLuint program);
+extern void (*AttachShader)(GLuint program, GLuint shader);
+extern void (*LinkProgram)(GLuint program);
+extern void (*GetProgramiv)(GLuint program, GLenum name, GLint* params);
+extern void (*GetProgramInfoLog)(GLuint program, GLsizei bufferSize, GLsizei* length, char* infoLog);
+extern void (*UseProgram)(GLuint program);
+extern GLint (*GetUniformLocation)(GLuint program, const char* name);
+extern void (*Uniform1i)(GLint location, GLint v0);
+extern void (*Uniform2f)(GLint location, GLfloat v0, GLfloat v1);
+extern void (*UniformMatrix4fv)(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+
+extern void (*GenBuffers)(GLsizei n, GLuint* buffers);
+extern void (*DeleteBuffers)(GLsizei n, const GLuint* buffers);
+extern void (*BindBuffer)(GLenum target, GLuint buffer);
+extern void (*BufferData)(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+extern void (*BufferSubData)(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+extern void* (*MapBufferRange)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+extern GLboolean (*UnmapBuffer)(GLenum target);
+extern void (*BufferStorage)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+extern void (*GenQueries)(GLsizei n, GLuint* ids);
+extern void (*DeleteQueries)(GLsizei n, const GLuint* ids);
+extern void (*BeginQuery)(GLenum target, GLuint id);
+extern void (*EndQuery)(GLenum target);
+extern void (*GetQueryObjectiv)(GLuint id, GLenum name, GLint* params);
+extern void (*GetQueryObjectui64v)(GLuint id, GLenum name, GLuint64* params);
+extern void (*QueryCounter)(GLuint id, GLenum target);
+extern void (*GetInteger64v)(GLenum name, GLint64* data);
+
+extern GLsync (*FenceSync)(GLenum condition, GLbitfield flags);
+extern GLenum (*ClientWaitSync)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+extern void (*DeleteSync)(GLsync sync);
+
+extern GLint (*GetAttribLocation)(GLuint program, const char* name);
+extern void (*EnableVertexAttribArray)(GLuint index);
+extern void (*DisableVertexAttribArray)(GLuint index);
+extern void (*VertexAttribPointer)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+extern void (*VertexAttribDivisor)(GLuint index, GLuint divisor);
+extern void (*DrawArraysInstanced)(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount);
+
+extern void (*GenFramebuffers)(GLsizei n, GLuint* framebuffers);
+extern void (*DeleteFramebuffers)(GLsizei n, const GLuint* framebuffers);
+extern void (*BindFramebuffer)(GLenum target, GLuint framebuffer);
+extern GLenum (*CheckFramebufferStatus)(GLenum target);
+extern void (*FramebufferRenderbuffer)(GLenum target, GLenum attachment, GLenum renderbufferTarget, GLuint renderbuffer);
+extern void (*GenRenderbuffers)(GLsizei n, GLuint* renderbuffers);
+extern void (*DeleteRenderbuffers)(GLsizei n, const GLuint* renderbuffers);
+extern void (*BindRenderbuffer)(GLenum target, GLuint renderbuffer);
+extern void (*RenderbufferStorage)(GLenum target, GLenum internalFormat, GLsizei width, GLsizei height);
+
+extern void (*GenVertexArrays)(GLsizei n, GLuint* arrays);
+extern void (*DeleteVertexArrays)(GLsizei n, const GLuint* arrays);
+extern void (*BindVertexArray)(GLuint array);
+
+////////////////////////////////////////////////////////////
+/// \brief Function resolving an entry point from its name
+///
+////////////////////////////////////////////////////////////
+using Loader = sf::GlFunctionPointer (*)(const char* name);
+
+////////////////////////////////////////////////////////////
+/// \brief Use a context that SFML doesn't manage on the calling thread
+///
+/// For contexts such as the one of HeadlessRenderTarget: call
+/// it after making the context current, then load(). Call it
+/// with a null context after deactivating it, to go back to
+/// SFML's active context.
+///
+/// \param context Key of the context, e.g. its native handle, or null for SFML's active context
+/// \param loader  Function resolving an entry point of that context
+///
+////////////////////////////////////////////////////////////
+void setContext(const void* context, Loader loader);
+
+////////////////////////////////////////////////////////////
+/// \brief Identity of a context, SFML's or one given to setContext()
+///
+////////////////////////////////////////////////////////////
+struct ContextId
+{
+    const void*   context{}; //!< Key given to setContext(), null for SFML's contexts
+    std::uint64_t sfmlId{};  //!< sf::Context::getActiveContextId() of SFML's contexts
+};
+
+////////////////////////////////////////////////////////////
+/// \brief Tell whether two context identities are the same context
+///
+////////////////////////////////////////////////////////////
+bool operator==(const ContextId& left, const ContextId& right);
+
+////////////////////////////////////////////////////////////
+/// \brief Get the identity of the context active on the calling thread
+///
+/// Objects that contexts don't share, such as queries and
+/// vertex arrays, must be deleted with the context that
+/// created them active; keep its identity to check it.
+///
+////////////////////////////////////////////////////////////
+ContextId getActiveContextId();
+
+////////////////////////////////////////////////////////////
+/// \brief Delete queries with the context that created them
+///
+/// Queries aren't shared between contexts. If \a owner is
+/// active on the calling thread, the queries are deleted
+/// right away; otherwise they are deleted by the next load()
+/// with \a owner active, or vanish with it if it is destroyed
+/// first.
+///
+/// \param owner   Context that was active when the queries were created
+/// \param count   Number of queries
+/// \param queries Names of the queries
+///
+////////////////////////////////////////////////////////////
+void deleteQueries(const ContextId& owner, GLsizei count, const GLuint* queries);
+
+////////////////////////////////////////////////////////////
+/// \brief Discard what load() found for a destroyed context
+///
+/// \param context Key given to setContext()
+///
+////////////////////////////////////////////////////////////
+void forgetContext(const void* context);
+
+////////////////////////////////////////////////////////////
+/// \brief Resolve the entry points declared above for the active context
+///
+/// A context must be active on the calling thread. Entry
+/// points are resolved, and the version and extensions of the
+/// context queried, once per context: SFML's contexts are
+/// told apart by sf::Context::getActiveContextId(), the others
+/// by the key given to setContext(). Call it again after
+/// activating another context, to switch the entry points
+/// above to that context's; they are shared by every thread.
+///
+/// \return True if every mandatory entry point was found
+///
+////////////////////////////////////////////////////////////
+bool load();
+
+////////////////////////////////////////////////////////////
+/// \brief Tell whether instanced drawing is supported
+///
+/// Requires glDrawArraysInstanced and glVertexAttribDivisor,
+/// either from core OpenGL 3.3 or from the ARB extensions, as
+/// reported by the context.
+///
+/// \return True if instanced drawing can be used
+///
+////////////////////////////////////////////////////////////
+bool isInstancingAvailable();
+
+////////////////////////////////////////////////////////////
+/// \brief Tell whether the entry points used by core profile rendering are available
+///
+/// Requires GLSL program objects, vertex array objects and
+/// mapping of buffer ranges (OpenGL 3.0).
+///
+/// \return True if core profile rendering can be used
+///
+////////////////////////////////////////////////////////////
+bool isCoreProfileAvailable();
+
+////////////////////////////////////////////////////////////
+/// \brief Tell whether persistently mapped buffers and fences are supported
+///
+/// Requires OpenGL 4.4 or ARB_buffer_storage, and OpenGL 3.2
+/// or ARB_sync, on top of core profile rendering. The context
+/// is asked, since loaders may return entry points that it
+/// doesn't support.
+///
+/// \return True if buffers can be persistently mapped
+///
+////////////////////////////////////////////////////////////
+bool isBufferStorageAvailable();
+
+////////////////////////////////////////////////////////////
+/// \brief Tell whether framebuffer objects are supported
+///
+/// Requires OpenGL 3.0 or ARB_framebuffer_object.
+///
+/// \return True if framebuffers and renderbuffers can be used
+///
+////////////////////////////////////////////////////////////
+bool isFramebufferAvailable();
+
+////////////////////////////////////////////////////////////
+/// \brief Tell whether GPU timer queries are supported
+///
+/// Requires OpenGL 3.3, ARB_timer_query or EXT_timer_query,
+/// as reported by the context.
+///
+/// \return True if TIME_ELAPSED queries can be used
+///
+////////////////////////////////////////////////////////////
+bool isTimerQueryAvailable();
+
+////////////////////////////////////////////////////////////
+/// \brief Tell whether GPU timestamps are supported
+///
+/// Requires OpenGL 3.3 or ARB_timer_query, as reported by the
+/// context; EXT_timer_query only provides TIME_ELAPSED queries.
+///
+/// \return True if TIMESTAMP queries and glGetInteger64v can be used
+///
+////////////////////////////////////////////////////////////
+bool isTimestampQueryAvailable();
+
+////////////////////////////////////////////////////////////
+/// \brief Tell whether single-channel R8 textures are supported
+///
+/// Requires OpenGL 3.0 or ARB_texture_rg, as reported by the
+/// context.
+///
+/// \return True if textures can be stored as R8 and uploaded as RED
+///
+////////////////////////////////////////////////////////////
+bool isTextureRgAvailable();
+
+////////////////////////////////////////////////////////////
+/// \brief Convert a SFML primitive type to its OpenGL constant
+///
+////////////////////////////////////////////////////////////
+GLenum primitiveTypeToGl(sf::PrimitiveType type);
+
+////////////////////////////////////////////////////////////
+/// \brief Convert a SFML blend factor to its OpenGL constant
+///
+////////////////////////////////////////////////////////////
+GLenum factorToGl(sf::BlendMode::Factor factor);
+
+////////////////////////////////////////////////////////////
+/// \brief Convert a SFML blend equation to its OpenGL constant
+///
+////////////////////////////////////////////////////////////
+GLenum equationToGl(sf::BlendMode::Equation equation);
+
+////////////////////////////////////////////////////////////
+/// \brief Apply a blend mode to the current context
+///
+/// \param mode Blend mode to apply
+///
+////////////////////////////////////////////////////////////
+void applyBlendMode(const sf::BlendMode& mode);
+
+} // namespace pong::gl
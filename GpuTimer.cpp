@@ -0,0 +1,120 @@
+#include "GpuTimer.hpp"
+
+#include <cassert>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+GpuTimer::~GpuTimer()
+{
+    if (!m_queries[0])
+        return;
+
+    gl::deleteQueries(m_context, static_cast<gl::GLsizei>(QueryCount), m_queries);
+}
+
+
+////////////////////////////////////////////////////////////
+bool GpuTimer::create()
+{
+    if (!isAvailable())
+        return false;
+
+    if (!m_queries[0])
+    {
+        gl::GenQueries(static_cast<gl::GLsizei>(QueryCount), m_queries);
+        m_context = gl::getActiveContextId();
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool GpuTimer::isAvailable()
+{
+    return gl::isTimerQueryAvailable();
+}
+
+
+////////////////////////////////////////////////////////////
+void GpuTimer::begin()
+{
+    assert(!m_running && "GpuTimer sections cannot be nested");
+
+    if (!m_queries[0])
+        return;
+
+    collect();
+
+    // Every query is still in flight: skip this section rather than stall
+    if (m_pending[m_next])
+        return;
+
+    gl::BeginQuery(gl::TIME_ELAPSED, m_queries[m_next]);
+    m_running = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void GpuTimer::end()
+{
+    if (!m_running)
+        return;
+
+    gl::EndQuery(gl::TIME_ELAPSED);
+    m_pending[m_next] = true;
+    m_next            = (m_next + 1) % QueryCount;
+    m_running         = false;
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Time GpuTimer::getLastTime() const
+{
+    return m_lastTime;
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Time GpuTimer::getAverageTime() const
+{
+    return sf::seconds(m_averageSeconds);
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t GpuTimer::getSampleCount() const
+{
+    return m_samples;
+}
+
+
+////////////////////////////////////////////////////////////
+void GpuTimer::collect()
+{
+    // Oldest first, so that m_lastTime ends up being the most recent result
+    for (std::size_t i = 0; i < QueryCount; ++i)
+    {
+        const std::size_t index = (m_next + i) % QueryCount;
+        if (!m_pending[index])
+            continue;
+
+        gl::GLint available = 0;
+        gl::GetQueryObjectiv(m_queries[index], gl::QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+
+        gl::GLuint64 nanoseconds = 0;
+        gl::GetQueryObjectui64v(m_queries[index], gl::QUERY_RESULT, &nanoseconds);
+        m_pending[index] = false;
+
+        m_lastTime          = sf::microseconds(static_cast<std::int64_t>(nanoseconds / 1000));
+        const float seconds = m_lastTime.asSeconds();
+        m_averageSeconds    = (m_samples == 0) ? seconds : m_averageSeconds + (seconds - m_averageSeconds) / 16.f;
+        ++m_samples;
+    }
+}
+
+} // namespace pong
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "GlFunctions.hpp"
+#include "sfml.h"
+
+#include <cstddef>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Measures the GPU time of a section of rendering
+///
+/// Uses TIME_ELAPSED queries in a small ring, so that reading
+/// a result never stalls the pipeline: the time measured for a
+/// frame becomes available a few frames later. If all queries
+/// are still in flight when begin() is called, that frame is
+/// simply not measured.
+///
+/// Queries are not shared between contexts: create and use the
+/// timer with the same context active. It can be destroyed with
+/// any context active, or none; its queries are then deleted
+/// the next time their context is loaded by gl::load().
+///
+/// Usage example:
+/// \code
+/// timer.begin();
+/// // draw...
+/// timer.end();
+/// if (timer.getAverageTime() > budget)
+///     // too slow
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class GpuTimer : sf::GlResource
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// The queries are created by create().
+    ///
+    ////////////////////////////////////////////////////////////
+    GpuTimer() = default;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~GpuTimer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    GpuTimer(const GpuTimer&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy assignment
+    ///
+    ////////////////////////////////////////////////////////////
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the queries
+    ///
+    /// \return True if timer queries are supported
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool create();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether timer queries are supported by the current context
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start measuring
+    ///
+    /// Also collects the results of earlier measurements that
+    /// are ready. Sections cannot be nested, neither with each
+    /// other nor with any other TIME_ELAPSED query.
+    ///
+    ////////////////////////////////////////////////////////////
+    void begin();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop measuring
+    ///
+    ////////////////////////////////////////////////////////////
+    void end();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the most recent result
+    ///
+    /// \return GPU time of the most recent section whose result is available
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Time getLastTime() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the exponential moving average of the results
+    ///
+    /// Each new result has a weight of 1/16.
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Time getAverageTime() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of results collected so far
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getSampleCount() const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Read the results of the queries that are ready
+    ///
+    ////////////////////////////////////////////////////////////
+    void collect();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    static constexpr std::size_t QueryCount{4}; // NOLINT(readability-identifier-naming)
+
+    gl::GLuint    m_queries[QueryCount]{}; //!< Query ring
+    bool          m_pending[QueryCount]{}; //!< Is the query waiting for its result?
+    std::size_t   m_next{};                //!< Next query to use
+    bool          m_running{};             //!< Is a section being measured?
+    gl::ContextId m_context;               //!< Context that created the queries
+    sf::Time      m_lastTime;              //!< Most recent result
+    float         m_averageSeconds{};      //!< Moving average of the results
+    std::size_t   m_samples{};             //!< Number of results collected
+};
+
+} // namespace pong
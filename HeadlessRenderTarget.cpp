@@ -0,0 +1,281 @@
+#include "HeadlessRenderTarget.hpp"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Entry points of the headless context come from EGL
+////////////////////////////////////////////////////////////
+sf::GlFunctionPointer getFunction(const char* name)
+{
+    return eglGetProcAddress(name);
+}
+
+
+////////////////////////////////////////////////////////////
+// Tell whether a space-separated extension string has a name
+////////////////////////////////////////////////////////////
+bool hasExtension(const char* extensions, const char* name)
+{
+    const std::size_t length = std::strlen(name);
+    const char*       found  = extensions;
+
+    while (found && (found = std::strstr(found, name)))
+    {
+        const bool starts = (found == extensions) || (found[-1] == ' ');
+        const bool ends   = (found[length] == ' ') || (found[length] == '\0');
+        if (starts && ends)
+            return true;
+
+        found += length;
+    }
+
+    return false;
+}
+
+
+////////////////////////////////////////////////////////////
+// Initialize Mesa's surfaceless platform, which needs neither
+// a display server nor a GPU, or the default display if the
+// implementation doesn't have it. The display is shared by
+// every target and never terminated, since that would destroy
+// the contexts of the other targets.
+////////////////////////////////////////////////////////////
+EGLDisplay initializeDisplay()
+{
+    static const EGLDisplay display = []
+    {
+        const auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+        if (getPlatformDisplay && hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+        {
+            const EGLDisplay surfaceless = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if ((surfaceless != EGL_NO_DISPLAY) && eglInitialize(surfaceless, nullptr, nullptr))
+                return surfaceless;
+        }
+
+        const EGLDisplay fallback = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if ((fallback != EGL_NO_DISPLAY) && eglInitialize(fallback, nullptr, nullptr))
+            return fallback;
+
+        return EGL_NO_DISPLAY;
+    }();
+
+    return display;
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+HeadlessRenderTarget::~HeadlessRenderTarget()
+{
+    destroy();
+}
+
+
+////////////////////////////////////////////////////////////
+bool HeadlessRenderTarget::create(const sf::Vector2u& size)
+{
+    destroy();
+
+    const EGLDisplay display = initializeDisplay();
+    if (display == EGL_NO_DISPLAY)
+    {
+        sf::err() << "Failed to create the headless render target: no EGL display is available" << std::endl;
+        return false;
+    }
+
+    // Without a config or a surface: the framebuffer object is all we draw to
+    const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!hasExtension(extensions, "EGL_KHR_surfaceless_context") || !hasExtension(extensions, "EGL_KHR_no_config_context") ||
+        !hasExtension(extensions, "EGL_KHR_create_context") || !eglBindAPI(EGL_OPENGL_API))
+    {
+        sf::err() << "Failed to create the headless render target: surfaceless desktop OpenGL contexts are not supported"
+                  << std::endl;
+        return false;
+    }
+
+    // clang-format off
+    const EGLint attributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION,       3,
+        EGL_CONTEXT_MINOR_VERSION,       3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    // clang-format on
+
+    const EGLContext context = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+    if (context == EGL_NO_CONTEXT)
+    {
+        sf::err() << "Failed to create the headless render target: OpenGL 3.3 core profile is not supported" << std::endl;
+        return false;
+    }
+
+    m_display = display;
+    m_context = context;
+
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        sf::err() << "Failed to activate the headless render target's context" << std::endl;
+        destroy();
+        return false;
+    }
+
+    gl::setContext(context, getFunction);
+    if (!gl::isCoreProfileAvailable() || !gl::isFramebufferAvailable())
+    {
+        sf::err() << "Failed to create the headless render target: core profile rendering or framebuffer objects are "
+                     "not supported"
+                  << std::endl;
+        destroy();
+        return false;
+    }
+
+    gl::GenRenderbuffers(1, &m_colorBuffer);
+    gl::BindRenderbuffer(gl::RENDERBUFFER, m_colorBuffer);
+    gl::RenderbufferStorage(gl::RENDERBUFFER, gl::RGBA8, static_cast<gl::GLsizei>(size.x), static_cast<gl::GLsizei>(size.y));
+
+    gl::GenFramebuffers(1, &m_framebuffer);
+    gl::BindFramebuffer(gl::FRAMEBUFFER, m_framebuffer);
+    gl::FramebufferRenderbuffer(gl::FRAMEBUFFER, gl::COLOR_ATTACHMENT0, gl::RENDERBUFFER, m_colorBuffer);
+
+    if (gl::CheckFramebufferStatus(gl::FRAMEBUFFER) != gl::FRAMEBUFFER_COMPLETE)
+    {
+        sf::err() << "Failed to create the headless render target: the framebuffer is incomplete" << std::endl;
+        destroy();
+        return false;
+    }
+
+    gl::GLint major = 3;
+    gl::GLint minor = 3;
+    gl::GetIntegerv(gl::MAJOR_VERSION, &major);
+    gl::GetIntegerv(gl::MINOR_VERSION, &minor);
+    m_settings = sf::ContextSettings(0,
+                                     0,
+                                     0,
+                                     static_cast<unsigned int>(major),
+                                     static_cast<unsigned int>(minor),
+                                     sf::ContextSettings::Core);
+
+    m_size = size;
+    initialize();
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+const sf::ContextSettings& HeadlessRenderTarget::getSettings() const
+{
+    return m_settings;
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Vector2u HeadlessRenderTarget::getSize() const
+{
+    return m_size;
+}
+
+
+////////////////////////////////////////////////////////////
+bool HeadlessRenderTarget::setActive(bool active)
+{
+    if (!m_context)
+        return false;
+
+    if (!active)
+    {
+        gl::setContext(nullptr, nullptr);
+        return eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT) == EGL_TRUE;
+    }
+
+    if (!eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context))
+        return false;
+
+    // Switch pong::gl back to this context's entry points
+    gl::setContext(m_context, getFunction);
+    if (!gl::load())
+        return false;
+
+    gl::BindFramebuffer(gl::FRAMEBUFFER, m_framebuffer);
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void HeadlessRenderTarget::display()
+{
+    if (m_context)
+        gl::Finish();
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Image HeadlessRenderTarget::capture() const
+{
+    sf::Image image;
+    if (!m_framebuffer)
+        return image;
+
+    // OpenGL returns the bottom row first
+    std::vector<std::uint8_t> pixels(static_cast<std::size_t>(m_size.x) * m_size.y * 4);
+    gl::BindFramebuffer(gl::FRAMEBUFFER, m_framebuffer);
+    gl::PixelStorei(gl::PACK_ALIGNMENT, 1);
+    gl::ReadPixels(0,
+                   0,
+                   static_cast<gl::GLsizei>(m_size.x),
+                   static_cast<gl::GLsizei>(m_size.y),
+                   gl::RGBA,
+                   gl::UNSIGNED_BYTE,
+                   pixels.data());
+
+    image.create(m_size, pixels.data());
+    image.flipVertically();
+    return image;
+}
+
+
+////////////////////////////////////////////////////////////
+void HeadlessRenderTarget::destroy()
+{
+    if (!m_context)
+        return;
+
+    if (eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context))
+    {
+        gl::setContext(m_context, getFunction);
+        if (gl::load())
+        {
+            if (m_framebuffer)
+                gl::DeleteFramebuffers(1, &m_framebuffer);
+            if (m_colorBuffer)
+                gl::DeleteRenderbuffers(1, &m_colorBuffer);
+        }
+
+        eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+
+    gl::setContext(nullptr, nullptr);
+    gl::forgetContext(m_context);
+    eglDestroyContext(m_display, m_context);
+
+    m_context     = nullptr;
+    m_framebuffer = 0;
+    m_colorBuffer = 0;
+    m_size        = sf::Vector2u();
+}
+
+} // namespace pong
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "GlFunctions.hpp"
+#include "sfml.h"
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Offscreen render target with its own OpenGL context
+///
+/// SFML's contexts all hang off a shared context that needs a
+/// display server, so neither a window nor an
+/// sf::RenderTexture can be created in a container. This
+/// target creates an OpenGL 3.3 core profile context with
+/// surfaceless EGL instead, on Mesa's surfaceless platform
+/// when available, and renders into a framebuffer object:
+/// with Mesa's llvmpipe driver, no GPU is needed either.
+///
+/// The context isn't known to SFML, so only code that goes
+/// through pong::gl can draw to the target: use it with a
+/// CoreRenderBackend (see createRenderBackend and
+/// getSettings), and don't call sf::RenderTarget's own clear()
+/// and draw() functions. For the same reason, sf::Texture,
+/// sf::Shader and sf::VertexBuffer can't be used with it.
+///
+/// The OpenGL entry points of the target's context are
+/// resolved through EGL (see pong::gl::setContext), and
+/// pong::gl switches to them whenever setActive(true) is
+/// called. Only built where EGL is available, which defines
+/// PONG_HEADLESS_EGL; link with libEGL.
+///
+/// Usage example:
+/// \code
+/// pong::HeadlessRenderTarget target;
+/// if (!target.create({256, 240}))
+///     return;
+///
+/// const auto backend = pong::createRenderBackend(target, target.getSettings());
+/// frame.replay(*backend);
+/// target.display();
+///
+/// if (!target.capture().saveToFile("frame.png"))
+///     return;
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class HeadlessRenderTarget : public sf::RenderTarget
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// The context is created by create().
+    ///
+    ////////////////////////////////////////////////////////////
+    HeadlessRenderTarget() = default;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// Objects created with the target's context, such as its
+    /// backend, must have been destroyed first.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~HeadlessRenderTarget() override;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    HeadlessRenderTarget(const HeadlessRenderTarget&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy assignment
+    ///
+    ////////////////////////////////////////////////////////////
+    HeadlessRenderTarget& operator=(const HeadlessRenderTarget&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the context and the framebuffer
+    ///
+    /// The context is left active on the calling thread.
+    ///
+    /// \param size Size of the target, in pixels
+    ///
+    /// \return True if successful
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool create(const sf::Vector2u& size);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the settings of the context
+    ///
+    /// Always a core profile, of version 3.3 or higher.
+    ///
+    ////////////////////////////////////////////////////////////
+    const sf::ContextSettings& getSettings() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Return the size of the target, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Vector2u getSize() const override;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Activate or deactivate the context on the calling thread
+    ///
+    /// Activating also binds the framebuffer.
+    ///
+    /// \param active True to activate, false to deactivate
+    ///
+    /// \return True if successful
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool setActive(bool active = true) override;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Wait until everything drawn so far is rendered
+    ///
+    /// There is nothing to present; this takes the place of
+    /// sf::Window::display() so that frame times include the
+    /// GPU's work, as they would without vertical sync.
+    ///
+    ////////////////////////////////////////////////////////////
+    void display();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Copy the contents of the target to an image
+    ///
+    /// The context must be active. Stalls until the GPU is done.
+    ///
+    /// \return Image with the target's pixels, top row first
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Image capture() const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Destroy the framebuffer and the context
+    ///
+    ////////////////////////////////////////////////////////////
+    void destroy();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    void*               m_display{};     //!< EGL display the context belongs to
+    void*               m_context{};     //!< EGL context
+    gl::GLuint          m_framebuffer{}; //!< Framebuffer object drawn to
+    gl::GLuint          m_colorBuffer{}; //!< Color renderbuffer of the framebuffer
+    sf::Vector2u        m_size;          //!< Size of the target, in pixels
+    sf::ContextSettings m_settings;      //!< Settings of the context
+};
+
+} // namespace pong
@@ -0,0 +1,186 @@
+#include "IndexedFramebuffer.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Scene pixels store the index in red and the palette number
+// in green; the vertex color's green selects the palette as
+// 255 - palette, so that white means palette 0.
+////////////////////////////////////////////////////////////
+constexpr const char* indexShaderSource = R"(
+#version 120
+
+uniform sampler2D indices;
+
+void main()
+{
+    float index = texture2D(indices, gl_TexCoord[0].xy).r;
+    if (index == 0.0)
+        discard;
+
+    gl_FragColor = vec4(index, 1.0 - gl_Color.g, 0.0, 1.0);
+}
+)";
+
+constexpr const char* resolveShaderSource = R"(
+#version 120
+
+uniform sampler2D scene;
+uniform sampler2D palettes;
+uniform float     paletteCount;
+
+void main()
+{
+    vec2 entry   = floor(texture2D(scene, gl_TexCoord[0].xy).rg * 255.0 + 0.5);
+    gl_FragColor = texture2D(palettes, vec2((entry.x + 0.5) / 256.0, (entry.y + 0.5) / paletteCount)) * gl_Color;
+}
+)";
+
+static_assert(sizeof(sf::Color) == 4, "Palettes are uploaded as arrays of sf::Color");
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+bool IndexedFramebuffer::create(const sf::Vector2u& sceneSize, unsigned int paletteCount)
+{
+    assert((paletteCount >= 1) && (paletteCount <= 256));
+
+    if (!isAvailable())
+    {
+        sf::err() << "Failed to create the indexed framebuffer: shaders are not supported" << std::endl;
+        return false;
+    }
+
+    if (!m_scene.create(sceneSize) || !m_paletteTexture.create({256, paletteCount}))
+    {
+        sf::err() << "Failed to create the indexed framebuffer textures" << std::endl;
+        return false;
+    }
+
+    // Indices must never be interpolated
+    m_scene.setSmooth(false);
+    m_paletteTexture.setSmooth(false);
+
+    if (!m_indexShader.loadFromMemory(indexShaderSource, sf::Shader::Type::Fragment) ||
+        !m_resolveShader.loadFromMemory(resolveShaderSource, sf::Shader::Type::Fragment))
+    {
+        sf::err() << "Failed to compile the indexed framebuffer shaders" << std::endl;
+        return false;
+    }
+
+    m_indexShader.setUniform("indices", sf::Shader::CurrentTexture);
+    m_resolveShader.setUniform("scene", sf::Shader::CurrentTexture);
+    m_resolveShader.setUniform("palettes", m_paletteTexture);
+    m_resolveShader.setUniform("paletteCount", static_cast<float>(paletteCount));
+
+    Palette black;
+    black.fill(sf::Color::Black);
+    m_palettes.assign(paletteCount, black);
+
+    for (unsigned int i = 0; i < paletteCount; ++i)
+        uploadPalette(i);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool IndexedFramebuffer::isAvailable()
+{
+    return sf::Shader::isAvailable();
+}
+
+
+////////////////////////////////////////////////////////////
+sf::RenderTexture& IndexedFramebuffer::getScene()
+{
+    return m_scene;
+}
+
+
+////////////////////////////////////////////////////////////
+const sf::Shader* IndexedFramebuffer::getIndexShader() const
+{
+    return &m_indexShader;
+}
+
+
+////////////////////////////////////////////////////////////
+void IndexedFramebuffer::setPalette(unsigned int palette, const Palette& colors)
+{
+    assert(palette < m_palettes.size());
+
+    m_palettes[palette] = colors;
+    uploadPalette(palette);
+}
+
+
+////////////////////////////////////////////////////////////
+const Palette& IndexedFramebuffer::getPalette(unsigned int palette) const
+{
+    assert(palette < m_palettes.size());
+
+    return m_palettes[palette];
+}
+
+
+////////////////////////////////////////////////////////////
+void IndexedFramebuffer::setColor(unsigned int palette, std::uint8_t index, const sf::Color& color)
+{
+    assert(palette < m_palettes.size());
+
+    m_palettes[palette][index] = color;
+    m_paletteTexture.update(reinterpret_cast<const std::uint8_t*>(&color), {1, 1}, {index, palette});
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Color IndexedFramebuffer::getClearColor(std::uint8_t index, unsigned int palette)
+{
+    return sf::Color(index, static_cast<std::uint8_t>(palette), 0);
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Color IndexedFramebuffer::getPaletteColor(unsigned int palette)
+{
+    return sf::Color(255, static_cast<std::uint8_t>(255 - palette), 255);
+}
+
+
+////////////////////////////////////////////////////////////
+void IndexedFramebuffer::resolve(sf::RenderTarget& output)
+{
+    m_scene.display();
+
+    // Fit the scene in the output, keeping its aspect ratio
+    const sf::Vector2f sceneSize(m_scene.getSize());
+    const sf::Vector2f outputSize(output.getSize());
+    const float        scale = std::min(outputSize.x / sceneSize.x, outputSize.y / sceneSize.y);
+
+    sf::Sprite sprite(m_scene.getTexture());
+    sprite.setScale({scale, scale});
+    sprite.setPosition((outputSize - sceneSize * scale) / 2.f);
+
+    const sf::View view = output.getView();
+    output.setView(sf::View(sf::FloatRect({0.f, 0.f}, outputSize)));
+    output.clear();
+    output.draw(sprite, &m_resolveShader);
+    output.setView(view);
+}
+
+
+////////////////////////////////////////////////////////////
+void IndexedFramebuffer::uploadPalette(unsigned int palette)
+{
+    m_paletteTexture.update(reinterpret_cast<const std::uint8_t*>(m_palettes[palette].data()), {256, 1}, {0, palette});
+}
+
+} // namespace pong
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "IndexedTexture.hpp"
+#include "sfml.h"
+
+#include <cstdint>
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Palette-indexed scene resolved to colors at present time
+///
+/// The scene is drawn at its native resolution (256x240 by
+/// default) into getScene(), which holds a palette index and
+/// a palette number per pixel instead of a color. Indexed art
+/// (IndexedTexture) is drawn with getIndexShader(); resolve()
+/// then looks every pixel up in its palette while drawing the
+/// scene to the output, scaled to fit.
+///
+/// Several palettes can be loaded at once, like the NES's
+/// sub-palettes: a draw selects one with its vertex color
+/// (see getPaletteColor), so that the same art can be drawn in
+/// different colors in one batch. Changing a palette updates a
+/// single 256-texel row, so palette swaps and cycling effects
+/// cost nothing more.
+///
+/// Only indexed art drawn with the index shader and clears
+/// with getClearColor() produce meaningful pixels; anything
+/// else drawn to the scene is interpreted as indices as well.
+/// The shaders need a compatibility context.
+///
+/// Usage example:
+/// \code
+/// frame.clear(pong::IndexedFramebuffer::getClearColor(backgroundIndex));
+/// sprite.setColor(pong::IndexedFramebuffer::getPaletteColor(1));
+/// frame.draw(sprite, indexed.getIndexShader());
+/// // after replaying to indexed.getScene():
+/// indexed.resolve(window);
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class IndexedFramebuffer
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the scene, the palettes and the shaders
+    ///
+    /// All the palettes start black.
+    ///
+    /// \param sceneSize    Native resolution of the scene
+    /// \param paletteCount Number of palettes, in [1, 256]
+    ///
+    /// \return True if successful
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool create(const sf::Vector2u& sceneSize = {256, 240}, unsigned int paletteCount = 1);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the system supports indexed rendering
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the render texture the scene must be drawn to
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::RenderTexture& getScene();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the shader to draw IndexedTexture objects with
+    ///
+    /// Index 0 is discarded, leaving the scene untouched.
+    ///
+    ////////////////////////////////////////////////////////////
+    const sf::Shader* getIndexShader() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Replace a whole palette
+    ///
+    /// \param palette Number of the palette to replace
+    /// \param colors  New colors
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPalette(unsigned int palette, const Palette& colors);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a palette
+    ///
+    ////////////////////////////////////////////////////////////
+    const Palette& getPalette(unsigned int palette) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a single palette entry
+    ///
+    /// \param palette Number of the palette to change
+    /// \param index   Index of the entry
+    /// \param color   New color
+    ///
+    ////////////////////////////////////////////////////////////
+    void setColor(unsigned int palette, std::uint8_t index, const sf::Color& color);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the clear color filling the scene with a palette entry
+    ///
+    /// \param index   Index to fill the scene with
+    /// \param palette Palette the index refers to
+    ///
+    ////////////////////////////////////////////////////////////
+    static sf::Color getClearColor(std::uint8_t index, unsigned int palette = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the vertex color selecting a palette for indexed art
+    ///
+    /// Palette 0 is selected by white, the default vertex color.
+    ///
+    /// \param palette Palette to draw with
+    ///
+    ////////////////////////////////////////////////////////////
+    static sf::Color getPaletteColor(unsigned int palette);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the scene texture and draw it to the output through the palettes
+    ///
+    /// The output is cleared to black first. The output's view
+    /// is left unchanged.
+    ///
+    /// \param output Render target to draw to
+    ///
+    ////////////////////////////////////////////////////////////
+    void resolve(sf::RenderTarget& output);
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Upload a palette to its row of m_paletteTexture
+    ///
+    ////////////////////////////////////////////////////////////
+    void uploadPalette(unsigned int palette);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    sf::RenderTexture    m_scene;          //!< Indices and palette numbers of the scene
+    sf::Texture          m_paletteTexture; //!< One row of 256 colors per palette
+    std::vector<Palette> m_palettes;       //!< CPU copy of the palettes
+    sf::Shader           m_indexShader;    //!< Writes indices to the scene
+    sf::Shader           m_resolveShader;  //!< Looks the scene up in the palettes
+};
+
+} // namespace pong
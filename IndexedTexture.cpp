@@ -0,0 +1,208 @@
+#include "IndexedTexture.hpp"
+
+#include "GlFunctions.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Single-channel storage: R8 where available, LUMINANCE8 in
+// older compatibility contexts; both sample to .r.
+////////////////////////////////////////////////////////////
+struct IndexFormat
+{
+    pong::gl::GLint  internalFormat;
+    pong::gl::GLenum format;
+};
+
+IndexFormat getIndexFormat()
+{
+    // Asked of the active context each time, contexts may differ
+    return pong::gl::isTextureRgAvailable()
+               ? IndexFormat{static_cast<pong::gl::GLint>(pong::gl::R8), pong::gl::RED}
+               : IndexFormat{static_cast<pong::gl::GLint>(pong::gl::LUMINANCE8), pong::gl::LUMINANCE};
+}
+
+
+////////////////////////////////////////////////////////////
+// Run a texture upload with tight row packing, leaving the
+// texture binding and the unpack alignment as they were, as
+// SFML's states cache and other uploads expect them
+////////////////////////////////////////////////////////////
+template <typename F>
+void withTextureBound(const sf::Texture& texture, F upload)
+{
+    namespace gl = pong::gl;
+
+    gl::GLint previous  = 0;
+    gl::GLint alignment = 4;
+    gl::GetIntegerv(gl::TEXTURE_BINDING_2D, &previous);
+    gl::GetIntegerv(gl::UNPACK_ALIGNMENT, &alignment);
+    gl::BindTexture(gl::TEXTURE_2D, texture.getNativeHandle());
+    gl::PixelStorei(gl::UNPACK_ALIGNMENT, 1);
+
+    upload();
+
+    gl::PixelStorei(gl::UNPACK_ALIGNMENT, alignment);
+    gl::BindTexture(gl::TEXTURE_2D, static_cast<gl::GLuint>(previous));
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+std::size_t addImageColors(const sf::Image& image, Palette& palette, std::size_t firstIndex)
+{
+    std::size_t next = std::max<std::size_t>(firstIndex, 1);
+
+    const sf::Vector2u size = image.getSize();
+    for (unsigned int y = 0; y < size.y; ++y)
+    {
+        for (unsigned int x = 0; x < size.x; ++x)
+        {
+            if (next >= palette.size())
+                return next;
+
+            sf::Color color = image.getPixel({x, y});
+            if (color.a < 128)
+                continue;
+
+            color.a = 255;
+            if (std::find(palette.begin() + 1, palette.begin() + static_cast<std::ptrdiff_t>(next), color) ==
+                palette.begin() + static_cast<std::ptrdiff_t>(next))
+                palette[next++] = color;
+        }
+    }
+
+    return next;
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint8_t findNearestIndex(const Palette& palette, const sf::Color& color)
+{
+    if (color.a < 128)
+        return 0;
+
+    std::uint8_t nearest  = 1;
+    int          distance = std::numeric_limits<int>::max();
+
+    for (std::size_t i = 1; i < palette.size(); ++i)
+    {
+        const int r = palette[i].r - color.r;
+        const int g = palette[i].g - color.g;
+        const int b = palette[i].b - color.b;
+        const int d = r * r + g * g + b * b;
+
+        if (d < distance)
+        {
+            nearest  = static_cast<std::uint8_t>(i);
+            distance = d;
+
+            if (d == 0)
+                break;
+        }
+    }
+
+    return nearest;
+}
+
+
+////////////////////////////////////////////////////////////
+bool IndexedTexture::create(const sf::Vector2u& size, const std::uint8_t* indices)
+{
+    if (!m_texture.create(size))
+        return false;
+
+    const TransientContextLock lock;
+
+    if (!gl::load())
+    {
+        sf::err() << "Failed to create indexed texture: OpenGL functions could not be loaded" << std::endl;
+        return false;
+    }
+
+    const std::vector<std::uint8_t> zeros(indices ? 0 : static_cast<std::size_t>(size.x) * size.y);
+    const IndexFormat               format = getIndexFormat();
+
+    // Replace SFML's RGBA storage with a single channel of the same size
+    withTextureBound(m_texture,
+                     [&]
+                     {
+                         gl::TexImage2D(gl::TEXTURE_2D,
+                                        0,
+                                        format.internalFormat,
+                                        static_cast<gl::GLsizei>(size.x),
+                                        static_cast<gl::GLsizei>(size.y),
+                                        0,
+                                        format.format,
+                                        gl::UNSIGNED_BYTE,
+                                        indices ? indices : zeros.data());
+                     });
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool IndexedTexture::loadFromImage(const sf::Image& image, const Palette& palette)
+{
+    const sf::Vector2u        size = image.getSize();
+    std::vector<std::uint8_t> indices(static_cast<std::size_t>(size.x) * size.y);
+
+    for (unsigned int y = 0; y < size.y; ++y)
+        for (unsigned int x = 0; x < size.x; ++x)
+            indices[static_cast<std::size_t>(y) * size.x + x] = findNearestIndex(palette, image.getPixel({x, y}));
+
+    return create(size, indices.data());
+}
+
+
+////////////////////////////////////////////////////////////
+void IndexedTexture::update(const std::uint8_t* indices, const sf::Vector2u& size, const sf::Vector2u& dest)
+{
+    assert(dest.x + size.x <= getSize().x);
+    assert(dest.y + size.y <= getSize().y);
+
+    if (!indices || !m_texture.getNativeHandle())
+        return;
+
+    const TransientContextLock lock;
+    const IndexFormat          format = getIndexFormat();
+
+    withTextureBound(m_texture,
+                     [&]
+                     {
+                         gl::TexSubImage2D(gl::TEXTURE_2D,
+                                           0,
+                                           static_cast<gl::GLint>(dest.x),
+                                           static_cast<gl::GLint>(dest.y),
+                                           static_cast<gl::GLsizei>(size.x),
+                                           static_cast<gl::GLsizei>(size.y),
+                                           format.format,
+                                           gl::UNSIGNED_BYTE,
+                                           indices);
+                     });
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Vector2u IndexedTexture::getSize() const
+{
+    return m_texture.getSize();
+}
+
+
+////////////////////////////////////////////////////////////
+const sf::Texture& IndexedTexture::getTexture() const
+{
+    return m_texture;
+}
+
+} // namespace pong
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "sfml.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief 256 colors addressed by 8-bit indices
+///
+/// Index 0 is transparent by convention: indexed art never
+/// draws it, whatever color the palette holds there.
+///
+////////////////////////////////////////////////////////////
+using Palette = std::array<sf::Color, 256>;
+
+////////////////////////////////////////////////////////////
+/// \brief Add the opaque colors of an image to a palette
+///
+/// Colors already in [1, firstIndex) are not added again.
+/// Colors that don't fit are left out; IndexedTexture maps
+/// them to the nearest color when loading the image.
+///
+/// \param image      Image whose colors to add
+/// \param palette    Palette to fill
+/// \param firstIndex First free index of the palette, at least 1
+///
+/// \return Next free index of the palette, 256 if it is full
+///
+////////////////////////////////////////////////////////////
+std::size_t addImageColors(const sf::Image& image, Palette& palette, std::size_t firstIndex = 1);
+
+////////////////////////////////////////////////////////////
+/// \brief Find the palette entry closest to a color
+///
+/// Transparent colors (alpha below 128) map to index 0, others
+/// to the entry in [1, 255] with the smallest RGB distance.
+///
+/// \param palette Palette to search
+/// \param color   Color to look for
+///
+/// \return Index of the closest entry
+///
+////////////////////////////////////////////////////////////
+std::uint8_t findNearestIndex(const Palette& palette, const sf::Color& color);
+
+
+////////////////////////////////////////////////////////////
+/// \brief Texture of 8-bit palette indices
+///
+/// The pixels are stored in a single-channel texture (R8, or
+/// LUMINANCE8 where texture_rg is missing), which takes a
+/// quarter of the memory and upload bandwidth of an RGBA one.
+/// Sampling it gives the index divided by 255 in the red
+/// channel; draw it with IndexedFramebuffer::getIndexShader()
+/// into an IndexedFramebuffer's scene.
+///
+/// The storage is an sf::Texture whose format is changed
+/// behind SFML's back, so that it can be used with sf::Sprite,
+/// command buffers and batchers like any other texture. This
+/// assumes non-power-of-two texture support (OpenGL 2.0).
+///
+////////////////////////////////////////////////////////////
+class IndexedTexture : sf::GlResource
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the texture from raw indices
+    ///
+    /// \param size    Width and height of the texture
+    /// \param indices size.x * size.y indices, row by row, or null to fill it with index 0
+    ///
+    /// \return True if successful
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool create(const sf::Vector2u& size, const std::uint8_t* indices = nullptr);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the texture by quantizing an image against a palette
+    ///
+    /// \param image   Image to convert
+    /// \param palette Palette the indices refer to
+    ///
+    /// \return True if successful
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool loadFromImage(const sf::Image& image, const Palette& palette);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Replace a rectangle of indices
+    ///
+    /// \param indices size.x * size.y indices, row by row
+    /// \param size    Size of the rectangle
+    /// \param dest    Top-left corner of the rectangle in the texture
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(const std::uint8_t* indices, const sf::Vector2u& size, const sf::Vector2u& dest);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the texture
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Vector2u getSize() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the underlying texture, to draw it
+    ///
+    ////////////////////////////////////////////////////////////
+    const sf::Texture& getTexture() const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    sf::Texture m_texture; //!< Texture with single-channel storage
+};
+
+} // namespace pong
@@ -0,0 +1,275 @@
+#include "InstancedSpriteRenderer.hpp"
+
+#include "GlFunctions.hpp"
+
+#include <cstddef>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// The instance's centre and scale are packed into one vec4
+// attribute; the quad is expanded and rotated in the shader.
+////////////////////////////////////////////////////////////
+constexpr const char* vertexShaderSource = R"(
+#version 130
+
+uniform mat4      viewProjection;
+uniform sampler2D atlas;
+
+in vec2  corner;
+in vec4  placement;
+in float rotation;
+in vec4  textureRect;
+in vec4  color;
+
+out vec2 texCoord;
+out vec4 tint;
+
+void main()
+{
+    vec2  local = (corner - 0.5) * textureRect.zw * placement.zw;
+    float c     = cos(rotation);
+    float s     = sin(rotation);
+    vec2  world = placement.xy + vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+
+    gl_Position = viewProjection * vec4(world, 0.0, 1.0);
+    texCoord    = (textureRect.xy + corner * textureRect.zw) / vec2(textureSize(atlas, 0));
+    tint        = color;
+}
+)";
+
+constexpr const char* fragmentShaderSource = R"(
+#version 130
+
+uniform sampler2D atlas;
+
+in vec2 texCoord;
+in vec4 tint;
+
+void main()
+{
+    gl_FragColor = texture(atlas, texCoord) * tint;
+}
+)";
+
+constexpr float unitQuad[] = {0.f, 0.f, 0.f, 1.f, 1.f, 0.f, 1.f, 1.f};
+
+using Instance = pong::InstancedSpriteRenderer::Instance;
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+InstancedSpriteRenderer::InstancedSpriteRenderer() = default;
+
+
+////////////////////////////////////////////////////////////
+InstancedSpriteRenderer::~InstancedSpriteRenderer()
+{
+    if (!m_quadBuffer && !m_instanceBuffer)
+        return;
+
+    const TransientContextLock lock;
+
+    const gl::GLuint buffers[] = {m_quadBuffer, m_instanceBuffer};
+    gl::DeleteBuffers(2, buffers);
+}
+
+
+////////////////////////////////////////////////////////////
+bool InstancedSpriteRenderer::create()
+{
+    const TransientContextLock lock;
+
+    if (!isAvailable())
+        return false;
+
+    if (!m_shader.loadFromMemory(vertexShaderSource, fragmentShaderSource))
+        return false;
+
+    const unsigned int program = m_shader.getNativeHandle();
+    m_attributes.corner        = gl::GetAttribLocation(program, "corner");
+    m_attributes.placement     = gl::GetAttribLocation(program, "placement");
+    m_attributes.rotation      = gl::GetAttribLocation(program, "rotation");
+    m_attributes.textureRect   = gl::GetAttribLocation(program, "textureRect");
+    m_attributes.color         = gl::GetAttribLocation(program, "color");
+
+    if (!m_quadBuffer)
+    {
+        gl::GenBuffers(1, &m_quadBuffer);
+        gl::BindBuffer(gl::ARRAY_BUFFER, m_quadBuffer);
+        gl::BufferData(gl::ARRAY_BUFFER, sizeof(unitQuad), unitQuad, gl::STATIC_DRAW);
+    }
+
+    if (!m_instanceBuffer)
+        gl::GenBuffers(1, &m_instanceBuffer);
+
+    gl::BindBuffer(gl::ARRAY_BUFFER, 0);
+
+    m_bufferCapacity = 0;
+    m_needUpload     = true;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSpriteRenderer::setTexture(const sf::Texture& texture)
+{
+    m_texture = &texture;
+    m_shader.setUniform("atlas", texture);
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSpriteRenderer::append(const Instance& instance)
+{
+    m_instances.push_back(instance);
+    m_needUpload = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSpriteRenderer::resize(std::size_t instanceCount)
+{
+    m_instances.resize(instanceCount);
+    m_needUpload = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSpriteRenderer::clear()
+{
+    m_instances.clear();
+    m_needUpload = true;
+}
+
+
+////////////////////////////////////////////////////////////
+InstancedSpriteRenderer::Instance& InstancedSpriteRenderer::operator[](std::size_t index)
+{
+    m_needUpload = true;
+    return m_instances[index];
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t InstancedSpriteRenderer::getInstanceCount() const
+{
+    return m_instances.size();
+}
+
+
+////////////////////////////////////////////////////////////
+bool InstancedSpriteRenderer::isAvailable()
+{
+    return sf::Shader::isAvailable() && gl::isInstancingAvailable();
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSpriteRenderer::draw(sf::RenderTarget& target, const sf::RenderStates& states) const
+{
+    if (m_instances.empty() || !m_texture || !m_instanceBuffer)
+        return;
+
+    if (!target.setActive(true))
+        return;
+
+    upload();
+
+    // Same projection and viewport that sf::RenderTarget would apply
+    const sf::View&   view     = target.getView();
+    const sf::IntRect viewport = target.getViewport(view);
+    const int         top      = static_cast<int>(target.getSize().y) - (viewport.top + viewport.height);
+    gl::Viewport(viewport.left, top, viewport.width, viewport.height);
+
+    m_shader.setUniform("viewProjection", sf::Glsl::Mat4(view.getTransform() * states.transform));
+    gl::applyBlendMode(states.blendMode);
+
+    sf::Shader::bind(&m_shader);
+    bindAttributes();
+
+    gl::DrawArraysInstanced(gl::TRIANGLE_STRIP, 0, 4, static_cast<gl::GLsizei>(m_instances.size()));
+
+    unbindAttributes();
+    sf::Shader::bind(nullptr);
+
+    // We changed states behind the back of the render target's cache
+    target.resetGLStates();
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSpriteRenderer::upload() const
+{
+    if (!m_needUpload)
+        return;
+
+    const auto size = static_cast<gl::GLsizeiptr>(m_instances.size() * sizeof(Instance));
+
+    gl::BindBuffer(gl::ARRAY_BUFFER, m_instanceBuffer);
+
+    // Grow geometrically so that a slowly increasing count doesn't reallocate every frame
+    if (m_instances.size() > m_bufferCapacity)
+        m_bufferCapacity = m_instances.size() + m_instances.size() / 2;
+
+    // Orphan the previous storage so that we don't wait for the GPU to finish reading it
+    gl::BufferData(gl::ARRAY_BUFFER, static_cast<gl::GLsizeiptr>(m_bufferCapacity * sizeof(Instance)), nullptr, gl::STREAM_DRAW);
+    gl::BufferSubData(gl::ARRAY_BUFFER, 0, size, m_instances.data());
+    gl::BindBuffer(gl::ARRAY_BUFFER, 0);
+
+    m_needUpload = false;
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSpriteRenderer::bindAttributes() const
+{
+    const auto setup = [](int location, int size, gl::GLenum type, bool normalized, std::size_t stride, std::size_t offset, unsigned int divisor)
+    {
+        if (location < 0)
+            return;
+
+        const auto index = static_cast<gl::GLuint>(location);
+        gl::EnableVertexAttribArray(index);
+        gl::VertexAttribPointer(index,
+                                size,
+                                type,
+                                normalized,
+                                static_cast<gl::GLsizei>(stride),
+                                reinterpret_cast<const void*>(offset));
+        gl::VertexAttribDivisor(index, divisor);
+    };
+
+    gl::BindBuffer(gl::ARRAY_BUFFER, m_quadBuffer);
+    setup(m_attributes.corner, 2, gl::FLOAT, false, 2 * sizeof(float), 0, 0);
+
+    gl::BindBuffer(gl::ARRAY_BUFFER, m_instanceBuffer);
+    setup(m_attributes.placement, 4, gl::FLOAT, false, sizeof(Instance), offsetof(Instance, position), 1);
+    setup(m_attributes.rotation, 1, gl::FLOAT, false, sizeof(Instance), offsetof(Instance, rotation), 1);
+    setup(m_attributes.textureRect, 4, gl::UNSIGNED_SHORT, false, sizeof(Instance), offsetof(Instance, textureRect), 1);
+    setup(m_attributes.color, 4, gl::UNSIGNED_BYTE, true, sizeof(Instance), offsetof(Instance, color), 1);
+}
+
+
+////////////////////////////////////////////////////////////
+void InstancedSpriteRenderer::unbindAttributes() const
+{
+    for (const int location :
+         {m_attributes.corner, m_attributes.placement, m_attributes.rotation, m_attributes.textureRect, m_attributes.color})
+    {
+        if (location < 0)
+            continue;
+
+        // Reset the divisor too, sf::RenderTarget doesn't know about it
+        gl::VertexAttribDivisor(static_cast<gl::GLuint>(location), 0);
+        gl::DisableVertexAttribArray(static_cast<gl::GLuint>(location));
+    }
+
+    gl::BindBuffer(gl::ARRAY_BUFFER, 0);
+}
+
+} // namespace pong
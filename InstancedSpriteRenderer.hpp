@@ -0,0 +1,199 @@
+#pragma once
+
+#include "sfml.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Draws many textured quads with a single instanced draw call
+///
+/// sf::Sprite pre-computes 4 vertices per object on the CPU
+/// and sends them every frame. This renderer instead keeps a
+/// unit quad in a static vertex buffer and streams one
+/// 32-byte Instance per sprite; the vertex shader expands the
+/// quad, so N sprites cost one upload of N * 32 bytes and one
+/// draw call.
+///
+/// All instances share the same texture. The blend mode and
+/// transform of the render states passed to draw() are
+/// honoured; the shader of the render states is ignored since
+/// the renderer needs its own vertex shader.
+///
+/// Requires GLSL 1.30 and instanced arrays (OpenGL 3.3 or
+/// ARB_instanced_arrays), which Mesa's llvmpipe provides.
+///
+////////////////////////////////////////////////////////////
+class InstancedSpriteRenderer : public sf::Drawable, sf::GlResource
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Per-instance data, as uploaded to the GPU
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Instance
+    {
+        sf::Vector2f  position;                //!< Position of the centre of the sprite
+        sf::Vector2f  scale{1.f, 1.f};         //!< Scale factors
+        float         rotation{};              //!< Rotation around the centre, in radians
+        std::uint16_t textureRect[4]{};        //!< Left, top, width and height of the texture rectangle, in texels
+        sf::Color     color{255, 255, 255, 255}; //!< Color multiplied with the texture
+    };
+
+    static_assert(sizeof(Instance) == 32, "Instance layout must match the vertex attribute setup");
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// The renderer is unusable until create() succeeds.
+    ///
+    ////////////////////////////////////////////////////////////
+    InstancedSpriteRenderer();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ~InstancedSpriteRenderer() override;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    InstancedSpriteRenderer(const InstancedSpriteRenderer&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy assignment
+    ///
+    ////////////////////////////////////////////////////////////
+    InstancedSpriteRenderer& operator=(const InstancedSpriteRenderer&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Compile the shader and allocate the GPU buffers
+    ///
+    /// \return True on success, false if instancing is not supported
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool create();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the texture shared by all the instances
+    ///
+    /// The texture must outlive the renderer, or at least the
+    /// last call to draw().
+    ///
+    /// \param texture Texture to use
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTexture(const sf::Texture& texture);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an instance
+    ///
+    /// \param instance Instance to add
+    ///
+    ////////////////////////////////////////////////////////////
+    void append(const Instance& instance);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Resize the instance array
+    ///
+    /// New instances are default-constructed.
+    ///
+    /// \param instanceCount New number of instances
+    ///
+    ////////////////////////////////////////////////////////////
+    void resize(std::size_t instanceCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the instances
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a read-write access to an instance by its index
+    ///
+    /// Accessing an instance marks the whole array for upload
+    /// at the next draw.
+    ///
+    /// \param index Index of the instance to get
+    ///
+    /// \return Reference to the index-th instance
+    ///
+    ////////////////////////////////////////////////////////////
+    Instance& operator[](std::size_t index);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of instances
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getInstanceCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the system supports instanced sprites
+    ///
+    /// A context must be active on the calling thread.
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isAvailable();
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the instances to a render target
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(sf::RenderTarget& target, const sf::RenderStates& states) const override;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Upload the instance array if it changed since the last draw
+    ///
+    ////////////////////////////////////////////////////////////
+    void upload() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enable and describe the vertex attributes
+    ///
+    ////////////////////////////////////////////////////////////
+    void bindAttributes() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Disable the vertex attributes enabled by bindAttributes
+    ///
+    ////////////////////////////////////////////////////////////
+    void unbindAttributes() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Attribute locations in the instancing shader
+    ///
+    ////////////////////////////////////////////////////////////
+    struct AttributeLocations
+    {
+        int corner{-1};      //!< Unit quad corner, per vertex
+        int placement{-1};   //!< Position and scale, per instance
+        int rotation{-1};    //!< Rotation, per instance
+        int textureRect{-1}; //!< Texture rectangle, per instance
+        int color{-1};       //!< Color, per instance
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<Instance> m_instances;          //!< Instances to draw
+    const sf::Texture*    m_texture{};          //!< Texture shared by all the instances
+    mutable sf::Shader    m_shader;             //!< Shader expanding the unit quad
+    AttributeLocations    m_attributes;         //!< Attribute locations in m_shader
+    unsigned int          m_quadBuffer{};       //!< Static buffer holding the unit quad
+    unsigned int          m_instanceBuffer{};   //!< Streaming buffer holding the instances
+    mutable std::size_t   m_bufferCapacity{};   //!< Number of instances m_instanceBuffer can hold
+    mutable bool          m_needUpload{};       //!< Did the instances change since the last upload?
+};
+
+} // namespace pong
@@ -0,0 +1,10 @@
+#include "Match.hpp"
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+template class BasicMatch<MatchRules>;
+template class BasicMatch<ClassicRules>;
+
+} // namespace pong
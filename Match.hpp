@@ -0,0 +1,401 @@
+#pragma once
+
+#include "Philox.hpp"
+#include "sfml.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Types and constants shared by every kind of match
+///
+////////////////////////////////////////////////////////////
+struct MatchDefinitions
+{
+    ////////////////////////////////////////////////////////////
+    /// \brief Fixed point number, with FixedShift fractional bits
+    ///
+    ////////////////////////////////////////////////////////////
+    using Fixed = std::int32_t;
+
+    static constexpr int   FixedShift{8};             // NOLINT(readability-identifier-naming)
+    static constexpr Fixed FixedOne{1 << FixedShift}; // NOLINT(readability-identifier-naming)
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Indices of the two sides
+    ///
+    ////////////////////////////////////////////////////////////
+    static constexpr std::size_t Left{0};  // NOLINT(readability-identifier-naming)
+    static constexpr std::size_t Right{1}; // NOLINT(readability-identifier-naming)
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stage of the match
+    ///
+    ////////////////////////////////////////////////////////////
+    enum class Phase : std::uint8_t
+    {
+        Start, //!< Title screen, waiting for start()
+        Serve, //!< Ball waiting at the center of the field
+        Rally, //!< Ball in play
+        Goal,  //!< Ball out of the field, before the next serve
+        Over   //!< A side won
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Things that happened during a tick, combined in the result of step()
+    ///
+    ////////////////////////////////////////////////////////////
+    enum Event : std::uint32_t
+    {
+        WallBounce = 1 << 0, //!< The ball bounced off the top or bottom of the field
+        PaddleHit  = 1 << 1, //!< The ball bounced off a paddle
+        Goal       = 1 << 2, //!< The ball left the field and a side scored
+        Serve      = 1 << 3, //!< The ball was served
+        Over       = 1 << 4  //!< The last point of the match was scored
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Purposes of random numbers, each with its own Philox counters
+    ///
+    ////////////////////////////////////////////////////////////
+    enum class Draw : std::uint32_t
+    {
+        Receiver, //!< Side that receives the first serve
+        Serve,    //!< Angle of a serve
+        Aim       //!< Aim offsets of computer players, see AimNoise
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Complete state of a match
+    ///
+    ////////////////////////////////////////////////////////////
+    struct State
+    {
+        Phase         phase{Phase::Start}; //!< Current stage
+        std::uint32_t tick{};              //!< Number of ticks simulated
+        std::uint32_t phaseTicks{};        //!< Number of ticks spent in the current phase
+        sf::Vector2i  ballPosition;        //!< Top-left corner of the ball, in fixed pixels
+        sf::Vector2i  ballVelocity;        //!< Ball velocity, in fixed pixels per tick
+        Fixed         paddles[2]{};        //!< Top of each paddle, in fixed pixels
+        int           directions[2]{};     //!< Direction each paddle moved in during the last tick
+        unsigned int  scores[2]{};         //!< Score of each side
+        std::size_t   receiver{};          //!< Side the next serve goes to
+        unsigned int  hits{};              //!< Number of paddle hits in the current rally
+        std::uint64_t seed{};              //!< Key of the random numbers, see Philox
+        std::uint64_t matchId{};           //!< Stream of the random numbers, one per match of a batch
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Moves of a paddle over several ticks, for BasicMatch::advance()
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Course
+    {
+        std::uint32_t ticks{};     //!< Number of ticks covered
+        Fixed         distance{};  //!< Distance covered by the top of the paddle, in fixed pixels, down if positive
+        int           direction{}; //!< Direction of the paddle during the last tick, as in State::directions
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Convert a fixed point number to pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    static constexpr float toPixels(Fixed value)
+    {
+        return static_cast<float>(value) / static_cast<float>(FixedOne);
+    }
+};
+
+
+////////////////////////////////////////////////////////////
+/// \brief Parameters of a match, chosen at run time
+///
+////////////////////////////////////////////////////////////
+struct MatchRules
+{
+    using Fixed = MatchDefinitions::Fixed;
+
+    static constexpr Fixed FixedOne{MatchDefinitions::FixedOne}; // NOLINT(readability-identifier-naming)
+
+    sf::Vector2i  fieldSize{256, 240};       //!< Size of the field, in pixels
+    int           paddleInset{16};           //!< Distance from the side of the field to a paddle, in pixels
+    sf::Vector2i  paddleSize{4, 32};         //!< Size of a paddle, in pixels
+    int           ballSize{8};               //!< Width and height of the ball, in pixels
+    Fixed         paddleSpeed{3 * FixedOne}; //!< Paddle speed, in fixed pixels per tick
+    Fixed         serveSpeed{2 * FixedOne};  //!< Horizontal ball speed after a serve, in fixed pixels per tick
+    Fixed         speedUp{FixedOne / 8};     //!< Horizontal ball speed gained at each paddle hit
+    Fixed         maxSpeed{6 * FixedOne};    //!< Highest horizontal ball speed
+    Fixed         maxBounce{2 * FixedOne};   //!< Vertical ball speed after hitting the end of a paddle
+    Fixed         spin{};                    //!< Vertical ball speed a moving paddle adds when hit, 0 to disable
+    unsigned int  pointsToWin{11};           //!< Score that ends the match
+    bool          winByTwo{};                //!< Must the winner lead by two points, as in table tennis?
+    std::uint32_t serveDelay{60};            //!< Ticks spent in the Serve phase
+    std::uint32_t goalDelay{90};             //!< Ticks spent in the Goal phase
+};
+
+
+////////////////////////////////////////////////////////////
+/// \brief The default rules, fixed at compile time
+///
+/// Same values as a default MatchRules, as constants: every
+/// rule folds into the code of ClassicMatch, and the branches
+/// of disabled options are compiled out.
+///
+////////////////////////////////////////////////////////////
+struct ClassicRules
+{
+    using Fixed = MatchDefinitions::Fixed;
+
+    static constexpr Fixed FixedOne{MatchDefinitions::FixedOne}; // NOLINT(readability-identifier-naming)
+
+    // NOLINTBEGIN(readability-identifier-naming)
+    static constexpr sf::Vector2i  fieldSize{256, 240};
+    static constexpr int           paddleInset{16};
+    static constexpr sf::Vector2i  paddleSize{4, 32};
+    static constexpr int           ballSize{8};
+    static constexpr Fixed         paddleSpeed{3 * FixedOne};
+    static constexpr Fixed         serveSpeed{2 * FixedOne};
+    static constexpr Fixed         speedUp{FixedOne / 8};
+    static constexpr Fixed         maxSpeed{6 * FixedOne};
+    static constexpr Fixed         maxBounce{2 * FixedOne};
+    static constexpr Fixed         spin{};
+    static constexpr unsigned int  pointsToWin{11};
+    static constexpr bool          winByTwo{};
+    static constexpr std::uint32_t serveDelay{60};
+    static constexpr std::uint32_t goalDelay{90};
+    // NOLINTEND(readability-identifier-naming)
+};
+
+
+////////////////////////////////////////////////////////////
+/// \brief Headless simulation of a Pong match
+///
+/// The whole match is a small copyable value: copying it forks
+/// the game, and stepping a copy never affects the original.
+/// Nothing here depends on a window or a context, so matches
+/// can be simulated by the thousand on worker threads.
+///
+/// Positions and velocities are fixed point numbers with
+/// FixedShift fractional bits, in pixels and pixels per tick,
+/// and the simulation only uses integer arithmetic: a match
+/// replays identically from the same seed and inputs on any
+/// machine. Ticks are meant to last 1/60 s.
+///
+/// Random numbers come from a counter-based generator, Philox,
+/// keyed by the seed, the match's id and the tick: matches of
+/// a batch that share a seed get independent streams, and the
+/// numbers drawn at a tick don't depend on any earlier draw.
+///
+/// A match goes through the phases Start (title screen, until
+/// start() is called), then Serve, Rally and Goal for each
+/// point, and finally Over. Paddles move during every phase
+/// but Start and Over.
+///
+/// The rules are a policy: the class reads them from a member
+/// of type RulesPolicy, with the members of MatchRules. With
+/// MatchRules itself (pong::Match), they are chosen at run
+/// time; with a policy of static constexpr members such as
+/// ClassicRules (pong::ClassicMatch), each mode is a separate
+/// specialization with the rules folded into its code. Both
+/// play identically with the same values.
+///
+/// Usage example:
+/// \code
+/// pong::Match match(pong::Match::Rules(), seed);
+/// match.start();
+///
+/// // Every tick
+/// const std::uint32_t events = match.step(leftDirection, rightDirection);
+/// if (events & pong::Match::Goal)
+///     ++goals;
+///
+/// renderer.record(frame, match);
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+class BasicMatch : public MatchDefinitions
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Parameters of the match
+    ///
+    ////////////////////////////////////////////////////////////
+    using Rules = RulesPolicy;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a match on its title screen, with default rules
+    ///
+    ////////////////////////////////////////////////////////////
+    BasicMatch();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a match on its title screen
+    ///
+    /// \param rules   Parameters of the match
+    /// \param seed    Seed of the serve angles
+    /// \param matchId Index of the match among the ones sharing its seed
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit BasicMatch(const Rules& rules, std::uint64_t seed = 0, std::uint64_t matchId = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Start a new match from the Start or Over phase
+    ///
+    /// Scores are reset and the first serve goes to a random side.
+    /// Does nothing in other phases.
+    ///
+    ////////////////////////////////////////////////////////////
+    void start();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Simulate one tick
+    ///
+    /// \param left  Direction of the left paddle: negative moves up, positive down, 0 stays
+    /// \param right Direction of the right paddle
+    ///
+    /// \return Combination of Event flags
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint32_t step(int left, int right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of next ticks that can be skipped with advance()
+    ///
+    /// During these ticks, whatever the paddles do, nothing
+    /// happens but the ball flying straight: no bounce, no goal,
+    /// no serve and no change of phase. The next tick after them
+    /// must be simulated with step().
+    ///
+    /// \return Number of ticks, 0 if the next one may have an event
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint32_t getQuietTicks() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Simulate several quiet ticks at once
+    ///
+    /// Same result as calling step() once per tick with inputs
+    /// that move the paddles along their courses, in constant
+    /// time. Both courses must cover the same number of ticks,
+    /// at most getQuietTicks().
+    ///
+    /// \param left  Moves of the left paddle, see PaddleAi::plan()
+    /// \param right Moves of the right paddle
+    ///
+    ////////////////////////////////////////////////////////////
+    void advance(const Course& left, const Course& right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Replace the key and the stream of the random numbers
+    ///
+    /// Copies of a match share their future serves; reseeding a
+    /// copy makes it a different continuation of the same game.
+    ///
+    /// \param seed    Seed of the next serve angles
+    /// \param matchId Index of the match among the ones sharing its seed
+    ///
+    ////////////////////////////////////////////////////////////
+    void reseed(std::uint64_t seed, std::uint64_t matchId = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the parameters of the match
+    ///
+    ////////////////////////////////////////////////////////////
+    const Rules& getRules() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the complete state of the match
+    ///
+    ////////////////////////////////////////////////////////////
+    const State& getState() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the bounds of the ball, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::FloatRect getBallBounds() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the bounds of a paddle, in pixels
+    ///
+    /// \param side Left or Right
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::FloatRect getPaddleBounds(std::size_t side) const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Move the ball and resolve its collisions
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint32_t moveBall();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Bounce the ball off a paddle if it crossed its front this tick
+    ///
+    /// \param side     Side of the paddle
+    /// \param previous Position of the ball before the move
+    ///
+    /// \return True if the ball hit the paddle
+    ///
+    ////////////////////////////////////////////////////////////
+    bool hitPaddle(std::size_t side, const sf::Vector2i& previous);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether a side has won with its current score
+    ///
+    ////////////////////////////////////////////////////////////
+    bool hasWon(std::size_t side) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Put the ball at the center of the field and enter the Serve phase
+    ///
+    ////////////////////////////////////////////////////////////
+    void prepareServe();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enter a phase
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPhase(Phase phase);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw a random number for the current tick
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint32_t drawRandom(Draw draw) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Rules m_rules; //!< Parameters of the match
+    State m_state; //!< Complete state of the match
+};
+
+#include "Match.inl"
+
+////////////////////////////////////////////////////////////
+/// \brief Match with rules chosen at run time
+///
+////////////////////////////////////////////////////////////
+using Match = BasicMatch<MatchRules>;
+
+////////////////////////////////////////////////////////////
+/// \brief Match with the default rules fixed at compile time
+///
+////////////////////////////////////////////////////////////
+using ClassicMatch = BasicMatch<ClassicRules>;
+
+// Both are compiled once, in Match.cpp
+extern template class BasicMatch<MatchRules>;
+extern template class BasicMatch<ClassicRules>;
+
+} // namespace pong
@@ -0,0 +1,372 @@
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+BasicMatch<RulesPolicy>::BasicMatch() : BasicMatch(Rules())
+{
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+BasicMatch<RulesPolicy>::BasicMatch(const Rules& rules, std::uint64_t seed, std::uint64_t matchId) : m_rules(rules)
+{
+    const Fixed paddleTop = (m_rules.fieldSize.y - m_rules.paddleSize.y) * FixedOne / 2;
+
+    m_state.paddles[Left]  = paddleTop;
+    m_state.paddles[Right] = paddleTop;
+    m_state.seed           = seed;
+    m_state.matchId        = matchId;
+
+    prepareServe();
+    m_state.phase = Phase::Start;
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+void BasicMatch<RulesPolicy>::start()
+{
+    if ((m_state.phase != Phase::Start) && (m_state.phase != Phase::Over))
+        return;
+
+    m_state.scores[Left]  = 0;
+    m_state.scores[Right] = 0;
+    m_state.receiver      = static_cast<std::size_t>(drawRandom(Draw::Receiver) & 1);
+
+    prepareServe();
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+std::uint32_t BasicMatch<RulesPolicy>::step(int left, int right)
+{
+    ++m_state.tick;
+    ++m_state.phaseTicks;
+
+    if ((m_state.phase == Phase::Start) || (m_state.phase == Phase::Over))
+        return 0;
+
+    const Fixed lowest    = (m_rules.fieldSize.y - m_rules.paddleSize.y) * FixedOne;
+    const int   inputs[2] = {left, right};
+    for (std::size_t side = Left; side <= Right; ++side)
+    {
+        const int direction      = (inputs[side] > 0) - (inputs[side] < 0);
+        m_state.paddles[side]    = std::clamp(m_state.paddles[side] + direction * m_rules.paddleSpeed, 0, lowest);
+        m_state.directions[side] = direction;
+    }
+
+    std::uint32_t events = 0;
+
+    switch (m_state.phase)
+    {
+        case Phase::Serve:
+            if (m_state.phaseTicks >= m_rules.serveDelay)
+            {
+                // Random angle, at most half as steep as the steepest bounce
+                const auto range = static_cast<std::uint32_t>(m_rules.maxBounce) + 1;
+                m_state.ballVelocity.x = (m_state.receiver == Left) ? -m_rules.serveSpeed : m_rules.serveSpeed;
+                m_state.ballVelocity.y = static_cast<Fixed>(drawRandom(Draw::Serve) % range) - m_rules.maxBounce / 2;
+                m_state.hits           = 0;
+
+                setPhase(Phase::Rally);
+                events |= Serve;
+            }
+            break;
+
+        case Phase::Rally:
+            events |= moveBall();
+            break;
+
+        case Phase::Goal:
+            if (m_state.phaseTicks >= m_rules.goalDelay)
+            {
+                if (hasWon(Left) || hasWon(Right))
+                    setPhase(Phase::Over);
+                else
+                    prepareServe();
+            }
+            break;
+
+        case Phase::Start:
+        case Phase::Over:
+            break;
+    }
+
+    return events;
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+std::uint32_t BasicMatch<RulesPolicy>::getQuietTicks() const
+{
+    // Ticks before the end of a delay
+    const auto getTicksBefore = [this](std::uint32_t delay)
+    { return (m_state.phaseTicks + 1 < delay) ? delay - 1 - m_state.phaseTicks : std::uint32_t{0}; };
+
+    switch (m_state.phase)
+    {
+        case Phase::Serve:
+            return getTicksBefore(m_rules.serveDelay);
+
+        case Phase::Goal:
+            return getTicksBefore(m_rules.goalDelay);
+
+        case Phase::Start:
+        case Phase::Over:
+            return std::numeric_limits<std::uint32_t>::max();
+
+        case Phase::Rally:
+            break;
+    }
+
+    // First tick at which the ball may pass a wall, the front of a paddle or a goal line
+    const std::int64_t size   = m_rules.ballSize * FixedOne;
+    const std::int64_t bottom = m_rules.fieldSize.y * FixedOne - size;
+    const std::int64_t width  = m_rules.fieldSize.x * FixedOne;
+    const std::int64_t x      = m_state.ballPosition.x;
+    const std::int64_t y      = m_state.ballPosition.y;
+    const std::int64_t vx     = m_state.ballVelocity.x;
+    const std::int64_t vy     = m_state.ballVelocity.y;
+    std::int64_t       first  = std::int64_t{std::numeric_limits<std::uint32_t>::max()} + 1;
+    const auto         limit  = [&first](std::int64_t tick) { first = std::min(first, tick); };
+
+    if (vy > 0)
+        limit((bottom - y) / vy + 1);
+    else if (vy < 0)
+        limit(y / -vy + 1);
+
+    if (vx < 0)
+    {
+        const std::int64_t front = (m_rules.paddleInset + m_rules.paddleSize.x) * FixedOne;
+        if (x >= front)
+            limit((x - front) / -vx + 1);
+        limit((x + size) / -vx + 1);
+    }
+    else if (vx > 0)
+    {
+        const std::int64_t front = (m_rules.fieldSize.x - m_rules.paddleInset - m_rules.paddleSize.x) * FixedOne;
+        if (x + size <= front)
+            limit((front - x - size) / vx + 1);
+        limit((width - x) / vx + 1);
+    }
+
+    return static_cast<std::uint32_t>(first - 1);
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+void BasicMatch<RulesPolicy>::advance(const Course& left, const Course& right)
+{
+    assert(left.ticks == right.ticks && "Courses of different lengths");
+    assert(left.ticks <= getQuietTicks() && "Advancing past an event");
+
+    const std::uint32_t ticks = left.ticks;
+    m_state.tick += ticks;
+    m_state.phaseTicks += ticks;
+
+    if ((ticks == 0) || (m_state.phase == Phase::Start) || (m_state.phase == Phase::Over))
+        return;
+
+    const Fixed   lowest     = (m_rules.fieldSize.y - m_rules.paddleSize.y) * FixedOne;
+    const Course* courses[2] = {&left, &right};
+    for (std::size_t side = Left; side <= Right; ++side)
+    {
+        assert(std::abs(std::int64_t{courses[side]->distance}) <= std::int64_t{ticks} * m_rules.paddleSpeed &&
+               "Course too long for the paddle's speed");
+
+        m_state.paddles[side]    = std::clamp(m_state.paddles[side] + courses[side]->distance, 0, lowest);
+        m_state.directions[side] = courses[side]->direction;
+    }
+
+    if (m_state.phase == Phase::Rally)
+        m_state.ballPosition += m_state.ballVelocity * static_cast<int>(ticks);
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+void BasicMatch<RulesPolicy>::reseed(std::uint64_t seed, std::uint64_t matchId)
+{
+    m_state.seed    = seed;
+    m_state.matchId = matchId;
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+const typename BasicMatch<RulesPolicy>::Rules& BasicMatch<RulesPolicy>::getRules() const
+{
+    return m_rules;
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+const MatchDefinitions::State& BasicMatch<RulesPolicy>::getState() const
+{
+    return m_state;
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+sf::FloatRect BasicMatch<RulesPolicy>::getBallBounds() const
+{
+    const auto size = static_cast<float>(m_rules.ballSize);
+    return {{toPixels(m_state.ballPosition.x), toPixels(m_state.ballPosition.y)}, {size, size}};
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+sf::FloatRect BasicMatch<RulesPolicy>::getPaddleBounds(std::size_t side) const
+{
+    assert(side <= Right && "Invalid side");
+
+    const int left = (side == Left) ? m_rules.paddleInset
+                                    : m_rules.fieldSize.x - m_rules.paddleInset - m_rules.paddleSize.x;
+    return {{static_cast<float>(left), toPixels(m_state.paddles[side])}, sf::Vector2f(m_rules.paddleSize)};
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+std::uint32_t BasicMatch<RulesPolicy>::moveBall()
+{
+    const Fixed        size     = m_rules.ballSize * FixedOne;
+    const Fixed        bottom   = m_rules.fieldSize.y * FixedOne - size;
+    const sf::Vector2i previous = m_state.ballPosition;
+    sf::Vector2i&      position = m_state.ballPosition;
+    sf::Vector2i&      velocity = m_state.ballVelocity;
+    std::uint32_t      events   = 0;
+
+    position += velocity;
+
+    // Mirror whatever went past the wall, so that no distance is lost
+    if ((position.y < 0) || (position.y > bottom))
+    {
+        position.y = (position.y < 0) ? -position.y : 2 * bottom - position.y;
+        velocity.y = -velocity.y;
+        events |= WallBounce;
+    }
+
+    if (hitPaddle((velocity.x < 0) ? Left : Right, previous))
+        events |= PaddleHit;
+
+    // The point is over once the ball is entirely out of the field
+    if ((position.x + size < 0) || (position.x > m_rules.fieldSize.x * FixedOne))
+    {
+        const std::size_t scorer = (position.x < 0) ? Right : Left;
+        ++m_state.scores[scorer];
+        m_state.receiver = 1 - scorer;
+
+        events |= Goal;
+        if (hasWon(scorer))
+            events |= Over;
+
+        setPhase(Phase::Goal);
+    }
+
+    return events;
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+bool BasicMatch<RulesPolicy>::hitPaddle(std::size_t side, const sf::Vector2i& previous)
+{
+    const Fixed   size         = m_rules.ballSize * FixedOne;
+    const Fixed   paddleHeight = m_rules.paddleSize.y * FixedOne;
+    sf::Vector2i& position     = m_state.ballPosition;
+    sf::Vector2i& velocity     = m_state.ballVelocity;
+
+    // Front of the paddle, and the edge of the ball facing it before and after the move
+    Fixed front  = 0;
+    Fixed before = 0;
+    Fixed after  = 0;
+    if (side == Left)
+    {
+        front  = (m_rules.paddleInset + m_rules.paddleSize.x) * FixedOne;
+        before = previous.x;
+        after  = position.x;
+        if ((before < front) || (after >= front))
+            return false;
+    }
+    else
+    {
+        front  = (m_rules.fieldSize.x - m_rules.paddleInset - m_rules.paddleSize.x) * FixedOne;
+        before = previous.x + size;
+        after  = position.x + size;
+        if ((before > front) || (after <= front))
+            return false;
+    }
+
+    // Height of the ball when it crossed the front, so that fast balls can't tunnel through
+    const std::int64_t travelled = before - front;
+    const std::int64_t distance  = before - after;
+    const Fixed        crossing  = previous.y + static_cast<Fixed>((position.y - previous.y) * travelled / distance);
+
+    const Fixed top = m_state.paddles[side];
+    if ((crossing + size <= top) || (crossing >= top + paddleHeight))
+        return false;
+
+    position.x = (side == Left) ? 2 * front - position.x : 2 * (front - size) - position.x;
+
+    const Fixed speed = std::min(std::abs(velocity.x) + m_rules.speedUp, m_rules.maxSpeed);
+    velocity.x        = (side == Left) ? speed : -speed;
+
+    // The further from the paddle's center, the steeper the bounce
+    const std::int64_t offset = (crossing + size / 2) - (top + paddleHeight / 2);
+    const std::int64_t reach  = (paddleHeight + size) / 2;
+    velocity.y                = static_cast<Fixed>(offset * m_rules.maxBounce / reach);
+
+    // A moving paddle drags the ball along
+    if (m_rules.spin != 0)
+        velocity.y += m_state.directions[side] * m_rules.spin;
+
+    ++m_state.hits;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+bool BasicMatch<RulesPolicy>::hasWon(std::size_t side) const
+{
+    const unsigned int score = m_state.scores[side];
+    if (score < m_rules.pointsToWin)
+        return false;
+
+    return !m_rules.winByTwo || (score >= m_state.scores[1 - side] + 2);
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+void BasicMatch<RulesPolicy>::prepareServe()
+{
+    m_state.ballPosition.x = (m_rules.fieldSize.x - m_rules.ballSize) * FixedOne / 2;
+    m_state.ballPosition.y = (m_rules.fieldSize.y - m_rules.ballSize) * FixedOne / 2;
+    m_state.ballVelocity   = sf::Vector2i();
+
+    setPhase(Phase::Serve);
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+void BasicMatch<RulesPolicy>::setPhase(Phase phase)
+{
+    m_state.phase      = phase;
+    m_state.phaseTicks = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+std::uint32_t BasicMatch<RulesPolicy>::drawRandom(Draw draw) const
+{
+    return Philox(m_state.seed).generate(m_state.matchId, m_state.tick, static_cast<std::uint32_t>(draw))[0];
+}
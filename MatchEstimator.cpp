@@ -0,0 +1,155 @@
+#include "MatchEstimator.hpp"
+
+#include "TscClock.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Wilson score interval of a proportion, from half points
+// (0, 1 or 2 per trial) so that draws count as half a win
+////////////////////////////////////////////////////////////
+struct Interval
+{
+    float proportion;
+    float low;
+    float high;
+};
+
+Interval getWilsonInterval(std::size_t halfPoints, std::size_t trials, float z)
+{
+    const double n      = static_cast<double>(trials);
+    const double p      = static_cast<double>(halfPoints) / (2.0 * n);
+    const double z2     = static_cast<double>(z) * z;
+    const double scale  = 1.0 / (1.0 + z2 / n);
+    const double center = (p + z2 / (2.0 * n)) * scale;
+    const double half   = z * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) * scale;
+
+    return {static_cast<float>(p),
+            static_cast<float>(std::max(center - half, 0.0)),
+            static_cast<float>(std::min(center + half, 1.0))};
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+MatchEstimator::MatchEstimator(ThreadPool& pool) : MatchEstimator(pool, Settings())
+{
+}
+
+
+////////////////////////////////////////////////////////////
+MatchEstimator::MatchEstimator(ThreadPool& pool, const Settings& settings) : m_pool(pool), m_settings(settings)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+const MatchEstimator::Settings& MatchEstimator::getSettings() const
+{
+    return m_settings;
+}
+
+
+////////////////////////////////////////////////////////////
+bool MatchEstimator::Control::shouldStop() const
+{
+    return stop.load(std::memory_order_relaxed) || (TscClock::now() >= deadline);
+}
+
+
+////////////////////////////////////////////////////////////
+MatchEstimator::Estimate MatchEstimator::run(const std::function<int(std::uint64_t, const Control&)>& play) const
+{
+    const std::uint64_t start = TscClock::now();
+
+    Control control;
+    control.deadline = start + TscClock::toTicks(m_settings.budget);
+
+    // Half points, up to twice the count, must fit in the high 32
+    // bits of the packed prefix: 2 * (2^31 - 1) does, 2 * 2^31 doesn't
+    const std::size_t count = std::min(m_settings.maxContinuations, (std::size_t{1} << 31) - 1);
+
+    const auto hasConverged = [&](std::uint64_t points, std::uint64_t trials)
+    {
+        if (trials < std::max<std::uint64_t>(m_settings.minContinuations, 1))
+            return false;
+
+        const Interval interval = getWilsonInterval(points, trials, m_settings.zScore);
+        return (interval.high - interval.low) / 2.f <= m_settings.targetHalfWidth;
+    };
+
+    // Result of each continuation plus one, 0 while it isn't finished.
+    // Only the finished prefix [0, k) is counted, with k in the low
+    // half of prefix and its half points in the high half, so that
+    // the estimate doesn't depend on which continuations were still
+    // in flight; it stops growing at the first k that converges
+    std::vector<std::atomic<std::uint8_t>> results(count);
+    std::atomic<std::uint64_t>             prefix{0};
+    std::atomic<std::size_t>               next{0};
+
+    m_pool.run(
+        [&](std::size_t /* thread */)
+        {
+            while (!control.stop.load(std::memory_order_relaxed))
+            {
+                const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+                if (index >= count)
+                    break;
+
+                const int result = play(index, control);
+                if (result < 0)
+                    break;
+
+                results[index] = static_cast<std::uint8_t>(result + 1);
+
+                // Extend the prefix over the continuations finished so far; if
+                // another thread extends it meanwhile, start over from its end
+                std::uint64_t packed = prefix;
+                std::uint64_t points = 0;
+                std::uint64_t trials = 0;
+                for (;;)
+                {
+                    points = packed >> 32;
+                    trials = packed & 0xFFFFFFFF;
+
+                    const std::uint64_t before = trials;
+                    while ((trials < count) && !hasConverged(points, trials) && (results[trials] != 0))
+                        points += results[trials++] - 1u;
+
+                    if ((trials == before) || prefix.compare_exchange_weak(packed, (points << 32) | trials))
+                        break;
+                }
+
+                if (hasConverged(points, trials) || (trials == count))
+                    control.stop = true;
+            }
+        });
+
+    const std::uint64_t packed = prefix;
+    const std::uint64_t points = packed >> 32;
+
+    Estimate estimate;
+    estimate.continuations = static_cast<std::size_t>(packed & 0xFFFFFFFF);
+    estimate.elapsed       = TscClock::toTime(TscClock::now() - start);
+    estimate.converged     = hasConverged(points, estimate.continuations);
+
+    if (estimate.continuations > 0)
+    {
+        const Interval interval = getWilsonInterval(points, estimate.continuations, m_settings.zScore);
+        estimate.probability    = interval.proportion;
+        estimate.low            = interval.low;
+        estimate.high           = interval.high;
+    }
+
+    return estimate;
+}
+
+} // namespace pong
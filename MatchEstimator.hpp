@@ -0,0 +1,227 @@
+#pragma once
+
+#include "AimNoise.hpp"
+#include "Match.hpp"
+#include "PaddleAi.hpp"
+#include "ThreadPool.hpp"
+#include "sfml.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Monte Carlo estimate of the outcome of a match
+///
+/// The current state of a match is forked into many
+/// continuations, played to the end in parallel on a
+/// ThreadPool by two computer players. Each continuation gets
+/// its own serve angles, and its players aim at random points
+/// around the ball so that they sometimes miss; otherwise two
+/// computer players would replay the same rally forever. The fraction won by
+/// the left side estimates its probability of winning, with a
+/// Wilson score interval.
+///
+/// Estimation stops as soon as the interval is narrow enough,
+/// when the time budget runs out or after a maximum number of
+/// continuations. Only the first continuations are counted, up
+/// to the first one that isn't finished: those abandoned in
+/// flight and any finished after them are dropped, so that
+/// long continuations aren't under-represented. Continuation i
+/// always plays the same way, so the estimate only depends on
+/// how many are counted: a longer budget only adds
+/// continuations, and an estimate that converges or reaches
+/// the maximum is the same on any number of threads.
+///
+/// Usage example:
+/// \code
+/// pong::ThreadPool     pool;
+/// pong::MatchEstimator estimator(pool);
+///
+/// if (events & pong::Match::Goal)
+/// {
+///     const auto odds = estimator.estimate(match, player, ai);
+///     std::cout << odds.probability << " in [" << odds.low << ", " << odds.high << "]\n";
+/// }
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class MatchEstimator
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Limits and randomization of the estimates
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Settings
+    {
+        sf::Time      budget{sf::milliseconds(5)}; //!< Longest time spent in estimate()
+        float         targetHalfWidth{0.02f};      //!< Half-width of the interval that ends the estimate
+        float         zScore{1.96f};               //!< Half-width of the interval in standard errors, 1.96 for 95%
+        std::size_t   minContinuations{100};       //!< Continuations played before the interval can end the estimate
+        std::size_t   maxContinuations{100000};    //!< Continuations played at most
+        std::uint32_t maxTicks{60 * 60 * 10};      //!< Ticks after which a continuation is scored by the current lead
+        float         aimError{24.f};              //!< Largest distance between the ball and the point aimed at, in pixels
+        std::uint32_t aimTicks{30};                //!< Ticks between changes of the point aimed at
+        std::uint64_t seed{};                      //!< Seed of the continuations
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Estimated outcome of a match
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Estimate
+    {
+        float       probability{0.5f}; //!< Probability that the left side wins; draws at maxTicks count as half
+        float       low{};             //!< Lower bound of the confidence interval
+        float       high{1.f};         //!< Upper bound of the confidence interval
+        std::size_t continuations{};   //!< Number of continuations counted, the first ones
+        sf::Time    elapsed;           //!< Time spent estimating
+        bool        converged{};       //!< Did the interval get narrow enough before the budget ran out?
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create an estimator with the default settings
+    ///
+    /// \param pool Threads to play the continuations on
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit MatchEstimator(ThreadPool& pool);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create an estimator
+    ///
+    /// \param pool     Threads to play the continuations on
+    /// \param settings Limits and randomization of the estimates
+    ///
+    ////////////////////////////////////////////////////////////
+    MatchEstimator(ThreadPool& pool, const Settings& settings);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Estimate the probability that the left side wins
+    ///
+    /// A match on its title screen is started first; the
+    /// continuations of a match that is over end immediately,
+    /// with its result.
+    ///
+    /// \param match Match to fork, with any rules
+    /// \param left  Player of the left paddle in the continuations
+    /// \param right Player of the right paddle in the continuations
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename RulesPolicy>
+    Estimate estimate(const BasicMatch<RulesPolicy>& match, const PaddleAi& left, const PaddleAi& right) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the limits and randomization of the estimates
+    ///
+    ////////////////////////////////////////////////////////////
+    const Settings& getSettings() const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Shared stop condition of the continuations
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Control
+    {
+        std::atomic<bool> stop{};     //!< Set once the estimate is complete
+        std::uint64_t     deadline{}; //!< End of the budget, in TscClock ticks
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Tell whether the estimate is complete or out of time
+        ///
+        ////////////////////////////////////////////////////////////
+        bool shouldStop() const;
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Play one continuation of a match
+    ///
+    /// \param index Index of the continuation, its Philox stream
+    ///
+    /// \return Half points won by the left side (0, 1 or 2), or -1 if abandoned
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename RulesPolicy>
+    static int play(BasicMatch<RulesPolicy> match,
+                    const PaddleAi&         left,
+                    const PaddleAi&         right,
+                    const Settings&         settings,
+                    std::uint64_t           index,
+                    const Control&          control);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Play continuations on every thread until the estimate is complete
+    ///
+    /// \param play Plays continuation i, as MatchEstimator::play
+    ///
+    ////////////////////////////////////////////////////////////
+    Estimate run(const std::function<int(std::uint64_t, const Control&)>& play) const;
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    ThreadPool& m_pool;     //!< Threads to play the continuations on
+    Settings    m_settings; //!< Limits and randomization of the estimates
+};
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+MatchEstimator::Estimate MatchEstimator::estimate(const BasicMatch<RulesPolicy>& match,
+                                                  const PaddleAi&                left,
+                                                  const PaddleAi&                right) const
+{
+    return run([&](std::uint64_t index, const Control& control)
+               { return play(match, left, right, m_settings, index, control); });
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+int MatchEstimator::play(BasicMatch<RulesPolicy> match,
+                         const PaddleAi&         left,
+                         const PaddleAi&         right,
+                         const Settings&         settings,
+                         std::uint64_t           index,
+                         const Control&          control)
+{
+    // Each continuation is a separate stream of the estimator's seed
+    match.reseed(settings.seed, index);
+    if (match.getState().phase == MatchDefinitions::Phase::Start)
+        match.start();
+
+    constexpr std::size_t leftSide  = MatchDefinitions::Left;
+    constexpr std::size_t rightSide = MatchDefinitions::Right;
+
+    AimNoise noise(settings.aimError, settings.aimTicks, settings.seed, index);
+
+    std::uint32_t tick  = 0;
+    std::uint32_t check = 0;
+    while ((tick < settings.maxTicks) && (match.getState().phase != MatchDefinitions::Phase::Over))
+    {
+        if (tick >= check)
+        {
+            if (control.shouldStop())
+                return -1;
+
+            check = tick + 1024;
+        }
+
+        tick += playNoisyTicks(match, left, right, noise, settings.maxTicks - tick);
+    }
+
+    // Matches that didn't end go to whoever leads
+    const unsigned int* scores = match.getState().scores;
+    if (scores[leftSide] == scores[rightSide])
+        return 1;
+
+    return (scores[leftSide] > scores[rightSide]) ? 2 : 0;
+}
+
+} // namespace pong
@@ -0,0 +1,146 @@
+#include "MatchRenderer.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// 3x5 block font: rows from top to bottom, 3 bits each, the
+// leftmost column in the highest bit
+////////////////////////////////////////////////////////////
+constexpr int glyphWidth  = 3;
+constexpr int glyphHeight = 5;
+
+// clang-format off
+constexpr std::uint16_t digitGlyphs[] = {
+    0b111'101'101'101'111, // 0
+    0b010'110'010'010'111, // 1
+    0b111'001'111'100'111, // 2
+    0b111'001'111'001'111, // 3
+    0b101'101'111'001'001, // 4
+    0b111'100'111'001'111, // 5
+    0b111'100'111'101'111, // 6
+    0b111'001'001'001'001, // 7
+    0b111'101'111'101'111, // 8
+    0b111'101'111'001'111  // 9
+};
+// clang-format on
+
+
+////////////////////////////////////////////////////////////
+std::uint16_t getGlyph(char character)
+{
+    // clang-format off
+    switch (character)
+    {
+        case 'G': return 0b111'100'101'101'111;
+        case 'N': return 0b110'101'101'101'101;
+        case 'O': return digitGlyphs[0];
+        case 'P': return 0b111'101'111'100'100;
+        default:  break;
+    }
+    // clang-format on
+
+    return ((character >= '0') && (character <= '9')) ? digitGlyphs[character - '0'] : 0;
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+void MatchRenderer::record(RenderCommandBuffer& frame, const Match& match)
+{
+    const Match::State& state     = match.getState();
+    const auto          fieldSize = sf::Vector2f(match.getRules().fieldSize);
+
+    // Field: dashed net, paddles and ball
+    m_vertices.clear();
+
+    if (state.phase != Match::Phase::Start)
+    {
+        for (float y = 2.f; y < fieldSize.y; y += 12.f)
+            addRect({{fieldSize.x / 2.f - 1.f, y}, {2.f, 6.f}});
+    }
+
+    addRect(match.getPaddleBounds(Match::Left));
+    addRect(match.getPaddleBounds(Match::Right));
+
+    if ((state.phase == Match::Phase::Serve) || (state.phase == Match::Phase::Rally))
+        addRect(match.getBallBounds());
+
+    frame.draw(m_vertices.data(), m_vertices.size(), sf::PrimitiveType::Triangles);
+
+    // HUD: the title, or the scores
+    m_vertices.clear();
+
+    if (state.phase == Match::Phase::Start)
+    {
+        constexpr float scale = 8.f;
+        const float     width = (4 * (glyphWidth + 1) - 1) * scale;
+        addText("PONG", {(fieldSize.x - width) / 2.f, fieldSize.y / 4.f}, scale);
+    }
+    else
+    {
+        constexpr float scale = 4.f;
+        for (std::size_t side = Match::Left; side <= Match::Right; ++side)
+        {
+            const std::string score = std::to_string(state.scores[side]);
+            const float       width = (static_cast<float>(score.size()) * (glyphWidth + 1) - 1) * scale;
+            const float       x     = fieldSize.x * ((side == Match::Left) ? 0.25f : 0.75f) - width / 2.f;
+            addText(score.c_str(), {x, 16.f}, scale);
+        }
+    }
+
+    const int layer = frame.getLayer();
+    frame.setLayer(RenderCommandBuffer::HudLayer);
+    frame.draw(m_vertices.data(), m_vertices.size(), sf::PrimitiveType::Triangles);
+    frame.setLayer(layer);
+}
+
+
+////////////////////////////////////////////////////////////
+void MatchRenderer::addRect(const sf::FloatRect& rect)
+{
+    const sf::Vector2f topLeft(rect.left, rect.top);
+    const sf::Vector2f topRight(rect.left + rect.width, rect.top);
+    const sf::Vector2f bottomLeft(rect.left, rect.top + rect.height);
+    const sf::Vector2f bottomRight(rect.left + rect.width, rect.top + rect.height);
+
+    m_vertices.emplace_back(topLeft);
+    m_vertices.emplace_back(topRight);
+    m_vertices.emplace_back(bottomLeft);
+    m_vertices.emplace_back(bottomLeft);
+    m_vertices.emplace_back(topRight);
+    m_vertices.emplace_back(bottomRight);
+}
+
+
+////////////////////////////////////////////////////////////
+void MatchRenderer::addText(const char* text, const sf::Vector2f& position, float scale)
+{
+    const std::size_t length = std::strlen(text);
+
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        const std::uint16_t glyph = getGlyph(text[i]);
+        const float         left  = position.x + static_cast<float>(i * (glyphWidth + 1)) * scale;
+
+        for (int row = 0; row < glyphHeight; ++row)
+        {
+            for (int column = 0; column < glyphWidth; ++column)
+            {
+                const int bit = (glyphHeight - 1 - row) * glyphWidth + (glyphWidth - 1 - column);
+                if (glyph & (1 << bit))
+                    addRect({{left + static_cast<float>(column) * scale, position.y + static_cast<float>(row) * scale},
+                             {scale, scale}});
+            }
+        }
+    }
+}
+
+} // namespace pong
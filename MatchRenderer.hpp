@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Match.hpp"
+#include "RenderCommandBuffer.hpp"
+#include "sfml.h"
+
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Records the field, paddles, ball and scores of a match
+///
+/// Everything is drawn with untextured quads: the scores and
+/// the title use a built-in 3x5 block font. This keeps the
+/// renderer usable with any backend, including headless ones
+/// that can't create SFML textures, and makes its output
+/// exactly reproducible.
+///
+/// The field goes to layer 0 and the text to the HUD layer,
+/// one draw each.
+///
+/// Usage example:
+/// \code
+/// frame.clear();
+/// renderer.record(frame, match);
+/// frame.sort();
+/// frame.replay(backend);
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class MatchRenderer
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Record a match in its current state
+    ///
+    /// \param frame Command buffer to record into
+    /// \param match Match to draw
+    ///
+    ////////////////////////////////////////////////////////////
+    void record(RenderCommandBuffer& frame, const Match& match);
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a rectangle to the scratch vertices
+    ///
+    ////////////////////////////////////////////////////////////
+    void addRect(const sf::FloatRect& rect);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a line of text to the scratch vertices
+    ///
+    /// \param text     Characters among 0-9, G, N, O, P and space
+    /// \param position Top-left corner of the text, in pixels
+    /// \param scale    Size of a block of the font, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    void addText(const char* text, const sf::Vector2f& position, float scale);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<sf::Vertex> m_vertices; //!< Vertices of the draw being built
+};
+
+} // namespace pong
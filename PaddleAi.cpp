@@ -0,0 +1,42 @@
+#include "PaddleAi.hpp"
+
+#include <algorithm>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+pong::MatchDefinitions::Fixed toFixed(float value)
+{
+    return static_cast<pong::MatchDefinitions::Fixed>(value * pong::MatchDefinitions::FixedOne);
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+PaddleAi::PaddleAi() : PaddleAi(Parameters())
+{
+}
+
+
+////////////////////////////////////////////////////////////
+PaddleAi::PaddleAi(const Parameters& parameters) :
+m_parameters(parameters),
+m_deadZone(toFixed(parameters.deadZone)),
+m_reactionDelay(toFixed(std::max(parameters.reactionDelay, 0.f))),
+m_aimBias(toFixed(parameters.aimBias)),
+m_speed(toFixed(std::clamp(parameters.speed, 0.f, 1.f)))
+{
+}
+
+
+////////////////////////////////////////////////////////////
+const PaddleAi::Parameters& PaddleAi::getParameters() const
+{
+    return m_parameters;
+}
+
+} // namespace pong
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "Match.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Computer player steering a paddle toward the ball
+///
+/// The paddle follows the ball's center, and stops when it is
+/// within the dead zone so that it doesn't jitter around it.
+/// Its parameters can make it weaker: it may react to where
+/// the ball was a few ticks ago, aim off the ball's center or
+/// move during only some of the ticks.
+/// It plays both the computer's side of a match and both sides
+/// of the attract-mode demo.
+///
+/// Usage example:
+/// \code
+/// const pong::PaddleAi ai;
+/// match.step(playerDirection, ai.decide(match, pong::Match::Right));
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class PaddleAi
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Behavior of the player
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Parameters
+    {
+        float deadZone{2.f};      //!< Largest offset from the ball left alone, in pixels
+        float reactionDelay{0.f}; //!< Age of the ball position the player reacts to, in ticks
+        float aimBias{0.f};       //!< Offset of the point aimed at from the ball's center, in pixels, down if positive
+        float speed{1.f};         //!< Fraction of the ticks during which the paddle may move, in (0, 1]
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a player with the default parameters
+    ///
+    ////////////////////////////////////////////////////////////
+    PaddleAi();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a player
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit PaddleAi(const Parameters& parameters);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Choose the direction of a paddle for the next tick
+    ///
+    /// \param match Match being played, with any rules
+    /// \param side  Side of the paddle, Match::Left or Match::Right
+    /// \param aim   Offset of the point aimed at from the ball's center,
+    ///              in fixed pixels, to model an imprecise player
+    ///
+    /// \return -1 to move up, 1 to move down, 0 to stay
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename RulesPolicy>
+    int decide(const BasicMatch<RulesPolicy>& match, std::size_t side, MatchDefinitions::Fixed aim = 0) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Plan the moves of a paddle over the next quiet ticks
+    ///
+    /// Computes in closed form where decide() would take the
+    /// paddle, tick after tick, while the ball flies straight and
+    /// the aim doesn't change, for BasicMatch::advance(). The plan
+    /// always covers exactly \a ticks ticks: stretches that can't
+    /// be computed in closed form, e.g. when the paddle reaches the
+    /// end of the field or when a slower paddle moves, are planned
+    /// tick by tick, which only costs time.
+    ///
+    /// \param match Match being played, with any rules
+    /// \param side  Side of the paddle, Match::Left or Match::Right
+    /// \param ticks Number of ticks to cover, at most match.getQuietTicks()
+    /// \param aim   Offset of the point aimed at, as in decide()
+    ///
+    /// \return Moves of the paddle over the \a ticks ticks
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename RulesPolicy>
+    MatchDefinitions::Course plan(const BasicMatch<RulesPolicy>& match,
+                                  std::size_t                    side,
+                                  std::uint32_t                  ticks,
+                                  MatchDefinitions::Fixed        aim = 0) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the parameters of the player
+    ///
+    ////////////////////////////////////////////////////////////
+    const Parameters& getParameters() const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    Parameters              m_parameters;    //!< Behavior of the player
+    MatchDefinitions::Fixed m_deadZone;      //!< Dead zone, in fixed pixels
+    MatchDefinitions::Fixed m_reactionDelay; //!< Reaction delay, in fixed ticks
+    MatchDefinitions::Fixed m_aimBias;       //!< Aim bias, in fixed pixels
+    MatchDefinitions::Fixed m_speed;         //!< Fraction of the ticks with moves, in fixed point
+};
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+int PaddleAi::decide(const BasicMatch<RulesPolicy>& match, std::size_t side, MatchDefinitions::Fixed aim) const
+{
+    // Compare the centers in fixed point, which is exact and keeps
+    // the rules' constants foldable in specialized matches
+    constexpr MatchDefinitions::Fixed one = MatchDefinitions::FixedOne;
+
+    const MatchDefinitions::State& state = match.getState();
+
+    // A slower paddle moves during floor(speed * n) of the first n ticks
+    if (m_speed < one)
+    {
+        const std::uint64_t tick = state.tick;
+        if (((tick + 1) * m_speed >> MatchDefinitions::FixedShift) == (tick * m_speed >> MatchDefinitions::FixedShift))
+            return 0;
+    }
+
+    // Where the ball was, ignoring bounces, reactionDelay ticks ago
+    const auto&                   rules  = match.getRules();
+    const MatchDefinitions::Fixed ballY  = state.ballPosition.y - state.ballVelocity.y * m_reactionDelay / one;
+    const MatchDefinitions::Fixed offset = (ballY + rules.ballSize * one / 2 + m_aimBias + aim) -
+                                           (state.paddles[side] + rules.paddleSize.y * one / 2);
+
+    return (offset > m_deadZone) - (offset < -m_deadZone);
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+MatchDefinitions::Course PaddleAi::plan(const BasicMatch<RulesPolicy>& match,
+                                        std::size_t                    side,
+                                        std::uint32_t                  ticks,
+                                        MatchDefinitions::Fixed        aim) const
+{
+    constexpr MatchDefinitions::Fixed one = MatchDefinitions::FixedOne;
+
+    const MatchDefinitions::State& state = match.getState();
+    const auto&                    rules = match.getRules();
+
+    // Same offset as in decide(), which then changes by the ball's
+    // move minus the paddle's at each tick
+    const std::int64_t speed    = rules.paddleSpeed;
+    const std::int64_t lowest   = (rules.fieldSize.y - rules.paddleSize.y) * one;
+    const std::int64_t deadZone = m_deadZone;
+    const std::int64_t rate     = (state.phase == MatchDefinitions::Phase::Rally) ? state.ballVelocity.y : 0;
+    const std::int64_t start    = state.paddles[side];
+    const std::int64_t ballY    = state.ballPosition.y - state.ballVelocity.y * m_reactionDelay / one;
+    std::int64_t       paddle   = start;
+    std::int64_t       offset   = (ballY + rules.ballSize * one / 2 + m_aimBias + aim) -
+                            (paddle + rules.paddleSize.y * one / 2);
+
+    // Division rounding up, by a positive number
+    const auto divideUp = [](std::int64_t a, std::int64_t b) { return (a >= 0) ? (a + b - 1) / b : -(-a / b); };
+
+    MatchDefinitions::Course course;
+    while (course.ticks < ticks)
+    {
+        const std::int64_t remaining = ticks - course.ticks;
+        const int          direction = (offset > deadZone) - (offset < -deadZone);
+
+        // Following a ball slower than the paddle: the paddle moves in the
+        // ball's direction whenever the ball leaves the dead zone, never
+        // overshooting, so the offset stays within one move of its edge
+        // and the number of moves after t ticks is known in closed form
+        const std::int64_t sign      = (rate > 0) - (rate < 0);
+        const std::int64_t ballMove  = sign * rate;
+        const std::int64_t normal    = sign * offset;
+        const std::int64_t threshold = deadZone + ballMove;
+        if ((m_speed >= one) && (deadZone >= 0) && (ballMove > 0) && (ballMove <= speed) &&
+            (2 * deadZone + ballMove >= speed - 1) && (normal > threshold - speed) && (normal <= threshold))
+        {
+            const std::int64_t room  = (sign > 0) ? lowest - paddle : paddle;
+            const std::int64_t bound = ((room / speed) * speed + threshold - normal) / ballMove;
+            if (bound > 0)
+            {
+                const std::int64_t length = std::min(remaining, bound);
+                const std::int64_t moves  = divideUp(normal + length * ballMove - threshold, speed);
+                const std::int64_t before = divideUp(normal + (length - 1) * ballMove - threshold, speed);
+
+                paddle += sign * moves * speed;
+                offset += length * rate - sign * moves * speed;
+                course.ticks += static_cast<std::uint32_t>(length);
+                course.direction = static_cast<int>(sign * (moves - before));
+                continue;
+            }
+        }
+
+        // A slower paddle moves during some ticks only, a move cut short by the
+        // end of the field has a speed of its own, and a negative dead zone has
+        // no stable position: these are planned one tick at a time
+        const std::int64_t target = std::clamp(paddle + direction * speed, std::int64_t{0}, lowest);
+        const std::int64_t move   = target - paddle;
+        if ((deadZone < 0) || ((direction != 0) && ((m_speed < one) || ((move != 0) && (move != direction * speed)))))
+        {
+            const std::uint64_t tick  = state.tick + course.ticks;
+            const bool          gated = (m_speed < one) && (((tick + 1) * m_speed >> MatchDefinitions::FixedShift) ==
+                                                   (tick * m_speed >> MatchDefinitions::FixedShift));
+            const int           moved = gated ? 0 : direction;
+            const std::int64_t  next  = std::clamp(paddle + moved * speed, std::int64_t{0}, lowest);
+
+            offset += rate - (next - paddle);
+            paddle = next;
+            course.ticks += 1;
+            course.direction = moved;
+            continue;
+        }
+
+        // Otherwise the decision holds, and the paddle moves at a constant
+        // speed (possibly 0) until the offset enters or leaves the dead zone
+        const std::int64_t change = rate - move;
+        std::int64_t       length = remaining;
+        if ((direction > 0) && (change < 0))
+            length = std::min(length, divideUp(offset - deadZone, -change));
+        else if ((direction < 0) && (change > 0))
+            length = std::min(length, divideUp(-deadZone - offset, change));
+        else if ((direction == 0) && (change > 0))
+            length = std::min(length, (deadZone - offset) / change + 1);
+        else if ((direction == 0) && (change < 0))
+            length = std::min(length, (offset + deadZone) / -change + 1);
+
+        // Full moves only, up to the end of the field
+        if (move != 0)
+            length = std::min(length, ((direction > 0) ? lowest - paddle : paddle) / speed);
+
+        paddle += length * move;
+        offset += length * change;
+        course.ticks += static_cast<std::uint32_t>(length);
+        course.direction = direction;
+    }
+
+    course.distance = static_cast<MatchDefinitions::Fixed>(paddle - start);
+    return course;
+}
+
+} // namespace pong
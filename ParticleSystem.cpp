@@ -0,0 +1,145 @@
+#include "ParticleSystem.hpp"
+
+#include "VectorKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Fraction of its speed a particle loses per second
+constexpr float drag = 1.5f;
+
+// Half the size of a particle, in pixels
+constexpr float halfSize = 1.f;
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+ParticleSystem::ParticleSystem(std::uint64_t seed) : m_random(seed)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::burst(const sf::Vector2f& position, std::size_t count, const sf::Color& color, float speed, sf::Time lifetime)
+{
+    const std::size_t total = m_positions.size() + count;
+    m_positions.reserve(total);
+    m_velocities.reserve(total);
+    m_ages.reserve(total);
+    m_agingRates.reserve(total);
+    m_colors.reserve(total);
+
+    const float longest = std::max(lifetime.asSeconds(), 0.001f);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const float angle = nextUnit() * 6.2831853f;
+        const float norm  = speed * (0.2f + 0.8f * nextUnit());
+
+        m_positions.push_back(position);
+        m_velocities.emplace_back(std::cos(angle) * norm, std::sin(angle) * norm);
+        m_ages.push_back(0.f);
+        m_agingRates.push_back(1.f / (longest * (0.5f + 0.5f * nextUnit())));
+        m_colors.push_back(color);
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::update(sf::Time elapsed)
+{
+    const float seconds = elapsed.asSeconds();
+    const float damping = std::max(1.f - drag * seconds, 0.f);
+
+    vectors::multiplyAdd(m_velocities.data(), seconds, m_positions.data(), m_positions.data(), m_positions.size());
+    vectors::scale(m_velocities.data(), damping, m_velocities.data(), m_velocities.size());
+
+    for (std::size_t i = 0; i < m_ages.size(); ++i)
+        m_ages[i] += m_agingRates[i] * seconds;
+
+    // Replace each dead particle by the last one
+    std::size_t i = 0;
+    while (i < m_ages.size())
+    {
+        if (m_ages[i] < 1.f)
+        {
+            ++i;
+            continue;
+        }
+
+        m_positions[i]  = m_positions.back();
+        m_velocities[i] = m_velocities.back();
+        m_ages[i]       = m_ages.back();
+        m_agingRates[i] = m_agingRates.back();
+        m_colors[i]     = m_colors.back();
+
+        m_positions.pop_back();
+        m_velocities.pop_back();
+        m_ages.pop_back();
+        m_agingRates.pop_back();
+        m_colors.pop_back();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::record(RenderCommandBuffer& frame)
+{
+    m_vertices.resize(m_positions.size() * 6);
+
+    for (std::size_t i = 0; i < m_positions.size(); ++i)
+    {
+        sf::Color color = m_colors[i];
+        color.a         = static_cast<std::uint8_t>(static_cast<float>(color.a) * (1.f - m_ages[i]));
+
+        const sf::Vector2f& center = m_positions[i];
+        sf::Vertex*         quad   = &m_vertices[i * 6];
+        quad[0]                    = sf::Vertex({center.x - halfSize, center.y - halfSize}, color);
+        quad[1]                    = sf::Vertex({center.x + halfSize, center.y - halfSize}, color);
+        quad[2]                    = sf::Vertex({center.x - halfSize, center.y + halfSize}, color);
+        quad[3]                    = quad[2];
+        quad[4]                    = quad[1];
+        quad[5]                    = sf::Vertex({center.x + halfSize, center.y + halfSize}, color);
+    }
+
+    frame.draw(m_vertices.data(), m_vertices.size(), sf::PrimitiveType::Triangles, sf::RenderStates(sf::BlendAdd));
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t ParticleSystem::getCount() const
+{
+    return m_positions.size();
+}
+
+
+////////////////////////////////////////////////////////////
+void ParticleSystem::clear()
+{
+    m_positions.clear();
+    m_velocities.clear();
+    m_ages.clear();
+    m_agingRates.clear();
+    m_colors.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+float ParticleSystem::nextUnit()
+{
+    // SplitMix64, keeping the 24 bits a float can represent exactly
+    std::uint64_t value = (m_random += 0x9E3779B97F4A7C15);
+    value               = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value               = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    value ^= value >> 31;
+    return static_cast<float>(value >> 40) / 16777216.f;
+}
+
+} // namespace pong
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "RenderCommandBuffer.hpp"
+#include "sfml.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Bursts of short-lived square particles
+///
+/// Particles are stored as parallel arrays rather than an array
+/// of structures, so that update() streams through tightly
+/// packed positions and velocities. Dead particles are replaced
+/// by the last one, so the arrays stay dense.
+///
+/// Particles fly in straight lines, slowed down by drag, and
+/// fade out over their lifetime. They are drawn as 2x2 quads
+/// with additive blending, in a single draw.
+///
+/// Randomness comes from the seed only, so a sequence of
+/// bursts and updates always gives the same particles.
+///
+/// Usage example:
+/// \code
+/// if (events & pong::Match::Goal)
+///     particles.burst(center, 512, sf::Color::White);
+///
+/// particles.update(sf::seconds(1.f / 60.f));
+/// particles.record(frame);
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class ParticleSystem
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct an empty system
+    ///
+    /// \param seed Seed of the particles' directions, speeds and lifetimes
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit ParticleSystem(std::uint64_t seed = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Emit particles from a point in random directions
+    ///
+    /// \param position Point to emit from, in pixels
+    /// \param count    Number of particles to emit
+    /// \param color    Color of the particles when they are emitted
+    /// \param speed    Highest initial speed, in pixels per second
+    /// \param lifetime Longest lifetime; each particle lives between half of it and all of it
+    ///
+    ////////////////////////////////////////////////////////////
+    void burst(const sf::Vector2f& position,
+               std::size_t         count,
+               const sf::Color&    color,
+               float               speed    = 120.f,
+               sf::Time            lifetime = sf::seconds(1.f));
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Move and age the particles, removing the dead ones
+    ///
+    /// \param elapsed Time since the last update
+    ///
+    ////////////////////////////////////////////////////////////
+    void update(sf::Time elapsed);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record the particles into a command buffer
+    ///
+    /// \param frame Command buffer to record into, at its current layer
+    ///
+    ////////////////////////////////////////////////////////////
+    void record(RenderCommandBuffer& frame);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of living particles
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove every particle
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw a random number in [0, 1)
+    ///
+    ////////////////////////////////////////////////////////////
+    float nextUnit();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<sf::Vector2f> m_positions;  //!< Center of each particle, in pixels
+    std::vector<sf::Vector2f> m_velocities; //!< Velocity of each particle, in pixels per second
+    std::vector<float>        m_ages;       //!< Age of each particle, as a fraction of its lifetime
+    std::vector<float>        m_agingRates; //!< Inverse of each particle's lifetime, in 1/s
+    std::vector<sf::Color>    m_colors;     //!< Initial color of each particle
+    std::vector<sf::Vertex>   m_vertices;   //!< Vertices of the last recorded draw
+    std::uint64_t             m_random;     //!< State of the random number generator
+};
+
+} // namespace pong
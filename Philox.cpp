@@ -0,0 +1,244 @@
+#include "Philox.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define PONG_PHILOX_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(PONG_PHILOX_SSE2) && defined(__AVX2__)
+#define PONG_PHILOX_AVX2
+#include <immintrin.h>
+#endif
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Multipliers and key increments (Weyl sequence) of
+// Philox4x32, and its number of rounds
+////////////////////////////////////////////////////////////
+constexpr std::uint32_t multiplier0 = 0xD2511F53;
+constexpr std::uint32_t multiplier1 = 0xCD9E8D57;
+constexpr std::uint32_t increment0  = 0x9E3779B9;
+constexpr std::uint32_t increment1  = 0xBB67AE85;
+constexpr int           rounds      = 10;
+
+
+////////////////////////////////////////////////////////////
+// One block, one round after the other
+////////////////////////////////////////////////////////////
+pong::Philox::Block generateBlock(const std::uint32_t (&key)[2], pong::Philox::Block counter)
+{
+    std::uint32_t k0 = key[0];
+    std::uint32_t k1 = key[1];
+
+    for (int round = 0; round < rounds; ++round)
+    {
+        const std::uint64_t product0 = std::uint64_t{multiplier0} * counter[0];
+        const std::uint64_t product1 = std::uint64_t{multiplier1} * counter[2];
+
+        counter = {static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ k0,
+                   static_cast<std::uint32_t>(product1),
+                   static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ k1,
+                   static_cast<std::uint32_t>(product0)};
+
+        k0 += increment0;
+        k1 += increment1;
+    }
+
+    return counter;
+}
+
+
+#if defined(PONG_PHILOX_AVX2)
+////////////////////////////////////////////////////////////
+// 8 blocks at once, word j of each block in lane i of words[j]
+////////////////////////////////////////////////////////////
+constexpr std::size_t laneCount = 8;
+
+using Lanes = __m256i;
+
+Lanes broadcast(std::uint32_t value)
+{
+    return _mm256_set1_epi32(static_cast<int>(value));
+}
+
+Lanes makeTicks(std::uint32_t first, std::uint32_t step)
+{
+    const Lanes indices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    return _mm256_add_epi32(broadcast(first), _mm256_mullo_epi32(indices, broadcast(step)));
+}
+
+Lanes bitwiseXor(const Lanes& a, const Lanes& b)
+{
+    return _mm256_xor_si256(a, b);
+}
+
+// Low and high words of the 64-bit products of each lane by a constant
+void multiply(const Lanes& value, const Lanes& multiplier, Lanes& low, Lanes& high)
+{
+    const Lanes even = _mm256_shuffle_epi32(_mm256_mul_epu32(value, multiplier), 0xD8);
+    const Lanes odd  = _mm256_shuffle_epi32(_mm256_mul_epu32(_mm256_srli_epi64(value, 32), multiplier), 0xD8);
+    low              = _mm256_unpacklo_epi32(even, odd);
+    high             = _mm256_unpackhi_epi32(even, odd);
+}
+
+void store(std::uint32_t* destination, const Lanes& value)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), value);
+}
+
+#elif defined(PONG_PHILOX_SSE2)
+////////////////////////////////////////////////////////////
+// 4 blocks at once, word j of each block in lane i of words[j]
+////////////////////////////////////////////////////////////
+constexpr std::size_t laneCount = 4;
+
+using Lanes = __m128i;
+
+Lanes broadcast(std::uint32_t value)
+{
+    return _mm_set1_epi32(static_cast<int>(value));
+}
+
+Lanes makeTicks(std::uint32_t first, std::uint32_t step)
+{
+    // SSE2 has no 32-bit multiply, but the offsets are small
+    return _mm_add_epi32(broadcast(first),
+                         _mm_setr_epi32(0,
+                                        static_cast<int>(step),
+                                        static_cast<int>(step * 2),
+                                        static_cast<int>(step * 3)));
+}
+
+Lanes bitwiseXor(const Lanes& a, const Lanes& b)
+{
+    return _mm_xor_si128(a, b);
+}
+
+// Low and high words of the 64-bit products of each lane by a constant
+void multiply(const Lanes& value, const Lanes& multiplier, Lanes& low, Lanes& high)
+{
+    const Lanes even = _mm_shuffle_epi32(_mm_mul_epu32(value, multiplier), 0xD8);
+    const Lanes odd  = _mm_shuffle_epi32(_mm_mul_epu32(_mm_srli_epi64(value, 32), multiplier), 0xD8);
+    low              = _mm_unpacklo_epi32(even, odd);
+    high             = _mm_unpackhi_epi32(even, odd);
+}
+
+void store(std::uint32_t* destination, const Lanes& value)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), value);
+}
+
+#endif
+
+
+#if defined(PONG_PHILOX_SSE2)
+////////////////////////////////////////////////////////////
+// laneCount blocks of consecutive ticks, as generateBlock()
+// computes them
+////////////////////////////////////////////////////////////
+void generateLanes(const std::uint32_t (&key)[2],
+                   std::uint64_t         stream,
+                   std::uint32_t         firstTick,
+                   std::uint32_t         tickStep,
+                   std::uint32_t         draw,
+                   pong::Philox::Block*  blocks)
+{
+    const Lanes multipliers[2] = {broadcast(multiplier0), broadcast(multiplier1)};
+
+    Lanes words[4] = {makeTicks(firstTick, tickStep),
+                      broadcast(draw),
+                      broadcast(static_cast<std::uint32_t>(stream)),
+                      broadcast(static_cast<std::uint32_t>(stream >> 32))};
+
+    std::uint32_t k0 = key[0];
+    std::uint32_t k1 = key[1];
+
+    for (int round = 0; round < rounds; ++round)
+    {
+        Lanes low0;
+        Lanes high0;
+        Lanes low1;
+        Lanes high1;
+        multiply(words[0], multipliers[0], low0, high0);
+        multiply(words[2], multipliers[1], low1, high1);
+
+        words[0] = bitwiseXor(bitwiseXor(high1, words[1]), broadcast(k0));
+        words[1] = low1;
+        words[2] = bitwiseXor(bitwiseXor(high0, words[3]), broadcast(k1));
+        words[3] = low0;
+
+        k0 += increment0;
+        k1 += increment1;
+    }
+
+    // Transpose the lanes into blocks
+    std::uint32_t values[4][laneCount];
+    for (std::size_t word = 0; word < 4; ++word)
+        store(values[word], words[word]);
+
+    for (std::size_t lane = 0; lane < laneCount; ++lane)
+        blocks[lane] = {values[0][lane], values[1][lane], values[2][lane], values[3][lane]};
+}
+#endif
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+Philox::Philox() : Philox(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+Philox::Philox(std::uint64_t seed) : m_key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)}
+{
+}
+
+
+////////////////////////////////////////////////////////////
+Philox::Block Philox::generate(std::uint64_t stream, std::uint32_t tick, std::uint32_t draw) const
+{
+    return generateBlock(m_key,
+                         {tick, draw, static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)});
+}
+
+
+////////////////////////////////////////////////////////////
+void Philox::generate(std::uint64_t stream,
+                      std::uint32_t firstTick,
+                      std::uint32_t tickStep,
+                      std::uint32_t draw,
+                      Block*        blocks,
+                      std::size_t   count) const
+{
+    std::size_t   index = 0;
+    std::uint32_t tick  = firstTick;
+
+#if defined(PONG_PHILOX_SSE2)
+    for (; index + laneCount <= count; index += laneCount)
+    {
+        generateLanes(m_key, stream, tick, tickStep, draw, blocks + index);
+        tick += tickStep * static_cast<std::uint32_t>(laneCount);
+    }
+#endif
+
+    for (; index < count; ++index)
+    {
+        blocks[index] = generate(stream, tick, draw);
+        tick += tickStep;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint64_t Philox::getSeed() const
+{
+    return (std::uint64_t{m_key[1]} << 32) | m_key[0];
+}
+
+} // namespace pong
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Counter-based random number generator, Philox4x32-10
+///
+/// A counter-based generator has no state to advance: each
+/// block of four random words is a keyed bijection of its
+/// counter. The key is the seed, and the counter holds the
+/// coordinates of the draw: a stream (e.g. the index of a
+/// match in a batch), a tick and the purpose of the draw. A
+/// number therefore doesn't depend on how many were drawn
+/// before it, in which order or on which thread: batches give
+/// the same results on any number of threads, and a match can
+/// be replayed or forked from any tick.
+///
+/// Blocks of consecutive counters are computed 4 at a time
+/// with SSE2, or 8 with AVX2 when the build enables it, and
+/// match the blocks computed one by one.
+///
+/// Usage example:
+/// \code
+/// const pong::Philox philox(seed);
+///
+/// // Same numbers whichever thread plays match i, and whenever
+/// const pong::Philox::Block block = philox.generate(i, tick, purpose);
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class Philox
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Four random words, the output for one counter
+    ///
+    ////////////////////////////////////////////////////////////
+    using Block = std::array<std::uint32_t, 4>;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a generator with a seed of 0
+    ///
+    ////////////////////////////////////////////////////////////
+    Philox();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create a generator
+    ///
+    /// \param seed Key of the generator
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit Philox(std::uint64_t seed);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Generate the block of a counter
+    ///
+    /// \param stream Independent stream, e.g. the index of a match
+    /// \param tick   Tick of the draw
+    /// \param draw   Purpose of the draw, so that draws of a tick differ
+    ///
+    /// \return Four random words
+    ///
+    ////////////////////////////////////////////////////////////
+    Block generate(std::uint64_t stream, std::uint32_t tick, std::uint32_t draw) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Generate the blocks of evenly spaced ticks at once
+    ///
+    /// Block i is generate(stream, firstTick + i * tickStep, draw);
+    /// ticks wrap around after 2^32.
+    ///
+    /// \param stream    Independent stream, e.g. the index of a match
+    /// \param firstTick Tick of the first block
+    /// \param tickStep  Ticks between two blocks
+    /// \param draw      Purpose of the draws
+    /// \param blocks    Array of \a count blocks to fill
+    /// \param count     Number of blocks
+    ///
+    ////////////////////////////////////////////////////////////
+    void generate(std::uint64_t stream,
+                  std::uint32_t firstTick,
+                  std::uint32_t tickStep,
+                  std::uint32_t draw,
+                  Block*        blocks,
+                  std::size_t   count) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the key of the generator
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint64_t getSeed() const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::uint32_t m_key[2]; //!< Low and high words of the seed
+};
+
+} // namespace pong
@@ -0,0 +1,281 @@
+#include "PowerManager.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Longest sleep between two event polls in Attract, well
+// under a frame at 60 Hz
+const sf::Time attractSlice = sf::milliseconds(4);
+
+
+////////////////////////////////////////////////////////////
+// CPU time used by every thread of the process so far.
+// std::clock() would be wall-clock time on Windows
+////////////////////////////////////////////////////////////
+sf::Time getProcessCpuTime()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+        return sf::Time::Zero;
+
+    // In 100 ns units
+    const auto toMicroseconds = [](const FILETIME& time)
+    { return ((static_cast<std::int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10; };
+    return sf::microseconds(toMicroseconds(kernel) + toMicroseconds(user));
+#else
+    timespec time{};
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time) != 0)
+        return sf::Time::Zero;
+
+    return sf::microseconds(static_cast<std::int64_t>(time.tv_sec) * 1000000 + time.tv_nsec / 1000);
+#endif
+}
+
+
+////////////////////////////////////////////////////////////
+bool isInput(const sf::Event& event)
+{
+    switch (event.type)
+    {
+        case sf::Event::KeyPressed:
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::JoystickButtonPressed:
+        case sf::Event::TouchBegan:
+        case sf::Event::GainedFocus:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+float PowerManager::Usage::getCpuLoad() const
+{
+    return (wallTime > sf::Time::Zero) ? cpuTime.asSeconds() / wallTime.asSeconds() : 0.f;
+}
+
+
+////////////////////////////////////////////////////////////
+PowerManager::PowerManager(sf::WindowBase& window) :
+m_window(window),
+m_focused(window.hasFocus()),
+m_attractDelay(TscClock::toTicks(sf::seconds(30.f))),
+m_attractPeriod(TscClock::toTicks(sf::seconds(1.f / 20.f))),
+m_lastInput(TscClock::now()),
+m_stateStart(m_lastInput),
+m_stateCpuStart(getProcessCpuTime())
+{
+}
+
+
+////////////////////////////////////////////////////////////
+bool PowerManager::pollEvent(sf::Event& event)
+{
+    for (;;)
+    {
+        updateState();
+
+        if (m_window.pollEvent(event))
+        {
+            handleEvent(event);
+            return true;
+        }
+
+        switch (m_state)
+        {
+            case State::Active:
+                countFrame();
+                return false;
+
+            case State::Paused:
+            case State::Unfocused:
+                // Show the new state once, then wait for something to happen
+                if (!m_redraw && m_window.waitEvent(event))
+                {
+                    handleEvent(event);
+                    return true;
+                }
+
+                countFrame();
+                return false;
+
+            case State::Attract:
+            default:
+            {
+                const std::uint64_t now = TscClock::now();
+                if (now >= m_nextFrame)
+                {
+                    // Late frames don't pile up: the next one is at most a period away
+                    const bool late = now - m_nextFrame >= m_attractPeriod;
+                    m_nextFrame     = (late ? now : m_nextFrame) + m_attractPeriod;
+                    countFrame();
+                    return false;
+                }
+
+                const sf::Time remaining = std::min(TscClock::toTime(m_nextFrame - now), attractSlice);
+                std::this_thread::sleep_for(std::chrono::microseconds(remaining.asMicroseconds()));
+                break;
+            }
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void PowerManager::setPaused(bool paused)
+{
+    m_paused    = paused;
+    m_lastInput = TscClock::now();
+    updateState();
+}
+
+
+////////////////////////////////////////////////////////////
+bool PowerManager::isPaused() const
+{
+    return m_paused;
+}
+
+
+////////////////////////////////////////////////////////////
+void PowerManager::setAttractEnabled(bool enabled)
+{
+    if (enabled && !m_attractEnabled)
+        m_lastInput = TscClock::now();
+
+    m_attractEnabled = enabled;
+    updateState();
+}
+
+
+////////////////////////////////////////////////////////////
+void PowerManager::setAttractDelay(sf::Time delay)
+{
+    m_attractDelay = TscClock::toTicks(delay);
+}
+
+
+////////////////////////////////////////////////////////////
+void PowerManager::setAttractPeriod(sf::Time period)
+{
+    m_attractPeriod = TscClock::toTicks(period);
+}
+
+
+////////////////////////////////////////////////////////////
+PowerManager::State PowerManager::getState() const
+{
+    return m_state;
+}
+
+
+////////////////////////////////////////////////////////////
+PowerManager::Usage PowerManager::getUsage(State state) const
+{
+    Usage usage = m_usage[static_cast<std::size_t>(state)];
+
+    // Add the time spent in the current state so far
+    if (state == m_state)
+    {
+        usage.wallTime += TscClock::toTime(TscClock::now() - m_stateStart);
+        usage.cpuTime += getProcessCpuTime() - m_stateCpuStart;
+    }
+
+    return usage;
+}
+
+
+////////////////////////////////////////////////////////////
+const char* PowerManager::getName(State state)
+{
+    switch (state)
+    {
+        case State::Active:
+            return "active";
+        case State::Paused:
+            return "paused";
+        case State::Unfocused:
+            return "unfocused";
+        case State::Attract:
+            return "attract";
+        default:
+            return "unknown";
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void PowerManager::handleEvent(const sf::Event& event)
+{
+    if (event.type == sf::Event::LostFocus)
+        m_focused = false;
+    else if (event.type == sf::Event::GainedFocus)
+        m_focused = true;
+
+    if (isInput(event))
+        m_lastInput = TscClock::now();
+
+    // Whatever happened may have to be shown
+    m_redraw = true;
+    updateState();
+}
+
+
+////////////////////////////////////////////////////////////
+void PowerManager::updateState()
+{
+    const std::uint64_t now = TscClock::now();
+
+    State state = State::Active;
+    if (!m_focused)
+        state = State::Unfocused;
+    else if (m_paused)
+        state = State::Paused;
+    else if (m_attractEnabled && (now - m_lastInput >= m_attractDelay))
+        state = State::Attract;
+
+    if (state == m_state)
+        return;
+
+    const sf::Time cpuTime = getProcessCpuTime();
+    Usage&         usage   = m_usage[static_cast<std::size_t>(m_state)];
+    usage.wallTime += TscClock::toTime(now - m_stateStart);
+    usage.cpuTime += cpuTime - m_stateCpuStart;
+
+    m_state         = state;
+    m_stateStart    = now;
+    m_stateCpuStart = cpuTime;
+    m_nextFrame     = now;
+    m_redraw        = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void PowerManager::countFrame()
+{
+    ++m_usage[static_cast<std::size_t>(m_state)].frames;
+    m_redraw = false;
+}
+
+} // namespace pong
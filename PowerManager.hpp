@@ -0,0 +1,200 @@
+#pragma once
+
+#include "TscClock.hpp"
+#include "sfml.h"
+
+#include <cstddef>
+#include <cstdint>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Lowers the frame rate when there is nothing to animate
+///
+/// Replaces the window's pollEvent() in the game loop: events
+/// are returned one by one, and false means that a frame is
+/// due. How long that takes depends on the state:
+/// \li Active: right away, as with pollEvent()
+/// \li Paused or Unfocused: nothing moves, so after one frame
+///     showing the new state, the loop blocks in waitEvent()
+///     and draws a single frame after each event
+/// \li Attract: the demo is drawn at a low rate; between frames
+///     the thread sleeps in short slices, polling events
+///
+/// The window is Unfocused while it doesn't have the focus,
+/// Paused while setPaused(true) is in effect, and goes to
+/// Attract after a delay without input (key, button or touch)
+/// unless setAttractEnabled(false) is in effect.
+/// Any input while in Attract returns to Active before the
+/// next frame: blocking waits wake up on the event itself, and
+/// the attract-mode sleeps are shorter than an active frame.
+///
+/// The wall-clock time, process CPU time and frames spent in
+/// each state are measured, to check what the idle states
+/// save. CPU time includes every thread of the process, such
+/// as a render thread.
+///
+/// Usage example:
+/// \code
+/// pong::PowerManager power(window);
+/// while (window.isOpen())
+/// {
+///     sf::Event event;
+///     while (power.pollEvent(event))
+///         handle(event);
+///
+///     if (power.getState() == pong::PowerManager::State::Attract)
+///         // step the demo...
+///     // draw...
+/// }
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class PowerManager
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief How much animating the game does
+    ///
+    ////////////////////////////////////////////////////////////
+    enum class State
+    {
+        Active,    //!< Playing, frames are drawn at full rate
+        Paused,    //!< Paused by the player, frames are only drawn after events
+        Unfocused, //!< The window lost the focus, frames are only drawn after events
+        Attract,   //!< Nobody is playing, the demo is drawn at a low rate
+        Count      //!< Keep last -- the number of states
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Resources spent in a state
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Usage
+    {
+        sf::Time    wallTime; //!< Time spent in the state
+        sf::Time    cpuTime;  //!< CPU time used by the process in the state
+        std::size_t frames{}; //!< Number of frames drawn in the state
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Get the CPU time per unit of wall-clock time
+        ///
+        /// \return Number of cores kept busy on average, 0 if no time was spent in the state
+        ///
+        ////////////////////////////////////////////////////////////
+        float getCpuLoad() const;
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the manager, in the Active state
+    ///
+    /// \param window Window to take the events of
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit PowerManager(sf::WindowBase& window);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the next event, or wait until a frame is due
+    ///
+    /// \param event Event to fill
+    ///
+    /// \return True if an event was returned, false if a frame is due
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool pollEvent(sf::Event& event);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Pause or resume
+    ///
+    ////////////////////////////////////////////////////////////
+    void setPaused(bool paused);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the game is paused
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isPaused() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Allow or forbid Attract, e.g. while a match is played
+    ///
+    /// Once allowed again, the delay without input starts over.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAttractEnabled(bool enabled);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the time without input before entering Attract
+    ///
+    /// The default is 30 seconds.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAttractDelay(sf::Time delay);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the time between two frames in Attract
+    ///
+    /// The default is 1/20 s.
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAttractPeriod(sf::Time period);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the current state
+    ///
+    ////////////////////////////////////////////////////////////
+    State getState() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the resources spent in a state so far
+    ///
+    ////////////////////////////////////////////////////////////
+    Usage getUsage(State state) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the name of a state, for reports
+    ///
+    ////////////////////////////////////////////////////////////
+    static const char* getName(State state);
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Update the state with an event
+    ///
+    ////////////////////////////////////////////////////////////
+    void handleEvent(const sf::Event& event);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Enter the state the flags call for, if it changed
+    ///
+    ////////////////////////////////////////////////////////////
+    void updateState();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Count a frame drawn in the current state
+    ///
+    ////////////////////////////////////////////////////////////
+    void countFrame();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    static constexpr std::size_t StateCount{static_cast<std::size_t>(State::Count)}; // NOLINT(readability-identifier-naming)
+
+    sf::WindowBase& m_window;               //!< Window the events come from
+    State           m_state{State::Active}; //!< Current state
+    bool            m_paused{};             //!< Was the game paused with setPaused()?
+    bool            m_focused;              //!< Does the window have the focus?
+    bool            m_redraw{true};         //!< Is a frame needed to show a change in an idle state?
+    bool            m_attractEnabled{true}; //!< Can the game enter Attract?
+    std::uint64_t   m_attractDelay;         //!< Time without input before Attract, in TscClock ticks
+    std::uint64_t   m_attractPeriod;        //!< Time between two Attract frames, in TscClock ticks
+    std::uint64_t   m_lastInput;            //!< Time of the last input, in TscClock ticks
+    std::uint64_t   m_nextFrame{};          //!< Time the next Attract frame is due, in TscClock ticks
+    std::uint64_t   m_stateStart;           //!< Time the current state was entered, in TscClock ticks
+    sf::Time        m_stateCpuStart;        //!< Process CPU time when the current state was entered
+    Usage           m_usage[StateCount];    //!< Resources spent in each state, up to m_stateStart
+};
+
+} // namespace pong
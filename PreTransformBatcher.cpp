@@ -0,0 +1,359 @@
+#include "PreTransformBatcher.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define PONG_PRETRANSFORM_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// sf::RenderTarget::StatesCache::VertexCacheSize, which is private
+constexpr std::size_t renderTargetVertexCacheSize = 4;
+
+// Upper bound for the threshold, whatever the calibration says
+constexpr std::size_t maxThreshold = 4096;
+
+// Number of vertices reserved at once in the backend's vertex stream
+constexpr std::size_t streamChunkSize = 4096;
+
+
+////////////////////////////////////////////////////////////
+// Transform the positions of count vertices, copying the
+// other attributes; in and out may be the same array.
+////////////////////////////////////////////////////////////
+void transformVertices(const sf::Transform& transform, const sf::Vertex* in, sf::Vertex* out, std::size_t count)
+{
+    std::size_t i = 0;
+
+#ifdef PONG_PRETRANSFORM_SSE2
+    // Two positions per register: [x0 y0 x1 y1]
+    const float*  m    = transform.getMatrix();
+    const __m128  col0 = _mm_setr_ps(m[0], m[1], m[0], m[1]);
+    const __m128  col1 = _mm_setr_ps(m[4], m[5], m[4], m[5]);
+    const __m128  col3 = _mm_setr_ps(m[12], m[13], m[12], m[13]);
+
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128 positions = _mm_setzero_ps();
+        positions        = _mm_loadl_pi(positions, reinterpret_cast<const __m64*>(&in[i].position));
+        positions        = _mm_loadh_pi(positions, reinterpret_cast<const __m64*>(&in[i + 1].position));
+
+        const __m128 xs     = _mm_shuffle_ps(positions, positions, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128 ys     = _mm_shuffle_ps(positions, positions, _MM_SHUFFLE(3, 3, 1, 1));
+        const __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xs, col0), _mm_mul_ps(ys, col1)), col3);
+
+        out[i]     = in[i];
+        out[i + 1] = in[i + 1];
+        _mm_storel_pi(reinterpret_cast<__m64*>(&out[i].position), result);
+        _mm_storeh_pi(reinterpret_cast<__m64*>(&out[i + 1].position), result);
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        const sf::Vector2f position = transform.transformPoint(in[i].position);
+        out[i]                      = in[i];
+        out[i].position             = position;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+// Primitive type that a batch of the given type is merged into
+////////////////////////////////////////////////////////////
+sf::PrimitiveType getListType(sf::PrimitiveType type)
+{
+    switch (type)
+    {
+        case sf::PrimitiveType::Points:
+            return sf::PrimitiveType::Points;
+
+        case sf::PrimitiveType::Lines:
+        case sf::PrimitiveType::LineStrip:
+            return sf::PrimitiveType::Lines;
+
+        case sf::PrimitiveType::Triangles:
+        case sf::PrimitiveType::TriangleStrip:
+        case sf::PrimitiveType::TriangleFan:
+            break;
+    }
+
+    return sf::PrimitiveType::Triangles;
+}
+
+
+////////////////////////////////////////////////////////////
+// Number of vertices a primitive becomes once converted to a list
+////////////////////////////////////////////////////////////
+std::size_t getListVertexCount(std::size_t vertexCount, sf::PrimitiveType type)
+{
+    switch (type)
+    {
+        case sf::PrimitiveType::TriangleStrip:
+        case sf::PrimitiveType::TriangleFan:
+            return (vertexCount >= 3) ? (vertexCount - 2) * 3 : 0;
+
+        case sf::PrimitiveType::LineStrip:
+            return (vertexCount >= 2) ? (vertexCount - 1) * 2 : 0;
+
+        default:
+            return vertexCount;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+// Write a strip or fan as a list; out must have room for
+// getListVertexCount vertices and is only written to.
+////////////////////////////////////////////////////////////
+void writeAsList(sf::Vertex* out, const sf::Vertex* vertices, std::size_t vertexCount, sf::PrimitiveType type)
+{
+    switch (type)
+    {
+        case sf::PrimitiveType::TriangleStrip:
+            for (std::size_t i = 2; i < vertexCount; ++i)
+            {
+                *out++ = vertices[i - 2];
+                *out++ = vertices[i - 1];
+                *out++ = vertices[i];
+            }
+            break;
+
+        case sf::PrimitiveType::TriangleFan:
+            for (std::size_t i = 2; i < vertexCount; ++i)
+            {
+                *out++ = vertices[0];
+                *out++ = vertices[i - 1];
+                *out++ = vertices[i];
+            }
+            break;
+
+        case sf::PrimitiveType::LineStrip:
+            for (std::size_t i = 1; i < vertexCount; ++i)
+            {
+                *out++ = vertices[i - 1];
+                *out++ = vertices[i];
+            }
+            break;
+
+        default:
+            std::copy(vertices, vertices + vertexCount, out);
+            break;
+    }
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+void PreTransformBatcher::setThreshold(std::size_t vertexCount)
+{
+    m_threshold = vertexCount;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t PreTransformBatcher::getThreshold() const
+{
+    return m_threshold;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t PreTransformBatcher::calibrate(RenderBackend& backend)
+{
+    constexpr std::size_t drawCount   = 512;
+    constexpr std::size_t vertexCount = 12; // Big enough to bypass the render target's own vertex cache
+    constexpr std::size_t cpuChunks   = 32; // 128k vertices, long enough for the clock's resolution
+    constexpr int         passes      = 3;
+
+    // Degenerate triangles: the driver does all the per-draw work but nothing gets rasterized
+    const std::vector<sf::Vertex> vertices(vertexCount);
+    const std::vector<sf::Vertex> cpuSource(streamChunkSize);
+    std::vector<sf::Vertex>       cpuBuffer(streamChunkSize);
+    const sf::Transform           rotation(0.866f, -0.5f, 10.f, 0.5f, 0.866f, 20.f, 0.f, 0.f, 1.f);
+    float                         checksum = 0.f;
+
+    float drawSeconds   = 1.f;
+    float vertexSeconds = 1.f;
+
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        // Cost of a draw call that has to upload a new matrix
+        sf::Clock clock;
+        for (std::size_t i = 0; i < drawCount; ++i)
+        {
+            sf::Transform transform;
+            transform.translate({static_cast<float>(i % 2), 0.f});
+            backend.draw(vertices.data(), vertexCount, sf::PrimitiveType::Triangles, sf::RenderStates(transform));
+        }
+        drawSeconds = std::min(drawSeconds, clock.restart().asSeconds() / drawCount);
+
+        // Cost of transforming a vertex on the CPU and writing it where batches are built,
+        // the backend's stream if it has one
+        for (std::size_t chunk = 0; chunk < cpuChunks; ++chunk)
+        {
+            if (sf::Vertex* stream = backend.reserve(streamChunkSize))
+            {
+                transformVertices(rotation, cpuSource.data(), stream, streamChunkSize);
+                backend.drawReserved(0, sf::PrimitiveType::Triangles, sf::RenderStates::Default);
+            }
+            else
+            {
+                transformVertices(rotation, cpuSource.data(), cpuBuffer.data(), streamChunkSize);
+                checksum += cpuBuffer[chunk].position.x;
+            }
+        }
+        vertexSeconds = std::min(vertexSeconds, clock.restart().asSeconds() / (cpuChunks * streamChunkSize));
+    }
+
+    backend.clear();
+
+    // Keeps the local transforms from being optimized away
+    volatile float sink = checksum;
+    static_cast<void>(sink);
+
+    const float breakEven = (vertexSeconds > 0.f) ? drawSeconds / vertexSeconds : static_cast<float>(maxThreshold);
+    m_threshold = std::clamp(static_cast<std::size_t>(breakEven), renderTargetVertexCacheSize, maxThreshold);
+
+    return m_threshold;
+}
+
+
+////////////////////////////////////////////////////////////
+void PreTransformBatcher::draw(RenderBackend&          backend,
+                               const sf::Vertex*       vertices,
+                               std::size_t             vertexCount,
+                               sf::PrimitiveType       type,
+                               const sf::RenderStates& states)
+{
+    ++m_statistics.draws;
+
+    if (vertexCount > m_threshold)
+    {
+        // Too big to be worth it: keep the draw order and let the backend handle it
+        flush(backend);
+        backend.draw(vertices, vertexCount, type, states);
+        ++m_statistics.drawCalls;
+        return;
+    }
+
+    const sf::PrimitiveType listType = getListType(type);
+
+    const bool compatible = (m_batchSize > 0) && (m_batchType == listType) &&
+                            (m_batchStates.texture == states.texture) && (m_batchStates.shader == states.shader) &&
+                            (m_batchStates.blendMode == states.blendMode);
+
+    if (!compatible)
+    {
+        flush(backend);
+        m_batchType   = listType;
+        m_batchStates = sf::RenderStates(states.blendMode, sf::Transform::Identity, states.texture, states.shader);
+    }
+
+    // Drop incomplete primitives, they would corrupt the ones merged after them
+    if (type == sf::PrimitiveType::Triangles)
+        vertexCount -= vertexCount % 3;
+    else if (type == sf::PrimitiveType::Lines)
+        vertexCount -= vertexCount % 2;
+
+    const std::size_t listCount = getListVertexCount(vertexCount, type);
+    if (listCount == 0)
+        return;
+
+    sf::Vertex* out = allocate(backend, listCount);
+
+    if (type == listType)
+    {
+        // Lists are transformed straight into the batch
+        transformVertices(states.transform, vertices, out, vertexCount);
+    }
+    else
+    {
+        // The batch may live in write-combined memory: expand from a cached copy
+        m_scratch.resize(vertexCount);
+        transformVertices(states.transform, vertices, m_scratch.data(), vertexCount);
+        writeAsList(out, m_scratch.data(), vertexCount, type);
+    }
+
+    m_statistics.verticesTransformed += vertexCount;
+}
+
+
+////////////////////////////////////////////////////////////
+void PreTransformBatcher::flush(RenderBackend& backend)
+{
+    if (m_stream)
+    {
+        // Always hand the reservation back, even if it ended up unused
+        backend.drawReserved(m_batchSize, m_batchType, m_batchStates);
+        m_stream = nullptr;
+    }
+    else if (m_batchSize > 0)
+    {
+        backend.draw(m_vertices.data(), m_batchSize, m_batchType, m_batchStates);
+    }
+
+    if (m_batchSize > 0)
+        ++m_statistics.drawCalls;
+
+    m_vertices.clear();
+    m_batchSize = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Vertex* PreTransformBatcher::allocate(RenderBackend& backend, std::size_t vertexCount)
+{
+    if (m_stream && (m_batchSize + vertexCount > m_streamCapacity))
+    {
+        // The reserved chunk is full: draw it and continue the batch in a new one
+        const sf::PrimitiveType type   = m_batchType;
+        const sf::RenderStates  states = m_batchStates;
+        flush(backend);
+        m_batchType   = type;
+        m_batchStates = states;
+    }
+
+    if (!m_stream && (m_batchSize == 0))
+    {
+        m_streamCapacity = std::max(vertexCount, streamChunkSize);
+        m_stream         = backend.reserve(m_streamCapacity);
+    }
+
+    sf::Vertex* out = nullptr;
+    if (m_stream)
+    {
+        out = m_stream + m_batchSize;
+    }
+    else
+    {
+        m_vertices.resize(m_batchSize + vertexCount);
+        out = &m_vertices[m_batchSize];
+    }
+
+    m_batchSize += vertexCount;
+    return out;
+}
+
+
+////////////////////////////////////////////////////////////
+const PreTransformBatcher::Statistics& PreTransformBatcher::getStatistics() const
+{
+    return m_statistics;
+}
+
+
+////////////////////////////////////////////////////////////
+void PreTransformBatcher::resetStatistics()
+{
+    m_statistics = Statistics();
+}
+
+} // namespace pong
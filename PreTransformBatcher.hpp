@@ -0,0 +1,143 @@
+#pragma once
+
+#include "RenderBackend.hpp"
+#include "sfml.h"
+
+#include <cstddef>
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Merges small draws by transforming their vertices on the CPU
+///
+/// sf::RenderTarget pre-transforms draws of up to
+/// StatesCache::VertexCacheSize (4) vertices; anything bigger
+/// costs a matrix upload and its own draw call. This batcher
+/// extends that idea to a larger threshold: draws of at most
+/// getThreshold() vertices are transformed with SIMD into a
+/// streaming vertex array and consecutive draws sharing the
+/// same texture, shader and blend mode are submitted as a
+/// single identity-transformed draw call. Strips and fans are
+/// converted to lists so that they can be merged as well.
+///
+/// When the backend exposes a vertex stream (see
+/// RenderBackend::reserve), batches are transformed straight
+/// into it; otherwise they are built in a local array.
+///
+/// The right threshold depends on how expensive a transform
+/// change is on the current driver compared to transforming a
+/// vertex on the CPU; calibrate() measures both at startup.
+///
+////////////////////////////////////////////////////////////
+class PreTransformBatcher
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Counters accumulated since the last call to resetStatistics
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Statistics
+    {
+        std::size_t draws{};               //!< Number of draws received
+        std::size_t drawCalls{};           //!< Number of draw calls issued to the backend
+        std::size_t verticesTransformed{}; //!< Number of vertices transformed on the CPU
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the largest draw, in vertices, that gets pre-transformed
+    ///
+    /// \param vertexCount Threshold; 0 disables batching entirely
+    ///
+    ////////////////////////////////////////////////////////////
+    void setThreshold(std::size_t vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the largest draw, in vertices, that gets pre-transformed
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getThreshold() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Choose the threshold with a short microbenchmark
+    ///
+    /// Measures the cost of a draw that changes the transform
+    /// against one that doesn't, and the cost of transforming a
+    /// vertex on the CPU and writing it where batches are built
+    /// (the backend's stream, or a local array); the threshold
+    /// is the vertex count at which both paths cost the same.
+    /// The target is drawn to and cleared, so call it before
+    /// rendering the first frame.
+    ///
+    /// \param backend Backend the batcher will draw with
+    ///
+    /// \return The chosen threshold
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t calibrate(RenderBackend& backend);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives, batching them if they are small enough
+    ///
+    /// Batched primitives are only guaranteed to be drawn after
+    /// the next call to flush().
+    ///
+    /// \param backend     Backend to draw with
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(RenderBackend&          backend,
+              const sf::Vertex*       vertices,
+              std::size_t             vertexCount,
+              sf::PrimitiveType       type,
+              const sf::RenderStates& states);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the pending batch, if any
+    ///
+    /// \param backend Backend to draw with
+    ///
+    ////////////////////////////////////////////////////////////
+    void flush(RenderBackend& backend);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the counters
+    ///
+    ////////////////////////////////////////////////////////////
+    const Statistics& getStatistics() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset the counters to zero
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetStatistics();
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Get room for vertices at the end of the pending batch
+    ///
+    /// The returned memory may be write-combined: it must only
+    /// be written to.
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Vertex* allocate(RenderBackend& backend, std::size_t vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::size_t             m_threshold{64};    //!< Largest draw that gets pre-transformed
+    std::vector<sf::Vertex> m_vertices;         //!< Pending batch, when the backend has no vertex stream
+    sf::Vertex*             m_stream{};         //!< Pending batch reserved in the backend's vertex stream, if any
+    std::size_t             m_streamCapacity{}; //!< Number of vertices reserved at m_stream
+    std::size_t             m_batchSize{};      //!< Number of vertices in the pending batch
+    std::vector<sf::Vertex> m_scratch;          //!< Transformed strip or fan before conversion to a list
+    sf::PrimitiveType       m_batchType{};      //!< Primitive type of the pending batch
+    sf::RenderStates        m_batchStates;      //!< States of the pending batch, with an identity transform
+    Statistics              m_statistics;       //!< Counters
+};
+
+} // namespace pong
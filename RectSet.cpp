@@ -0,0 +1,298 @@
+#include "RectSet.hpp"
+
+#include <cassert>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define PONG_RECTSET_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(PONG_RECTSET_SSE2) && defined(__AVX2__)
+#define PONG_RECTSET_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Number of rectangles tested at once, and granularity of the
+// padding; one AVX register, or two SSE ones
+constexpr std::size_t blockSize = 8;
+
+// Bounds of padding and empty rectangles, which fail every test
+constexpr float emptyMin = std::numeric_limits<float>::infinity();
+constexpr float emptyMax = -std::numeric_limits<float>::infinity();
+
+
+////////////////////////////////////////////////////////////
+// Bounds of a rectangle, as sf::FloatRect::findIntersection
+// computes them; empty rectangles get the empty bounds
+////////////////////////////////////////////////////////////
+struct Bounds
+{
+    float left;
+    float top;
+    float right;
+    float bottom;
+};
+
+
+////////////////////////////////////////////////////////////
+Bounds getBounds(const sf::FloatRect& rect)
+{
+    const float right  = rect.left + rect.width;
+    const float bottom = rect.top + rect.height;
+
+    const Bounds bounds{(rect.left < right) ? rect.left : right,
+                        (rect.top < bottom) ? rect.top : bottom,
+                        (rect.left < right) ? right : rect.left,
+                        (rect.top < bottom) ? bottom : rect.top};
+
+    // Also catches NaNs
+    if ((bounds.left < bounds.right) && (bounds.top < bounds.bottom))
+        return bounds;
+
+    return {emptyMin, emptyMin, emptyMax, emptyMax};
+}
+
+
+////////////////////////////////////////////////////////////
+// Index of the lowest set bit of a non-zero mask
+////////////////////////////////////////////////////////////
+unsigned int lowestBit(std::uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned int>(index);
+#else
+    return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+}
+
+
+////////////////////////////////////////////////////////////
+// A box tested against blocks of rectangles, one bit per
+// rectangle in the resulting masks. Intersections are strict
+// on both sides; containment (a point as an empty box) is
+// inclusive on the left and top edges, like contains().
+////////////////////////////////////////////////////////////
+class Query
+{
+public:
+    Query(float left, float top, float right, float bottom) :
+#if defined(PONG_RECTSET_AVX2)
+    m_left(_mm256_set1_ps(left)),
+    m_top(_mm256_set1_ps(top)),
+    m_right(_mm256_set1_ps(right)),
+    m_bottom(_mm256_set1_ps(bottom))
+#elif defined(PONG_RECTSET_SSE2)
+    m_left(_mm_set1_ps(left)),
+    m_top(_mm_set1_ps(top)),
+    m_right(_mm_set1_ps(right)),
+    m_bottom(_mm_set1_ps(bottom))
+#else
+    m_left(left),
+    m_top(top),
+    m_right(right),
+    m_bottom(bottom)
+#endif
+    {
+    }
+
+    template <bool Inclusive>
+    std::uint32_t test(const float* lefts, const float* tops, const float* rights, const float* bottoms) const
+    {
+#if defined(PONG_RECTSET_AVX2)
+        constexpr int lowerCompare = Inclusive ? _CMP_LE_OQ : _CMP_LT_OQ;
+
+        const __m256 x = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(lefts), m_right, lowerCompare),
+                                       _mm256_cmp_ps(m_left, _mm256_loadu_ps(rights), _CMP_LT_OQ));
+        const __m256 y = _mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(tops), m_bottom, lowerCompare),
+                                       _mm256_cmp_ps(m_top, _mm256_loadu_ps(bottoms), _CMP_LT_OQ));
+        return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_and_ps(x, y)));
+#elif defined(PONG_RECTSET_SSE2)
+        std::uint32_t mask = 0;
+        for (std::size_t half = 0; half < blockSize; half += 4)
+        {
+            const __m128 lower = Inclusive ? _mm_cmple_ps(_mm_loadu_ps(lefts + half), m_right)
+                                           : _mm_cmplt_ps(_mm_loadu_ps(lefts + half), m_right);
+            const __m128 upper = Inclusive ? _mm_cmple_ps(_mm_loadu_ps(tops + half), m_bottom)
+                                           : _mm_cmplt_ps(_mm_loadu_ps(tops + half), m_bottom);
+            const __m128 x     = _mm_and_ps(lower, _mm_cmplt_ps(m_left, _mm_loadu_ps(rights + half)));
+            const __m128 y     = _mm_and_ps(upper, _mm_cmplt_ps(m_top, _mm_loadu_ps(bottoms + half)));
+            mask |= static_cast<std::uint32_t>(_mm_movemask_ps(_mm_and_ps(x, y))) << half;
+        }
+        return mask;
+#else
+        std::uint32_t mask = 0;
+        for (std::size_t i = 0; i < blockSize; ++i)
+        {
+            const bool x = (Inclusive ? (lefts[i] <= m_right) : (lefts[i] < m_right)) && (m_left < rights[i]);
+            const bool y = (Inclusive ? (tops[i] <= m_bottom) : (tops[i] < m_bottom)) && (m_top < bottoms[i]);
+            mask |= static_cast<std::uint32_t>(x && y) << i;
+        }
+        return mask;
+#endif
+    }
+
+private:
+#if defined(PONG_RECTSET_AVX2)
+    __m256 m_left, m_top, m_right, m_bottom;
+#elif defined(PONG_RECTSET_SSE2)
+    __m128 m_left, m_top, m_right, m_bottom;
+#else
+    float m_left, m_top, m_right, m_bottom;
+#endif
+};
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+RectSet::Index RectSet::add(const sf::FloatRect& rect)
+{
+    if (m_count == m_lefts.size())
+    {
+        const std::size_t size = m_count + blockSize;
+        m_lefts.resize(size, emptyMin);
+        m_tops.resize(size, emptyMin);
+        m_rights.resize(size, emptyMax);
+        m_bottoms.resize(size, emptyMax);
+    }
+
+    const auto index = static_cast<Index>(m_count++);
+    set(index, rect);
+    return index;
+}
+
+
+////////////////////////////////////////////////////////////
+void RectSet::set(Index index, const sf::FloatRect& rect)
+{
+    assert(index < m_count);
+
+    const Bounds bounds = getBounds(rect);
+    m_lefts[index]   = bounds.left;
+    m_tops[index]    = bounds.top;
+    m_rights[index]  = bounds.right;
+    m_bottoms[index] = bounds.bottom;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t RectSet::getCount() const
+{
+    return m_count;
+}
+
+
+////////////////////////////////////////////////////////////
+void RectSet::clear()
+{
+    m_lefts.clear();
+    m_tops.clear();
+    m_rights.clear();
+    m_bottoms.clear();
+    m_count = 0;
+}
+
+
+////////////////////////////////////////////////////////////
+void RectSet::findContaining(const sf::Vector2f& point, std::vector<Index>& result) const
+{
+    result.clear();
+
+    const Query query(point.x, point.y, point.x, point.y);
+
+    for (std::size_t block = 0; block < m_lefts.size(); block += blockSize)
+    {
+        std::uint32_t mask = query.test<true>(&m_lefts[block], &m_tops[block], &m_rights[block], &m_bottoms[block]);
+        for (; mask != 0; mask &= mask - 1)
+            result.push_back(static_cast<Index>(block + lowestBit(mask)));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RectSet::findIntersecting(const sf::FloatRect& rect, std::vector<Index>& result) const
+{
+    result.clear();
+
+    const Bounds bounds = getBounds(rect);
+    const Query  query(bounds.left, bounds.top, bounds.right, bounds.bottom);
+
+    for (std::size_t block = 0; block < m_lefts.size(); block += blockSize)
+    {
+        std::uint32_t mask = query.test<false>(&m_lefts[block], &m_tops[block], &m_rights[block], &m_bottoms[block]);
+        for (; mask != 0; mask &= mask - 1)
+            result.push_back(static_cast<Index>(block + lowestBit(mask)));
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RectSet::findIntersections(const RectSet& other, std::vector<Pair>& result) const
+{
+    result.clear();
+
+    for (std::size_t i = 0; i < m_count; ++i)
+    {
+        // Empty rectangles would fail every test anyway
+        if (m_lefts[i] == emptyMin)
+            continue;
+
+        const Query query(m_lefts[i], m_tops[i], m_rights[i], m_bottoms[i]);
+
+        for (std::size_t block = 0; block < other.m_lefts.size(); block += blockSize)
+        {
+            std::uint32_t mask = query.test<false>(&other.m_lefts[block],
+                                                   &other.m_tops[block],
+                                                   &other.m_rights[block],
+                                                   &other.m_bottoms[block]);
+            for (; mask != 0; mask &= mask - 1)
+                result.push_back({static_cast<Index>(i), static_cast<Index>(block + lowestBit(mask))});
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void RectSet::findIntersections(std::vector<Pair>& result) const
+{
+    result.clear();
+
+    for (std::size_t i = 0; i < m_count; ++i)
+    {
+        if (m_lefts[i] == emptyMin)
+            continue;
+
+        const Query query(m_lefts[i], m_tops[i], m_rights[i], m_bottoms[i]);
+
+        // Only the rectangles after this one, starting in its own block
+        const std::size_t first = i + 1;
+        std::uint32_t     keep  = ~((1u << (first % blockSize)) - 1);
+
+        for (std::size_t block = first - first % blockSize; block < m_lefts.size(); block += blockSize)
+        {
+            std::uint32_t mask = keep & query.test<false>(&m_lefts[block],
+                                                          &m_tops[block],
+                                                          &m_rights[block],
+                                                          &m_bottoms[block]);
+            keep = ~0u;
+
+            for (; mask != 0; mask &= mask - 1)
+                result.push_back({static_cast<Index>(i), static_cast<Index>(block + lowestBit(mask))});
+        }
+    }
+}
+
+} // namespace pong
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "sfml.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Set of rectangles for broad-phase collision tests
+///
+/// The rectangles are stored as parallel arrays of their
+/// bounds, padded to whole blocks, so that a query tests a
+/// block of them at once with SIMD comparisons (SSE2, or AVX2
+/// when the build enables it). Blocks without any hit are
+/// skipped by their mask alone, and hits are written out as
+/// compact indices or index pairs.
+///
+/// Tests give the same answers as sf::FloatRect's contains()
+/// and findIntersection(): rectangles with negative sizes are
+/// allowed, touching edges don't intersect, and empty
+/// rectangles never intersect anything. Neither do rectangles
+/// with NaNs, for which SFML's answer depends on the order of
+/// the arguments.
+///
+/// Usage example:
+/// \code
+/// pong::RectSet bricks;
+/// for (const Brick& brick : wall)
+///     bricks.add(brick.bounds);
+///
+/// // Every tick
+/// bricks.findIntersecting(match.getBallBounds(), hits);
+/// for (const pong::RectSet::Index index : hits)
+///     wall[index].hit();
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class RectSet
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Index of a rectangle, in the order it was added
+    ///
+    ////////////////////////////////////////////////////////////
+    using Index = std::uint32_t;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Indices of two intersecting rectangles
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Pair
+    {
+        Index first;  //!< Index of a rectangle of the set the query was called on
+        Index second; //!< Index of a rectangle of the other set, or of the same one
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add a rectangle at the end of the set
+    ///
+    /// \param rect Rectangle to add
+    ///
+    /// \return Index of the new rectangle
+    ///
+    ////////////////////////////////////////////////////////////
+    Index add(const sf::FloatRect& rect);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Replace a rectangle, e.g. after its object moved
+    ///
+    /// \param index Index of the rectangle, less than getCount()
+    /// \param rect  New rectangle
+    ///
+    ////////////////////////////////////////////////////////////
+    void set(Index index, const sf::FloatRect& rect);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of rectangles in the set
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove every rectangle
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find the rectangles that contain a point
+    ///
+    /// \param point  Point to test
+    /// \param result Filled with the indices of the rectangles, in increasing order
+    ///
+    ////////////////////////////////////////////////////////////
+    void findContaining(const sf::Vector2f& point, std::vector<Index>& result) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find the rectangles that intersect a rectangle
+    ///
+    /// \param rect   Rectangle to test
+    /// \param result Filled with the indices of the rectangles, in increasing order
+    ///
+    ////////////////////////////////////////////////////////////
+    void findIntersecting(const sf::FloatRect& rect, std::vector<Index>& result) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find the pairs of intersecting rectangles between two sets
+    ///
+    /// \param other  Set to test against; may be this set, then
+    ///               each rectangle also pairs with itself
+    /// \param result Filled with the pairs, in increasing order of first then second
+    ///
+    ////////////////////////////////////////////////////////////
+    void findIntersections(const RectSet& other, std::vector<Pair>& result) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Find the pairs of intersecting rectangles within the set
+    ///
+    /// \param result Filled with the pairs, each with first < second, in increasing order
+    ///
+    ////////////////////////////////////////////////////////////
+    void findIntersections(std::vector<Pair>& result) const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<float> m_lefts;   //!< Smallest x of each rectangle, padded to whole blocks
+    std::vector<float> m_tops;    //!< Smallest y of each rectangle, padded to whole blocks
+    std::vector<float> m_rights;  //!< Largest x of each rectangle, padded to whole blocks
+    std::vector<float> m_bottoms; //!< Largest y of each rectangle, padded to whole blocks
+    std::size_t        m_count{}; //!< Number of rectangles
+};
+
+} // namespace pong
@@ -0,0 +1,79 @@
+#include "RenderBackend.hpp"
+
+#include "CoreRenderBackend.hpp"
+
+#include <cassert>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+sf::Vertex* RenderBackend::reserve(std::size_t /* vertexCount */)
+{
+    return nullptr;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderBackend::drawReserved(std::size_t /* vertexCount */, sf::PrimitiveType /* type */, const sf::RenderStates& /* states */)
+{
+    assert(false && "This backend has no vertex stream");
+}
+
+
+////////////////////////////////////////////////////////////
+LegacyRenderBackend::LegacyRenderBackend(sf::RenderTarget& target) : m_target(target)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+sf::RenderTarget& LegacyRenderBackend::getTarget()
+{
+    return m_target;
+}
+
+
+////////////////////////////////////////////////////////////
+void LegacyRenderBackend::clear(const sf::Color& color)
+{
+    m_target.clear(color);
+}
+
+
+////////////////////////////////////////////////////////////
+void LegacyRenderBackend::draw(const sf::Vertex*       vertices,
+                               std::size_t             vertexCount,
+                               sf::PrimitiveType       type,
+                               const sf::RenderStates& states)
+{
+    m_target.draw(vertices, vertexCount, type, states);
+}
+
+
+////////////////////////////////////////////////////////////
+void LegacyRenderBackend::draw(const sf::VertexBuffer& vertexBuffer,
+                               std::size_t             firstVertex,
+                               std::size_t             vertexCount,
+                               const sf::RenderStates& states)
+{
+    m_target.draw(vertexBuffer, firstVertex, vertexCount, states);
+}
+
+
+////////////////////////////////////////////////////////////
+std::unique_ptr<RenderBackend> createRenderBackend(sf::RenderTarget& target, const sf::ContextSettings& settings)
+{
+    if (settings.attributeFlags & sf::ContextSettings::Core)
+    {
+        auto backend = std::make_unique<CoreRenderBackend>(target);
+        if (backend->create())
+            return backend;
+
+        sf::err() << "Failed to create the core profile renderer, falling back to the legacy one" << std::endl;
+    }
+
+    return std::make_unique<LegacyRenderBackend>(target);
+}
+
+} // namespace pong
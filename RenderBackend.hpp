@@ -0,0 +1,161 @@
+#pragma once
+
+#include "sfml.h"
+
+#include <cstddef>
+#include <memory>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Abstract low-level drawing interface
+///
+/// Command buffers and batchers draw through a backend rather
+/// than straight to an sf::RenderTarget, so that the same
+/// recorded frame can be rendered with SFML's legacy
+/// fixed-function path or with a core profile renderer.
+///
+/// Backends create OpenGL objects: construct, use and destroy
+/// them with the target's context active on the calling thread.
+///
+////////////////////////////////////////////////////////////
+class RenderBackend
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Virtual destructor
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual ~RenderBackend() = default;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the render target the backend draws to
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual sf::RenderTarget& getTarget() = 0;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Clear the entire target with a single color
+    ///
+    /// \param color Fill color to use to clear the target
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void clear(const sf::Color& color = sf::Color::Black) = 0;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives defined by an array of vertices
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(const sf::Vertex*       vertices,
+                      std::size_t             vertexCount,
+                      sf::PrimitiveType       type,
+                      const sf::RenderStates& states) = 0;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw primitives stored in a vertex buffer
+    ///
+    /// The range is clamped to the buffer's vertex count, like
+    /// sf::RenderTarget does.
+    ///
+    /// \param vertexBuffer Vertex buffer, its primitive type is used
+    /// \param firstVertex  Index of the first vertex to draw
+    /// \param vertexCount  Number of vertices to draw
+    /// \param states       Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void draw(const sf::VertexBuffer& vertexBuffer,
+                      std::size_t             firstVertex,
+                      std::size_t             vertexCount,
+                      const sf::RenderStates& states) = 0;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reserve room in the backend's vertex stream
+    ///
+    /// Lets callers that generate vertices write them straight
+    /// into GPU-visible memory instead of an intermediate array.
+    /// The memory may be write-combined: write it sequentially
+    /// and never read it back. Until drawReserved() is called,
+    /// nothing else may be drawn.
+    ///
+    /// The default implementation returns null, meaning that
+    /// the backend has no vertex stream and draw() must be used.
+    ///
+    /// \param vertexCount Maximum number of vertices that will be written
+    ///
+    /// \return Pointer to write the vertices to, or null if not supported
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual sf::Vertex* reserve(std::size_t vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the vertices written to the memory returned by reserve()
+    ///
+    /// \param vertexCount Number of vertices written, at most the count passed to reserve()
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    virtual void drawReserved(std::size_t vertexCount, sf::PrimitiveType type, const sf::RenderStates& states);
+};
+
+
+////////////////////////////////////////////////////////////
+/// \brief Backend forwarding to sf::RenderTarget
+///
+/// Uses SFML's fixed-function pipeline and client-side vertex
+/// arrays; only works with compatibility contexts.
+///
+////////////////////////////////////////////////////////////
+class LegacyRenderBackend final : public RenderBackend
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Construct the backend
+    ///
+    /// \param target Render target to draw to
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit LegacyRenderBackend(sf::RenderTarget& target);
+
+    sf::RenderTarget& getTarget() override;
+    void              clear(const sf::Color& color = sf::Color::Black) override;
+    void              draw(const sf::Vertex*       vertices,
+                           std::size_t             vertexCount,
+                           sf::PrimitiveType       type,
+                           const sf::RenderStates& states) override;
+    void              draw(const sf::VertexBuffer& vertexBuffer,
+                           std::size_t             firstVertex,
+                           std::size_t             vertexCount,
+                           const sf::RenderStates& states) override;
+
+private:
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    sf::RenderTarget& m_target; //!< Render target to draw to
+};
+
+
+////////////////////////////////////////////////////////////
+/// \brief Create the backend matching a context's settings
+///
+/// Contexts created with sf::ContextSettings::Core get a
+/// CoreRenderBackend, others get a LegacyRenderBackend. If the
+/// core renderer fails to initialize, an error is printed and
+/// the legacy backend is returned instead.
+///
+/// \param target   Render target to draw to, must be active
+/// \param settings Settings of the target's context
+///
+/// \return The new backend
+///
+////////////////////////////////////////////////////////////
+std::unique_ptr<RenderBackend> createRenderBackend(sf::RenderTarget& target, const sf::ContextSettings& settings);
+
+} // namespace pong
@@ -0,0 +1,288 @@
+#include "RenderCommandBuffer.hpp"
+
+#include "FrameProfiler.hpp"
+#include "PreTransformBatcher.hpp"
+
+#include <algorithm>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+/// Map a state to a small index, in order of first appearance
+///
+/// Frames use a handful of shaders, textures and blend modes,
+/// so a linear search beats hashing here. Using indices rather
+/// than addresses keeps the sorted order deterministic.
+////////////////////////////////////////////////////////////
+template <typename T>
+std::uint64_t getStateIndex(std::vector<T>& states, const T& state)
+{
+    const auto it = std::find(states.begin(), states.end(), state);
+    if (it != states.end())
+        return static_cast<std::uint64_t>(it - states.begin());
+
+    states.push_back(state);
+    return states.size() - 1;
+}
+
+
+////////////////////////////////////////////////////////////
+// Names of the passes timed by replay()
+constexpr const char* clearPass = "clear";
+constexpr const char* worldPass = "world";
+constexpr const char* hudPass   = "hud";
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+void RenderCommandBuffer::clear(const sf::Color& color)
+{
+    m_clearColor = color;
+    m_layer      = 0;
+    m_vertices.clear();
+    m_items.clear();
+    m_uniforms.clear();
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderCommandBuffer::setLayer(int layer)
+{
+    assert((layer >= -128) && (layer <= 127) && "Layer out of range");
+    m_layer = layer;
+}
+
+
+////////////////////////////////////////////////////////////
+int RenderCommandBuffer::getLayer() const
+{
+    return m_layer;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderCommandBuffer::draw(const sf::Vertex* vertices, std::size_t vertexCount, sf::PrimitiveType type, const sf::RenderStates& states)
+{
+    if (!vertices || (vertexCount == 0))
+        return;
+
+    DrawItem item;
+    item.firstVertex = m_vertices.size();
+    item.vertexCount = vertexCount;
+    item.type        = type;
+    item.layer       = m_layer;
+    item.shader      = states.shader;
+    item.texture     = states.texture;
+    item.blendMode   = states.blendMode;
+    item.transform   = states.transform;
+
+    m_vertices.insert(m_vertices.end(), vertices, vertices + vertexCount);
+    m_items.push_back(item);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderCommandBuffer::draw(const sf::Sprite& sprite, const sf::RenderStates& states)
+{
+    // Same geometry as sf::Sprite builds internally
+    const sf::FloatRect bounds = sprite.getLocalBounds();
+    const sf::FloatRect rect(sprite.getTextureRect());
+    const sf::Color     color  = sprite.getColor();
+
+    const float left   = rect.left;
+    const float right  = rect.left + rect.width;
+    const float top    = rect.top;
+    const float bottom = rect.top + rect.height;
+
+    const sf::Vertex vertices[] = {{{0.f, 0.f}, color, {left, top}},
+                                   {{0.f, bounds.height}, color, {left, bottom}},
+                                   {{bounds.width, 0.f}, color, {right, top}},
+                                   {{bounds.width, bounds.height}, color, {right, bottom}}};
+
+    sf::RenderStates spriteStates = states;
+    spriteStates.transform *= sprite.getTransform();
+    spriteStates.texture = &sprite.getTexture();
+
+    draw(vertices, 4, sf::PrimitiveType::TriangleStrip, spriteStates);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderCommandBuffer::draw(const sf::VertexBuffer& vertexBuffer,
+                               std::size_t             firstVertex,
+                               std::size_t             vertexCount,
+                               const sf::RenderStates& states)
+{
+    if (vertexCount == 0)
+        return;
+
+    DrawItem item;
+    item.firstVertex  = firstVertex;
+    item.vertexCount  = vertexCount;
+    item.type         = vertexBuffer.getPrimitiveType();
+    item.layer        = m_layer;
+    item.shader       = states.shader;
+    item.texture      = states.texture;
+    item.blendMode    = states.blendMode;
+    item.transform    = states.transform;
+    item.vertexBuffer = &vertexBuffer;
+
+    m_items.push_back(item);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderCommandBuffer::setUniform(sf::Shader& shader, const std::string& name, float value)
+{
+    m_uniforms.push_back({&shader, name, value});
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderCommandBuffer::replay(RenderBackend& backend, PreTransformBatcher* batcher, FrameProfiler* profiler) const
+{
+    if (profiler)
+        profiler->beginPass(clearPass);
+
+    backend.clear(m_clearColor);
+
+    for (const UniformItem& uniform : m_uniforms)
+        uniform.shader->setUniform(uniform.name, uniform.value);
+
+    if (profiler)
+        profiler->endPass();
+
+    const char* pass = nullptr;
+    for (const DrawItem& item : m_items)
+    {
+        const char* itemPass = (item.layer >= HudLayer) ? hudPass : worldPass;
+        if (profiler && (itemPass != pass))
+        {
+            // The batch belongs to the previous pass
+            if (pass)
+            {
+                if (batcher)
+                    batcher->flush(backend);
+
+                profiler->endPass();
+            }
+
+            profiler->beginPass(itemPass);
+            pass = itemPass;
+        }
+
+        const sf::RenderStates states(item.blendMode, item.transform, item.texture, item.shader);
+
+        if (item.vertexBuffer)
+        {
+            // Already on the GPU: draw it in place, after whatever was batched before it
+            if (batcher)
+                batcher->flush(backend);
+
+            backend.draw(*item.vertexBuffer, item.firstVertex, item.vertexCount, states);
+        }
+        else if (batcher)
+        {
+            batcher->draw(backend, &m_vertices[item.firstVertex], item.vertexCount, item.type, states);
+        }
+        else
+        {
+            backend.draw(&m_vertices[item.firstVertex], item.vertexCount, item.type, states);
+        }
+    }
+
+    if (batcher)
+        batcher->flush(backend);
+
+    if (pass)
+        profiler->endPass();
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderCommandBuffer::sort()
+{
+    std::vector<const sf::Shader*>  shaders;
+    std::vector<const sf::Texture*> textures;
+    std::vector<sf::BlendMode>      blendModes;
+
+    // Key layout, from most to least significant: layer (8 bits),
+    // shader (16 bits), texture (24 bits), blend mode (16 bits)
+    m_sortKeys.clear();
+    for (const DrawItem& item : m_items)
+    {
+        const auto layer   = static_cast<std::uint64_t>(item.layer + 128);
+        const auto shader  = getStateIndex(shaders, item.shader);
+        const auto texture = getStateIndex(textures, item.texture);
+        const auto blend   = getStateIndex(blendModes, item.blendMode);
+
+        m_sortKeys.push_back((layer << 56) | (shader << 40) | (texture << 16) | blend);
+    }
+
+    m_sortOrder.resize(m_items.size());
+    for (std::size_t i = 0; i < m_sortOrder.size(); ++i)
+        m_sortOrder[i] = i;
+
+    std::stable_sort(m_sortOrder.begin(),
+                     m_sortOrder.end(),
+                     [this](std::size_t left, std::size_t right) { return m_sortKeys[left] < m_sortKeys[right]; });
+
+    // Only the items move, the vertex ranges they refer to stay where they are
+    m_sortedItems.clear();
+    for (const std::size_t index : m_sortOrder)
+        m_sortedItems.push_back(m_items[index]);
+
+    m_items.swap(m_sortedItems);
+}
+
+
+////////////////////////////////////////////////////////////
+RenderCommandBuffer::StateChanges RenderCommandBuffer::countStateChanges() const
+{
+    StateChanges changes;
+
+    // Start from the states of a freshly reset render target
+    const sf::Shader*  shader    = nullptr;
+    const sf::Texture* texture   = nullptr;
+    sf::BlendMode      blendMode = sf::BlendAlpha;
+
+    for (const DrawItem& item : m_items)
+    {
+        ++changes.drawCalls;
+
+        if (item.shader != shader)
+            ++changes.shaderChanges;
+
+        if (item.texture != texture)
+            ++changes.textureBinds;
+
+        if (item.blendMode != blendMode)
+            ++changes.blendChanges;
+
+        shader    = item.shader;
+        texture   = item.texture;
+        blendMode = item.blendMode;
+    }
+
+    return changes;
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<RenderCommandBuffer::DrawItem>& RenderCommandBuffer::getItems() const
+{
+    return m_items;
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<sf::Vertex>& RenderCommandBuffer::getVertices() const
+{
+    return m_vertices;
+}
+
+} // namespace pong
@@ -0,0 +1,232 @@
+#pragma once
+
+#include "sfml.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace pong
+{
+class FrameProfiler;
+class PreTransformBatcher;
+class RenderBackend;
+
+////////////////////////////////////////////////////////////
+/// \brief Records draw calls so that they can be replayed later,
+///        possibly on another thread
+///
+/// Vertices of all the recorded draws are appended to a single
+/// array; each DrawItem refers to a range of it together with
+/// the states needed to draw it. Textures are stored by pointer
+/// and must stay alive until the buffer has been replayed.
+///
+/// Draws can be assigned to layers and sorted by state before
+/// replaying, so that the backend's states cache sees
+/// runs of identical textures and blend modes instead of
+/// whatever order the game code happened to use.
+///
+////////////////////////////////////////////////////////////
+class RenderCommandBuffer
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief A single recorded draw call
+    ///
+    ////////////////////////////////////////////////////////////
+    struct DrawItem
+    {
+        std::size_t             firstVertex{};  //!< Index of the first vertex in the buffer's vertex array, or in vertexBuffer
+        std::size_t             vertexCount{};  //!< Number of vertices to draw
+        sf::PrimitiveType       type{};         //!< Type of primitives to draw
+        int                     layer{};        //!< Layer the draw belongs to, lower layers are drawn first
+        const sf::Shader*       shader{};       //!< Shader to use, can be null
+        const sf::Texture*      texture{};      //!< Texture to use, can be null
+        sf::BlendMode           blendMode;      //!< Blending mode
+        sf::Transform           transform;      //!< Transform applied to the vertices
+        const sf::VertexBuffer* vertexBuffer{}; //!< Vertex buffer to draw from, null to use the buffer's vertex array
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Number of state changes a replay issues
+    ///
+    /// Mirrors what sf::RenderTarget::StatesCache can skip: a
+    /// texture or blend mode is only applied when it differs from
+    /// the one used by the previous draw.
+    ///
+    ////////////////////////////////////////////////////////////
+    struct StateChanges
+    {
+        std::size_t drawCalls{};     //!< Number of draw calls
+        std::size_t shaderChanges{}; //!< Number of times a different shader is bound
+        std::size_t textureBinds{};  //!< Number of times a different texture is bound
+        std::size_t blendChanges{};  //!< Number of times a different blend mode is applied
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief First layer profiled as the HUD pass by replay()
+    ///
+    ////////////////////////////////////////////////////////////
+    static constexpr int HudLayer{64}; // NOLINT(readability-identifier-naming)
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Remove all the recorded draws and set the clear color
+    ///
+    /// \param color Color used to clear the target when replaying
+    ///
+    ////////////////////////////////////////////////////////////
+    void clear(const sf::Color& color = sf::Color::Black);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the layer of the draws recorded from now on
+    ///
+    /// Layers are drawn in increasing order by sort(). Within a
+    /// layer, draws may be reordered to group identical states,
+    /// so draws whose relative order matters (overlapping
+    /// translucent geometry) must go to different layers.
+    /// The layer is reset to 0 by clear().
+    ///
+    /// \param layer Layer index, in [-128, 127]
+    ///
+    ////////////////////////////////////////////////////////////
+    void setLayer(int layer);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the layer of the draws recorded from now on
+    ///
+    ////////////////////////////////////////////////////////////
+    int getLayer() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record primitives defined by an array of vertices
+    ///
+    /// The vertices are copied into the buffer.
+    ///
+    /// \param vertices    Pointer to the vertices
+    /// \param vertexCount Number of vertices in the array
+    /// \param type        Type of primitives to draw
+    /// \param states      Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const sf::Vertex*       vertices,
+              std::size_t             vertexCount,
+              sf::PrimitiveType       type,
+              const sf::RenderStates& states = sf::RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record a sprite
+    ///
+    /// \param sprite Sprite to record
+    /// \param states Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const sf::Sprite& sprite, const sf::RenderStates& states = sf::RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record primitives stored in a vertex buffer
+    ///
+    /// Only a reference to the vertex buffer is recorded: it must
+    /// stay alive and unmodified until the buffer has been
+    /// replayed. Such draws are never batched.
+    ///
+    /// \param vertexBuffer Vertex buffer, its primitive type is used
+    /// \param firstVertex  Index of the first vertex to draw
+    /// \param vertexCount  Number of vertices to draw
+    /// \param states       Render states to use for drawing
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(const sf::VertexBuffer& vertexBuffer,
+              std::size_t             firstVertex,
+              std::size_t             vertexCount,
+              const sf::RenderStates& states = sf::RenderStates::Default);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record a float uniform to set when the buffer is replayed
+    ///
+    /// Shader uniforms can only be changed safely from the thread
+    /// that draws with the shader. Recorded uniforms are set in
+    /// recording order before the first draw of the replay, so a
+    /// shader sees the last value recorded in the frame
+    /// whatever the order of the draws after sort().
+    ///
+    /// \param shader Shader whose uniform to set, must stay alive until the buffer has been replayed
+    /// \param name   Name of the uniform variable in GLSL
+    /// \param value  Value of the float scalar
+    ///
+    ////////////////////////////////////////////////////////////
+    void setUniform(sf::Shader& shader, const std::string& name, float value);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Clear the backend's target and issue all the recorded draws to it
+    ///
+    /// When a profiler is given, the clear is timed as the
+    /// "clear" pass and the draws as the "world" pass, or the
+    /// "hud" pass for layers from HudLayer up.
+    ///
+    /// \param backend  Backend to draw with
+    /// \param batcher  Batcher used to merge small draws, or null to issue every draw as is
+    /// \param profiler Profiler to time the passes with, or null
+    ///
+    ////////////////////////////////////////////////////////////
+    void replay(RenderBackend& backend, PreTransformBatcher* batcher = nullptr, FrameProfiler* profiler = nullptr) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reorder the recorded draws to minimize state changes
+    ///
+    /// Draws are sorted by layer, shader, texture and blend mode,
+    /// in that order of priority. The sort is stable: draws with
+    /// identical keys keep their submission order.
+    ///
+    ////////////////////////////////////////////////////////////
+    void sort();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Count the state changes replaying the draws in their current order would issue
+    ///
+    /// Call it before and after sort() to measure its effect.
+    ///
+    /// \return State change counters
+    ///
+    ////////////////////////////////////////////////////////////
+    StateChanges countStateChanges() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the recorded draw items
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<DrawItem>& getItems() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the vertices referenced by the draw items
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<sf::Vertex>& getVertices() const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief A uniform recorded by setUniform
+    ///
+    ////////////////////////////////////////////////////////////
+    struct UniformItem
+    {
+        sf::Shader* shader{}; //!< Shader whose uniform to set
+        std::string name;     //!< Name of the uniform
+        float       value{};  //!< Value to set
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    sf::Color                  m_clearColor{sf::Color::Black}; //!< Color used to clear the target
+    int                        m_layer{};                      //!< Layer of the next recorded draws
+    std::vector<UniformItem>   m_uniforms;                     //!< Uniforms to set before drawing
+    std::vector<sf::Vertex>    m_vertices;                     //!< Vertices of all the recorded draws
+    std::vector<DrawItem>      m_items;                        //!< Recorded draws, in submission or sorted order
+    std::vector<std::uint64_t> m_sortKeys;                     //!< Scratch storage for sort(), one key per item
+    std::vector<std::size_t>   m_sortOrder;                    //!< Scratch storage for sort(), sorted item indices
+    std::vector<DrawItem>      m_sortedItems;                  //!< Scratch storage for sort(), reordered items
+};
+
+} // namespace pong
@@ -0,0 +1,244 @@
+#include "RenderThread.hpp"
+
+#include "CoreRenderBackend.hpp"
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+float RenderThread::Statistics::getSpeedup() const
+{
+    if (elapsed == sf::Time::Zero)
+        return 1.f;
+
+    return (recordTime + renderTime).asSeconds() / elapsed.asSeconds();
+}
+
+
+////////////////////////////////////////////////////////////
+RenderThread::RenderThread(sf::RenderWindow& window, std::uint32_t crtEffects, IndexedFramebuffer* indexed) :
+m_window(window),
+m_crtEffects(crtEffects),
+m_indexed(indexed)
+{
+    // The context can only be active on one thread at a time
+    if (!m_window.setActive(false))
+        sf::err() << "Failed to release the window's context for the render thread" << std::endl;
+
+    m_thread = std::thread(&RenderThread::run, this);
+}
+
+
+////////////////////////////////////////////////////////////
+RenderThread::~RenderThread()
+{
+    {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_pending == NoBuffer; });
+        m_running = false;
+    }
+
+    m_condition.notify_all();
+    m_thread.join();
+
+    if (!m_window.setActive(true))
+        sf::err() << "Failed to reactivate the window's context" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+RenderCommandBuffer& RenderThread::beginFrame()
+{
+    sf::Clock stallClock;
+
+    {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this] { return (m_pending != m_recording) && (m_rendering != m_recording); });
+        m_statistics.recordStall += stallClock.getElapsedTime();
+    }
+
+    m_recordClock.restart();
+    return m_buffers[m_recording];
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderThread::submitFrame()
+{
+    const sf::Time recordTime = m_recordClock.getElapsedTime();
+    sf::Clock      stallClock;
+
+    {
+        std::unique_lock lock(m_mutex);
+        m_condition.wait(lock, [this] { return m_pending == NoBuffer; });
+
+        m_statistics.recordStall += stallClock.getElapsedTime();
+        m_statistics.recordTime += recordTime;
+        m_pending   = m_recording;
+        m_recording = 1 - m_recording;
+    }
+
+    m_condition.notify_all();
+}
+
+
+////////////////////////////////////////////////////////////
+RenderThread::Statistics RenderThread::getStatistics() const
+{
+    const std::lock_guard lock(m_mutex);
+
+    Statistics statistics = m_statistics;
+    statistics.elapsed    = m_lifetimeClock.getElapsedTime();
+    return statistics;
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderThread::writeTrace(std::ostream& stream) const
+{
+    const std::lock_guard lock(m_mutex);
+
+    if (m_profiler)
+        m_profiler->writeTrace(stream);
+}
+
+
+////////////////////////////////////////////////////////////
+void RenderThread::run()
+{
+    if (!m_window.setActive(true))
+        sf::err() << "Failed to activate the window's context on the render thread" << std::endl;
+
+    m_backend = createRenderBackend(m_window, m_window.getSettings());
+
+    if (((m_crtEffects != CrtPostProcess::None) || m_indexed) &&
+        (m_window.getSettings().attributeFlags & sf::ContextSettings::Core))
+    {
+        sf::err() << "The CRT and indexed stages require a compatibility context, disabling them" << std::endl;
+        m_crtEffects = CrtPostProcess::None;
+        m_indexed    = nullptr;
+    }
+
+    if (m_crtEffects != CrtPostProcess::None)
+    {
+        const sf::Vector2f sceneSize = m_window.getDefaultView().getSize();
+
+        m_postProcess = std::make_unique<CrtPostProcess>();
+        if (!m_postProcess->create(sf::Vector2u(sceneSize), m_crtEffects))
+            m_postProcess.reset();
+    }
+
+    // Frames are drawn to the first stage of the chain
+    if (m_indexed)
+        m_sceneBackend = std::make_unique<LegacyRenderBackend>(m_indexed->getScene());
+    else if (m_postProcess)
+        m_sceneBackend = std::make_unique<LegacyRenderBackend>(m_postProcess->getScene());
+
+    RenderBackend&    backend   = m_sceneBackend ? *m_sceneBackend : *m_backend;
+    const std::size_t threshold = m_batcher.calibrate(backend);
+
+    auto profiler = std::make_unique<FrameProfiler>();
+    if (!profiler->create())
+        sf::err() << "GPU timestamps are not supported, profiling the render thread on the CPU only" << std::endl;
+
+    {
+        const std::lock_guard lock(m_mutex);
+        m_statistics.threshold = threshold;
+        m_profiler             = std::move(profiler);
+    }
+
+    for (;;)
+    {
+        sf::Clock stallClock;
+        int       buffer = NoBuffer;
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_condition.wait(lock, [this] { return (m_pending != NoBuffer) || !m_running; });
+
+            if (m_pending == NoBuffer)
+                break;
+
+            m_statistics.renderStall += stallClock.getElapsedTime();
+            buffer      = m_pending;
+            m_rendering = m_pending;
+            m_pending   = NoBuffer;
+
+            // Completes earlier frames, which writeTrace may be reading
+            m_profiler->beginFrame();
+        }
+
+        // Let the caller submit the next frame while we render this one
+        m_condition.notify_all();
+
+        sf::Clock renderClock;
+        m_batcher.resetStatistics();
+        m_buffers[buffer].replay(backend, &m_batcher, m_profiler.get());
+
+        if (m_indexed || m_postProcess)
+        {
+            m_profiler->beginPass("post");
+
+            if (m_indexed)
+            {
+                if (m_postProcess)
+                    m_indexed->resolve(m_postProcess->getScene());
+                else
+                    m_indexed->resolve(m_window);
+            }
+
+            if (m_postProcess)
+                m_postProcess->apply(m_window);
+
+            m_profiler->endPass();
+        }
+
+        m_profiler->beginPass("present");
+        m_window.display();
+        m_profiler->endPass();
+
+        {
+            const std::lock_guard lock(m_mutex);
+            m_statistics.renderTime += renderClock.getElapsedTime();
+            m_statistics.draws += m_batcher.getStatistics().draws;
+            m_statistics.drawCalls += m_batcher.getStatistics().drawCalls;
+
+            if (const auto* core = dynamic_cast<const CoreRenderBackend*>(m_backend.get()))
+            {
+                const StreamingVertexRing::Statistics& stream = core->getStreamingStatistics();
+                m_statistics.bytesStreamed = stream.bytesStreamed;
+                m_statistics.fenceWaits    = stream.fenceWaits;
+                m_statistics.fenceWaitTime = stream.fenceWaitTime;
+            }
+
+            if (m_postProcess)
+            {
+                m_statistics.crtGpuTime      = m_postProcess->getGpuTime();
+                m_statistics.crtWithinBudget = m_postProcess->isWithinBudget();
+            }
+
+            m_profiler->endFrame();
+            m_statistics.passes = m_profiler->getAverages();
+
+            ++m_statistics.frames;
+            m_rendering = NoBuffer;
+        }
+
+        m_condition.notify_all();
+    }
+
+    // The OpenGL objects belong to the context that is still active here
+    {
+        const std::lock_guard lock(m_mutex);
+        m_profiler.reset();
+    }
+
+    m_sceneBackend.reset();
+    m_postProcess.reset();
+    m_backend.reset();
+
+    if (!m_window.setActive(false))
+        sf::err() << "Failed to release the window's context on the render thread" << std::endl;
+}
+
+} // namespace pong
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "CrtPostProcess.hpp"
+#include "FrameProfiler.hpp"
+#include "IndexedFramebuffer.hpp"
+#include "PreTransformBatcher.hpp"
+#include "RenderBackend.hpp"
+#include "RenderCommandBuffer.hpp"
+#include "sfml.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Replays recorded frames on a dedicated thread
+///
+/// The render thread owns the window's OpenGL context for its
+/// whole lifetime; the thread that constructs the RenderThread
+/// must not draw to the window until it is destroyed. Events
+/// still have to be polled from the thread that created the
+/// window.
+///
+/// Two command buffers are used: while the render thread
+/// replays and displays frame N, the caller simulates and
+/// records frame N + 1 into the other buffer.
+///
+/// Frames are drawn with the backend matching the window's
+/// context settings (see createRenderBackend), created on the
+/// render thread. Small draws are merged by a
+/// PreTransformBatcher whose threshold is calibrated when the
+/// thread starts.
+///
+/// Optionally, frames are drawn into an IndexedFramebuffer
+/// whose scene is resolved through its palettes, and/or at
+/// the window's default view size into a CrtPostProcess scene
+/// drawn to the window with the CRT effects. When both are
+/// used, the indexed scene is resolved into the CRT scene.
+///
+/// Each frame is profiled with a FrameProfiler: the clear,
+/// world, HUD, post-process and present passes are timed on
+/// the CPU and, when timestamp queries are supported, on the
+/// GPU.
+///
+/// Usage example:
+/// \code
+/// pong::RenderThread renderThread(window);
+/// while (running)
+/// {
+///     // poll events, simulate...
+///     pong::RenderCommandBuffer& frame = renderThread.beginFrame();
+///     frame.clear(sf::Color::Cyan);
+///     frame.draw(ball);
+///     renderThread.submitFrame();
+/// }
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class RenderThread
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Timing statistics accumulated since construction
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Statistics
+    {
+        std::size_t                         frames{};              //!< Number of frames rendered
+        std::size_t                         draws{};               //!< Number of draws recorded in those frames
+        std::size_t                         drawCalls{};           //!< Number of draw calls issued after batching
+        std::size_t                         threshold{};           //!< Pre-transform threshold chosen at startup
+        sf::Time                            recordTime;            //!< Time spent by the caller between beginFrame and submitFrame
+        sf::Time                            renderTime;            //!< Time spent replaying and displaying frames
+        sf::Time                            recordStall;           //!< Time the caller waited for a free command buffer
+        sf::Time                            renderStall;           //!< Time the render thread waited for a submitted frame
+        sf::Time                            elapsed;               //!< Wall-clock time since construction
+        std::size_t                         bytesStreamed{};       //!< Vertex bytes written to the core backend's stream, 0 with the legacy backend
+        std::size_t                         fenceWaits{};          //!< Number of times the stream had to wait for the GPU
+        sf::Time                            fenceWaitTime;         //!< Time spent in those waits
+        sf::Time                            crtGpuTime;            //!< Average GPU time of the CRT pass, zero if not measured
+        bool                                crtWithinBudget{true}; //!< Does the CRT pass fit in its GPU budget?
+        std::vector<FrameProfiler::Average> passes;                //!< Moving average of each render pass, on the CPU and the GPU
+
+        ////////////////////////////////////////////////////////////
+        /// \brief Ratio between the serial cost of a frame and the achieved frame time
+        ///
+        /// 1 means no overlap at all, 2 means recording and
+        /// rendering fully overlap. In a paced game this is how
+        /// much of the frame the render thread hides, not a
+        /// throughput gain; the "render-thread" benchmark
+        /// measures that under a CPU-bound load.
+        ///
+        ////////////////////////////////////////////////////////////
+        float getSpeedup() const;
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deactivate the window on the calling thread and start rendering
+    ///
+    /// \param window     Window to render to
+    /// \param crtEffects CrtPostProcess effects to apply, CrtPostProcess::None to draw straight to the window
+    /// \param indexed    Indexed framebuffer to draw frames to, or null for color rendering;
+    ///                   it must outlive the RenderThread and not be used by the caller meanwhile
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit RenderThread(sf::RenderWindow&   window,
+                          std::uint32_t       crtEffects = CrtPostProcess::None,
+                          IndexedFramebuffer* indexed    = nullptr);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Finish the pending frame, stop the thread and
+    ///        give the window's context back to the calling thread
+    ///
+    ////////////////////////////////////////////////////////////
+    ~RenderThread();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    RenderThread(const RenderThread&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy assignment
+    ///
+    ////////////////////////////////////////////////////////////
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a command buffer to record the next frame into
+    ///
+    /// Blocks until the render thread is done with the buffer,
+    /// i.e. until the frame before the previous one is displayed.
+    ///
+    /// \return Command buffer to record into
+    ///
+    ////////////////////////////////////////////////////////////
+    RenderCommandBuffer& beginFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Hand the buffer returned by beginFrame to the render thread
+    ///
+    ////////////////////////////////////////////////////////////
+    void submitFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the timing statistics
+    ///
+    ////////////////////////////////////////////////////////////
+    Statistics getStatistics() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Write the timeline of the last frames rendered
+    ///
+    /// See FrameProfiler::writeTrace.
+    ///
+    /// \param stream Stream to write to
+    ///
+    ////////////////////////////////////////////////////////////
+    void writeTrace(std::ostream& stream) const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Render thread entry point
+    ///
+    ////////////////////////////////////////////////////////////
+    void run();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    static constexpr int NoBuffer{-1}; // NOLINT(readability-identifier-naming)
+
+    sf::RenderWindow&               m_window;              //!< Window to render to
+    std::unique_ptr<RenderBackend>  m_backend;             //!< Backend drawing to m_window, owned by the render thread
+    std::uint32_t                   m_crtEffects;          //!< CRT effects requested at construction
+    std::unique_ptr<CrtPostProcess> m_postProcess;         //!< CRT stage, owned by the render thread
+    IndexedFramebuffer*             m_indexed;             //!< Indexed stage, if any
+    std::unique_ptr<RenderBackend>  m_sceneBackend;        //!< Backend drawing to the first stage's scene
+    std::unique_ptr<FrameProfiler>  m_profiler;            //!< Times the passes, owned by the render thread
+    RenderCommandBuffer             m_buffers[2];          //!< Double-buffered frames
+    PreTransformBatcher             m_batcher;             //!< Merges small draws, used by the render thread only
+    int                             m_recording{};         //!< Buffer being recorded by the caller
+    int                             m_pending{NoBuffer};   //!< Buffer submitted but not yet picked up
+    int                             m_rendering{NoBuffer}; //!< Buffer being replayed
+    bool                            m_running{true};       //!< Should the render thread keep running?
+    mutable std::mutex              m_mutex;               //!< Protects the buffer indices and statistics
+    std::condition_variable         m_condition;           //!< Signaled whenever a buffer changes hands
+    sf::Clock                       m_recordClock;         //!< Measures the caller's recording time
+    sf::Clock                       m_lifetimeClock;       //!< Measures the wall-clock time
+    Statistics                      m_statistics;          //!< Accumulated statistics
+    std::thread                     m_thread;              //!< The render thread, started last
+};
+
+} // namespace pong
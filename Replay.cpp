@@ -0,0 +1,209 @@
+#include "Replay.hpp"
+
+#include "BinaryIo.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Inputs of a tick, packed in a byte: 2 bits per paddle
+// (0 stays, 1 moves up, 2 moves down) and a start flag
+////////////////////////////////////////////////////////////
+constexpr std::uint8_t startFlag = 1 << 4;
+
+constexpr char         fileMagic[] = "PONGRPL";
+constexpr std::uint8_t fileVersion = 1;
+
+
+////////////////////////////////////////////////////////////
+std::uint8_t packDirection(int direction)
+{
+    return (direction < 0) ? 1 : (direction > 0) ? 2 : 0;
+}
+
+
+////////////////////////////////////////////////////////////
+int unpackDirection(std::uint8_t bits)
+{
+    return (bits == 1) ? -1 : (bits == 2) ? 1 : 0;
+}
+
+
+////////////////////////////////////////////////////////////
+bool isValidInput(std::uint8_t input)
+{
+    return (input < (startFlag << 1)) && ((input & 0x3) != 0x3) && ((input & 0xC) != 0xC);
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+Replay::Replay() : Replay(0, 0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+Replay::Replay(std::uint64_t seed, std::uint64_t matchId) : m_seed(seed), m_matchId(matchId)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void Replay::recordStart()
+{
+    m_starting = true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Replay::record(int left, int right)
+{
+    const auto input = static_cast<std::uint8_t>(packDirection(left) | (packDirection(right) << 2) |
+                                                 (m_starting ? startFlag : 0));
+
+    if (m_runs.empty() || (m_runs.back().input != input))
+        m_runs.push_back({m_ticks, input});
+
+    ++m_ticks;
+    m_starting = false;
+}
+
+
+////////////////////////////////////////////////////////////
+Replay::Input Replay::getInput(std::uint32_t tick) const
+{
+    assert(tick < m_ticks && "Tick out of the replay");
+
+    // Last run starting at or before the tick
+    const auto run = std::upper_bound(m_runs.begin(),
+                                      m_runs.end(),
+                                      tick,
+                                      [](std::uint32_t value, const Run& other) { return value < other.tick; });
+
+    const std::uint8_t input = std::prev(run)->input;
+    return {unpackDirection(input & 0x3), unpackDirection((input >> 2) & 0x3), (input & startFlag) != 0};
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint32_t Replay::getTickCount() const
+{
+    return m_ticks;
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint64_t Replay::getSeed() const
+{
+    return m_seed;
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint64_t Replay::getMatchId() const
+{
+    return m_matchId;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Replay::saveToFile(const std::filesystem::path& filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        sf::err() << "Failed to open replay file " << filename << " for writing" << std::endl;
+        return false;
+    }
+
+    using binary::write;
+    binary::writeHeader(file, fileMagic, fileVersion);
+
+    write(file, m_seed);
+    write(file, m_matchId);
+    write(file, m_ticks);
+
+    write(file, static_cast<std::uint32_t>(m_runs.size()));
+    for (const Run& run : m_runs)
+    {
+        write(file, run.tick);
+        write(file, run.input);
+    }
+
+    if (!file.flush())
+    {
+        sf::err() << "Failed to write replay file " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Replay::loadFromFile(const std::filesystem::path& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        sf::err() << "Failed to open replay file " << filename << std::endl;
+        return false;
+    }
+
+    using binary::read;
+    if (!binary::readHeader(file, fileMagic, fileVersion))
+    {
+        sf::err() << "Failed to load replay file " << filename << ": not a version " << int{fileVersion}
+                  << " replay file" << std::endl;
+        return false;
+    }
+
+    std::uint64_t seed     = 0;
+    std::uint64_t matchId  = 0;
+    std::uint32_t ticks    = 0;
+    std::uint32_t runCount = 0;
+    read(file, seed);
+    read(file, matchId);
+    read(file, ticks);
+    read(file, runCount);
+
+    // Runs must start at tick 0 and cover the ticks in order
+    std::vector<Run> runs;
+    for (std::uint32_t i = 0; file && (i < runCount); ++i)
+    {
+        Run run{};
+        read(file, run.tick);
+        read(file, run.input);
+
+        const bool ordered = runs.empty() ? (run.tick == 0) : (run.tick > runs.back().tick);
+        if (!ordered || (run.tick >= ticks) || !isValidInput(run.input))
+            file.setstate(std::ios::failbit);
+
+        runs.push_back(run);
+    }
+
+    if (!file || (runs.empty() != (ticks == 0)))
+    {
+        sf::err() << "Failed to load replay file " << filename << ": the file is truncated or corrupt" << std::endl;
+        return false;
+    }
+
+    m_seed     = seed;
+    m_matchId  = matchId;
+    m_runs     = std::move(runs);
+    m_ticks    = ticks;
+    m_starting = false;
+    return true;
+}
+
+} // namespace pong
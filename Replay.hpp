@@ -0,0 +1,205 @@
+#pragma once
+
+#include "Match.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Recording of a match, to play it again exactly
+///
+/// A match is deterministic, and its random numbers are Philox
+/// draws keyed by its seed, its id and the tick: its seed, its
+/// id and the inputs of each tick are all it takes to play it
+/// again, on any machine and from any tick. Inputs are stored
+/// as runs of identical ticks, so a replay costs a few bytes
+/// per paddle move, whatever its length.
+///
+/// The rules aren't recorded: a replay must be played with the
+/// rules of the match it was recorded from.
+///
+/// Usage example:
+/// \code
+/// pong::Replay replay(seed, matchId);
+/// pong::Match  match(rules, seed, matchId);
+///
+/// // When the player starts a match
+/// replay.recordStart();
+/// match.start();
+///
+/// // Every tick
+/// replay.record(left, right);
+/// match.step(left, right);
+///
+/// // Later
+/// pong::Match copy = replay.createMatch(rules);
+/// replay.play(copy, replay.getTickCount());
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class Replay
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Inputs of a tick
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Input
+    {
+        int  left{};  //!< Direction of the left paddle, -1, 0 or 1
+        int  right{}; //!< Direction of the right paddle
+        bool start{}; //!< Was start() called before the tick?
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create an empty replay of a match with a seed and an id of 0
+    ///
+    ////////////////////////////////////////////////////////////
+    Replay();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create an empty replay
+    ///
+    /// \param seed    Seed of the recorded match
+    /// \param matchId Id of the recorded match
+    ///
+    ////////////////////////////////////////////////////////////
+    Replay(std::uint64_t seed, std::uint64_t matchId);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record a call to start() before the next tick
+    ///
+    ////////////////////////////////////////////////////////////
+    void recordStart();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record the inputs of a tick, as given to step()
+    ///
+    /// \param left  Direction of the left paddle
+    /// \param right Direction of the right paddle
+    ///
+    ////////////////////////////////////////////////////////////
+    void record(int left, int right);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the inputs of a tick
+    ///
+    /// \param tick Index of the tick, less than getTickCount()
+    ///
+    ////////////////////////////////////////////////////////////
+    Input getInput(std::uint32_t tick) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the recorded match, before its first tick
+    ///
+    /// \param rules Rules of the recorded match
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename RulesPolicy>
+    BasicMatch<RulesPolicy> createMatch(const RulesPolicy& rules) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Play the next recorded ticks of a match
+    ///
+    /// The match continues from its current tick, so it must be
+    /// a copy of the recorded match at some point of the replay,
+    /// e.g. created with createMatch().
+    ///
+    /// \param match Match to play
+    /// \param ticks Largest number of ticks to play
+    ///
+    /// \return Number of ticks played, fewer at the end of the replay
+    ///
+    ////////////////////////////////////////////////////////////
+    template <typename RulesPolicy>
+    std::uint32_t play(BasicMatch<RulesPolicy>& match, std::uint32_t ticks) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of recorded ticks
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint32_t getTickCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the seed of the recorded match
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint64_t getSeed() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the id of the recorded match
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint64_t getMatchId() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Save the replay to a file
+    ///
+    /// A call to start() recorded after the last tick is lost.
+    ///
+    /// \return True if saved
+    ///
+    ////////////////////////////////////////////////////////////
+    bool saveToFile(const std::filesystem::path& filename) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Replace the replay with one saved to a file
+    ///
+    /// \return True if loaded, false if the replay is unchanged
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFile(const std::filesystem::path& filename);
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Ticks with the same inputs
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Run
+    {
+        std::uint32_t tick;  //!< First tick of the run
+        std::uint8_t  input; //!< Inputs of its ticks, packed
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::uint64_t    m_seed;       //!< Seed of the recorded match
+    std::uint64_t    m_matchId;    //!< Id of the recorded match
+    std::vector<Run> m_runs;       //!< Runs of the ticks, in order
+    std::uint32_t    m_ticks{};    //!< Number of recorded ticks
+    bool             m_starting{}; //!< Was start() recorded for the next tick?
+};
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+BasicMatch<RulesPolicy> Replay::createMatch(const RulesPolicy& rules) const
+{
+    return BasicMatch<RulesPolicy>(rules, m_seed, m_matchId);
+}
+
+
+////////////////////////////////////////////////////////////
+template <typename RulesPolicy>
+std::uint32_t Replay::play(BasicMatch<RulesPolicy>& match, std::uint32_t ticks) const
+{
+    std::uint32_t played = 0;
+    for (; (played < ticks) && (match.getState().tick < m_ticks); ++played)
+    {
+        const Input input = getInput(match.getState().tick);
+        if (input.start)
+            match.start();
+
+        match.step(input.left, input.right);
+    }
+
+    return played;
+}
+
+} // namespace pong
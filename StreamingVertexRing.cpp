@@ -0,0 +1,266 @@
+#include "StreamingVertexRing.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// How long a single fence wait may block before it is retried
+constexpr pong::gl::GLuint64 fenceTimeout = 1'000'000'000; // 1 s, in nanoseconds
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+StreamingVertexRing::~StreamingVertexRing()
+{
+    if (!m_buffer)
+        return;
+
+    release();
+}
+
+
+////////////////////////////////////////////////////////////
+bool StreamingVertexRing::create(std::size_t segmentCapacity, bool persistent)
+{
+    if (!gl::isCoreProfileAvailable())
+    {
+        sf::err() << "Failed to create the streaming vertex buffer: buffer mapping is not supported" << std::endl;
+        return false;
+    }
+
+    m_persistent = persistent && gl::isBufferStorageAvailable();
+    return allocate(segmentCapacity);
+}
+
+
+////////////////////////////////////////////////////////////
+bool StreamingVertexRing::isPersistent() const
+{
+    return m_persistent;
+}
+
+
+////////////////////////////////////////////////////////////
+gl::GLuint StreamingVertexRing::getBuffer() const
+{
+    return m_buffer;
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t StreamingVertexRing::getGeneration() const
+{
+    return m_generation;
+}
+
+
+////////////////////////////////////////////////////////////
+void StreamingVertexRing::nextFrame()
+{
+    assert(m_mapped == 0 && "The previous range must be unmapped before starting a new frame");
+
+    ++m_statistics.frames;
+    advance();
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Vertex* StreamingVertexRing::map(std::size_t vertexCount)
+{
+    assert(m_mapped == 0 && "Only one range can be mapped at a time");
+    assert(vertexCount > 0);
+
+    if (!m_buffer)
+        return nullptr;
+
+    if (vertexCount > m_segmentCapacity)
+    {
+        ++m_statistics.orphans;
+        if (!allocate(std::max(vertexCount, m_segmentCapacity * 2)))
+            return nullptr;
+    }
+    else if (m_offset + vertexCount > m_segmentCapacity)
+    {
+        advance();
+    }
+
+    const std::size_t first    = m_segment * m_segmentCapacity + m_offset;
+    sf::Vertex*       vertices = nullptr;
+
+    if (m_persistent)
+    {
+        vertices = m_mapping + first;
+    }
+    else
+    {
+        // The range hasn't been used since the buffer was last orphaned: no need to synchronize
+        gl::BindBuffer(gl::ARRAY_BUFFER, m_buffer);
+        vertices = static_cast<sf::Vertex*>(
+            gl::MapBufferRange(gl::ARRAY_BUFFER,
+                               static_cast<gl::GLintptr>(first * sizeof(sf::Vertex)),
+                               static_cast<gl::GLsizeiptr>(vertexCount * sizeof(sf::Vertex)),
+                               gl::MAP_WRITE_BIT | gl::MAP_INVALIDATE_RANGE_BIT | gl::MAP_UNSYNCHRONIZED_BIT));
+    }
+
+    if (vertices)
+        m_mapped = vertexCount;
+
+    return vertices;
+}
+
+
+////////////////////////////////////////////////////////////
+gl::GLint StreamingVertexRing::unmap(std::size_t vertexCount)
+{
+    assert(m_mapped > 0 && "No range is mapped");
+    assert(vertexCount <= m_mapped);
+
+    if (!m_persistent)
+    {
+        gl::BindBuffer(gl::ARRAY_BUFFER, m_buffer);
+        if (!gl::UnmapBuffer(gl::ARRAY_BUFFER))
+            sf::err() << "The streaming vertex buffer's contents were lost while it was mapped" << std::endl;
+    }
+
+    const std::size_t first = m_segment * m_segmentCapacity + m_offset;
+
+    m_offset += vertexCount;
+    m_mapped = 0;
+    m_statistics.bytesStreamed += vertexCount * sizeof(sf::Vertex);
+
+    return static_cast<gl::GLint>(first);
+}
+
+
+////////////////////////////////////////////////////////////
+const StreamingVertexRing::Statistics& StreamingVertexRing::getStatistics() const
+{
+    return m_statistics;
+}
+
+
+////////////////////////////////////////////////////////////
+void StreamingVertexRing::resetStatistics()
+{
+    m_statistics = Statistics();
+}
+
+
+////////////////////////////////////////////////////////////
+bool StreamingVertexRing::allocate(std::size_t segmentCapacity)
+{
+    release();
+
+    m_segmentCapacity = std::max<std::size_t>(segmentCapacity, 1);
+    m_segment         = 0;
+    m_offset          = 0;
+    m_mapped          = 0;
+
+    const auto size = static_cast<gl::GLsizeiptr>(SegmentCount * m_segmentCapacity * sizeof(sf::Vertex));
+
+    gl::GenBuffers(1, &m_buffer);
+    gl::BindBuffer(gl::ARRAY_BUFFER, m_buffer);
+    ++m_generation;
+
+    if (!m_persistent)
+    {
+        gl::BufferData(gl::ARRAY_BUFFER, size, nullptr, gl::STREAM_DRAW);
+        return true;
+    }
+
+    const gl::GLbitfield flags = gl::MAP_WRITE_BIT | gl::MAP_PERSISTENT_BIT | gl::MAP_COHERENT_BIT;
+    gl::BufferStorage(gl::ARRAY_BUFFER, size, nullptr, flags);
+    m_mapping = static_cast<sf::Vertex*>(gl::MapBufferRange(gl::ARRAY_BUFFER, 0, size, flags));
+
+    if (!m_mapping)
+    {
+        sf::err() << "Failed to map the streaming vertex buffer persistently, falling back to orphaning" << std::endl;
+        m_persistent = false;
+        return allocate(m_segmentCapacity);
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void StreamingVertexRing::release()
+{
+    for (gl::GLsync& fence : m_fences)
+    {
+        if (fence)
+            gl::DeleteSync(fence);
+        fence = nullptr;
+    }
+
+    // Deleting a buffer unmaps it; the driver keeps the storage alive until the GPU is done with it
+    if (m_buffer)
+        gl::DeleteBuffers(1, &m_buffer);
+
+    m_buffer  = 0;
+    m_mapping = nullptr;
+}
+
+
+////////////////////////////////////////////////////////////
+void StreamingVertexRing::advance()
+{
+    if (!m_buffer)
+        return;
+
+    if (!m_persistent)
+    {
+        m_segment = (m_segment + 1) % SegmentCount;
+        m_offset  = 0;
+
+        // Wrapping around: give the driver fresh storage instead of waiting for the old one
+        if (m_segment == 0)
+        {
+            gl::BindBuffer(gl::ARRAY_BUFFER, m_buffer);
+            gl::BufferData(gl::ARRAY_BUFFER,
+                           static_cast<gl::GLsizeiptr>(SegmentCount * m_segmentCapacity * sizeof(sf::Vertex)),
+                           nullptr,
+                           gl::STREAM_DRAW);
+            ++m_statistics.orphans;
+        }
+
+        return;
+    }
+
+    m_fences[m_segment] = gl::FenceSync(gl::SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_segment           = (m_segment + 1) % SegmentCount;
+    m_offset            = 0;
+
+    const gl::GLsync fence = m_fences[m_segment];
+    if (!fence)
+        return;
+
+    gl::GLenum status = gl::ClientWaitSync(fence, 0, 0);
+
+    if (status == gl::TIMEOUT_EXPIRED)
+    {
+        // The GPU is more than two segments behind: block until it catches up
+        sf::Clock clock;
+        do
+        {
+            status = gl::ClientWaitSync(fence, gl::SYNC_FLUSH_COMMANDS_BIT, fenceTimeout);
+        } while (status == gl::TIMEOUT_EXPIRED);
+
+        ++m_statistics.fenceWaits;
+        m_statistics.fenceWaitTime += clock.getElapsedTime();
+    }
+
+    if (status == gl::WAIT_FAILED)
+        sf::err() << "Failed to wait for the streaming vertex buffer's fence" << std::endl;
+
+    gl::DeleteSync(fence);
+    m_fences[m_segment] = nullptr;
+}
+
+} // namespace pong
@@ -0,0 +1,208 @@
+#pragma once
+
+#include "GlFunctions.hpp"
+#include "sfml.h"
+
+#include <cstddef>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Triple-buffered vertex buffer for per-frame geometry
+///
+/// The buffer is split into three segments; each frame writes
+/// into the next one, so the CPU fills frame N + 2 while the
+/// GPU may still read frames N and N + 1.
+///
+/// With OpenGL 4.4 or ARB_buffer_storage, the buffer is
+/// created immutable and mapped once, persistently and
+/// coherently: map() simply returns a pointer into it, and a
+/// fence placed when a segment is retired tells when the GPU
+/// is done with it. Without it, the buffer is orphaned each
+/// time writing wraps around to the first segment and ranges
+/// are mapped unsynchronized, which gives the same guarantees
+/// at the cost of one map/unmap per range.
+///
+/// If a single range doesn't fit in the rest of the current
+/// segment, writing moves on to the next segment early; if it
+/// doesn't fit in a segment at all, the buffer is recreated
+/// with bigger segments and getGeneration() changes. The new
+/// buffer may well get the name of the old one back, so a
+/// change of getBuffer() alone doesn't tell.
+///
+/// All functions must be called with the context that created
+/// the ring active. The buffer is left bound to ARRAY_BUFFER
+/// by create(), map() and unmap().
+///
+/// Usage example:
+/// \code
+/// ring.nextFrame(); // once per frame, before the first map()
+/// sf::Vertex* vertices = ring.map(6);
+/// // write up to 6 vertices...
+/// const pong::gl::GLint first = ring.unmap(6);
+/// pong::gl::DrawArrays(pong::gl::TRIANGLES, first, 6);
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class StreamingVertexRing
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Counters accumulated since the last call to resetStatistics
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Statistics
+    {
+        std::size_t frames{};        //!< Number of calls to nextFrame
+        std::size_t bytesStreamed{}; //!< Number of bytes written through map/unmap
+        std::size_t fenceWaits{};    //!< Number of times a segment wasn't released by the GPU yet
+        sf::Time    fenceWaitTime;   //!< Time spent waiting for those segments
+        std::size_t orphans{};       //!< Number of times the buffer was orphaned or recreated
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// The buffer is created by create().
+    ///
+    ////////////////////////////////////////////////////////////
+    StreamingVertexRing() = default;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destructor
+    ///
+    /// The context that created the ring must be active.
+    ///
+    ////////////////////////////////////////////////////////////
+    ~StreamingVertexRing();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    StreamingVertexRing(const StreamingVertexRing&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy assignment
+    ///
+    ////////////////////////////////////////////////////////////
+    StreamingVertexRing& operator=(const StreamingVertexRing&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the buffer
+    ///
+    /// \param segmentCapacity Number of vertices each of the three segments can hold
+    /// \param persistent      Use a persistent mapping if supported, pass false to force orphaning
+    ///
+    /// \return True if successful
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool create(std::size_t segmentCapacity, bool persistent = true);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether the buffer is persistently mapped
+    ///
+    ////////////////////////////////////////////////////////////
+    bool isPersistent() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the OpenGL buffer
+    ///
+    /// May change when the buffer has to grow, see getGeneration().
+    ///
+    ////////////////////////////////////////////////////////////
+    gl::GLuint getBuffer() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of times the buffer was created
+    ///
+    /// Changes when the buffer has to grow, even if getBuffer()
+    /// doesn't: deleting the old buffer detached it from the
+    /// vertex arrays it was bound to, so vertex attribute
+    /// pointers must be set up again.
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getGeneration() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Retire the current segment and start writing the next one
+    ///
+    /// Waits for the GPU to release the next segment if needed.
+    ///
+    ////////////////////////////////////////////////////////////
+    void nextFrame();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reserve room for vertices
+    ///
+    /// The returned memory may be write-combined: write it
+    /// sequentially and never read it back. Only one range can
+    /// be mapped at a time.
+    ///
+    /// \param vertexCount Maximum number of vertices that will be written
+    ///
+    /// \return Pointer to write the vertices to, or null if the buffer couldn't be mapped
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Vertex* map(std::size_t vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Make the vertices written since map() available for drawing
+    ///
+    /// \param vertexCount Number of vertices actually written, at most the count passed to map()
+    ///
+    /// \return Index of the first vertex in the buffer
+    ///
+    ////////////////////////////////////////////////////////////
+    gl::GLint unmap(std::size_t vertexCount);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the counters
+    ///
+    ////////////////////////////////////////////////////////////
+    const Statistics& getStatistics() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Reset the counters to zero
+    ///
+    ////////////////////////////////////////////////////////////
+    void resetStatistics();
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Create the buffer object, with mapping and fences reset
+    ///
+    ////////////////////////////////////////////////////////////
+    bool allocate(std::size_t segmentCapacity);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Destroy the buffer object and its fences
+    ///
+    ////////////////////////////////////////////////////////////
+    void release();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Fence the current segment and move to the next one
+    ///
+    ////////////////////////////////////////////////////////////
+    void advance();
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    static constexpr std::size_t SegmentCount{3}; // NOLINT(readability-identifier-naming)
+
+    gl::GLuint  m_buffer{};               //!< Buffer holding all the segments
+    bool        m_persistent{};           //!< Is m_mapping a persistent mapping?
+    sf::Vertex* m_mapping{};              //!< Persistent mapping of the whole buffer
+    std::size_t m_segmentCapacity{};      //!< Number of vertices per segment
+    std::size_t m_segment{};              //!< Segment being written
+    std::size_t m_offset{};               //!< Next free vertex in the current segment
+    std::size_t m_mapped{};               //!< Vertex count of the range currently mapped, 0 if none
+    std::size_t m_generation{};           //!< Number of times m_buffer was created
+    gl::GLsync  m_fences[SegmentCount]{}; //!< Fences placed when each segment was retired
+    Statistics  m_statistics;             //!< Counters
+};
+
+} // namespace pong
@@ -0,0 +1,106 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <exception>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+ThreadPool::ThreadPool(std::size_t threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // The caller is thread 0
+    for (std::size_t i = 1; i < threadCount; ++i)
+        m_threads.emplace_back(&ThreadPool::work, this, i);
+}
+
+
+////////////////////////////////////////////////////////////
+ThreadPool::~ThreadPool()
+{
+    {
+        const std::lock_guard lock(m_mutex);
+        m_running = false;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& thread : m_threads)
+        thread.join();
+}
+
+
+////////////////////////////////////////////////////////////
+void ThreadPool::run(const std::function<void(std::size_t)>& job)
+{
+    {
+        const std::lock_guard lock(m_mutex);
+        m_job  = &job;
+        m_busy = m_threads.size();
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    // The workers still run the job if it throws here: wait for
+    // them before the exception leaves the caller's stack frame
+    std::exception_ptr error;
+    try
+    {
+        job(0);
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    {
+        std::unique_lock lock(m_mutex);
+        m_done.wait(lock, [this] { return m_busy == 0; });
+        m_job = nullptr;
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+
+////////////////////////////////////////////////////////////
+std::size_t ThreadPool::getThreadCount() const
+{
+    return m_threads.size() + 1;
+}
+
+
+////////////////////////////////////////////////////////////
+void ThreadPool::work(std::size_t index)
+{
+    std::uint64_t generation = 0;
+
+    for (;;)
+    {
+        const std::function<void(std::size_t)>* job = nullptr;
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [&] { return (m_generation != generation) || !m_running; });
+            if (!m_running)
+                return;
+
+            generation = m_generation;
+            job        = m_job;
+        }
+
+        (*job)(index);
+
+        bool last = false;
+        {
+            const std::lock_guard lock(m_mutex);
+            last = (--m_busy == 0);
+        }
+        if (last)
+            m_done.notify_one();
+    }
+}
+
+} // namespace pong
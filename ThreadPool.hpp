@@ -0,0 +1,105 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Fixed set of worker threads running one job at a time
+///
+/// The threads are started once and sleep between jobs, so
+/// that short parallel jobs (a few milliseconds) don't pay for
+/// creating threads. A job runs on every worker and on the
+/// calling thread, each with its own index; splitting the work
+/// between them is up to the job, typically through an atomic
+/// counter.
+///
+/// Usage example:
+/// \code
+/// pong::ThreadPool pool;
+/// std::atomic<std::size_t> next{0};
+/// pool.run([&](std::size_t /* thread */)
+/// {
+///     for (std::size_t i = next++; i < count; i = next++)
+///         simulate(i);
+/// });
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class ThreadPool
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Start the worker threads
+    ///
+    /// \param threadCount Number of threads running each job, including
+    ///                    the caller; 0 for one per hardware thread
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit ThreadPool(std::size_t threadCount = 0);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Stop the worker threads
+    ///
+    ////////////////////////////////////////////////////////////
+    ~ThreadPool();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy constructor
+    ///
+    ////////////////////////////////////////////////////////////
+    ThreadPool(const ThreadPool&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Deleted copy assignment
+    ///
+    ////////////////////////////////////////////////////////////
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Run a job on every thread and wait until all of them return
+    ///
+    /// If the job throws on the calling thread, the exception is
+    /// rethrown once the workers have returned too. It must not
+    /// throw on the workers.
+    ///
+    /// \param job Function called once per thread with the index of
+    ///            the thread, in [0, getThreadCount()); the caller is 0
+    ///
+    ////////////////////////////////////////////////////////////
+    void run(const std::function<void(std::size_t)>& job);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of threads running each job, including the caller
+    ///
+    ////////////////////////////////////////////////////////////
+    std::size_t getThreadCount() const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Body of a worker thread
+    ///
+    ////////////////////////////////////////////////////////////
+    void work(std::size_t index);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::vector<std::thread>                m_threads;       //!< Worker threads
+    std::mutex                              m_mutex;         //!< Protects the members below
+    std::condition_variable                 m_wake;          //!< Signals a new job or the end of the pool
+    std::condition_variable                 m_done;          //!< Signals that the last worker finished the job
+    const std::function<void(std::size_t)>* m_job{};         //!< Job being run, if any
+    std::uint64_t                           m_generation{};  //!< Number of jobs started, so that workers run each one once
+    std::size_t                             m_busy{};        //!< Number of workers still running the job
+    bool                                    m_running{true}; //!< False when the pool is being destroyed
+};
+
+} // namespace pong
@@ -0,0 +1,311 @@
+#include "TileMap.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Animation times are counted in ticks of 1/60 s, so that a
+// frame duration fits in a color channel.
+////////////////////////////////////////////////////////////
+constexpr float ticksPerSecond = 60.f;
+
+
+////////////////////////////////////////////////////////////
+// The vertex color holds 255 - (frame count - 1) in red and
+// 255 - (ticks per frame - 1) in green, so that static tiles
+// are white and still look right without the shader. The
+// frames follow each other horizontally in the tileset.
+////////////////////////////////////////////////////////////
+constexpr const char* fragmentShaderSource = R"(
+#version 120
+
+uniform sampler2D tileset;
+uniform float     time;
+uniform float     frameOffset;
+
+void main()
+{
+    vec2  animation = floor((1.0 - gl_Color.rg) * 255.0 + 0.5) + 1.0;
+    float frame     = mod(floor(time / animation.y), animation.x);
+
+    gl_FragColor = texture2D(tileset, gl_TexCoord[0].xy + vec2(frame * frameOffset, 0.0));
+}
+)";
+
+
+////////////////////////////////////////////////////////////
+// Vertex color encoding an animation, see the shader
+////////////////////////////////////////////////////////////
+sf::Color encodeAnimation(unsigned int frameCount, sf::Time frameDuration)
+{
+    const auto frames = std::clamp(frameCount, 1u, 256u);
+    const auto ticks  = std::clamp(std::lround(frameDuration.asSeconds() * ticksPerSecond), 1l, 256l);
+
+    return sf::Color(static_cast<std::uint8_t>(256 - frames), static_cast<std::uint8_t>(256 - ticks), 255);
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+bool TileMap::create(const sf::Texture&   tileset,
+                     const sf::Vector2u&  tileSize,
+                     const sf::Vector2u&  mapSize,
+                     const std::uint16_t* tiles,
+                     const sf::Vector2u&  chunkSize)
+{
+    if ((tileSize.x == 0) || (tileSize.y == 0) || (chunkSize.x == 0) || (chunkSize.y == 0))
+    {
+        sf::err() << "Failed to create the tile map: tiles and chunks can't be empty" << std::endl;
+        return false;
+    }
+
+    const sf::Vector2u tilesetSize = tileset.getSize();
+    const std::size_t  tileCount   = (tilesetSize.x / tileSize.x) * (tilesetSize.y / tileSize.y);
+    if (tileCount == 0)
+    {
+        sf::err() << "Failed to create the tile map: the tileset is smaller than a tile" << std::endl;
+        return false;
+    }
+
+    m_tileset    = &tileset;
+    m_tileSize   = tileSize;
+    m_mapSize    = mapSize;
+    m_chunkSize  = chunkSize;
+    m_chunkCount = {(mapSize.x + chunkSize.x - 1) / chunkSize.x, (mapSize.y + chunkSize.y - 1) / chunkSize.y};
+
+    const std::size_t cellCount = static_cast<std::size_t>(mapSize.x) * mapSize.y;
+    if (tiles)
+        m_tiles.assign(tiles, tiles + cellCount);
+    else
+        m_tiles.assign(cellCount, Empty);
+
+    // Tile indices at or past Empty can't be referenced
+    m_animations.assign(std::min<std::size_t>(tileCount, Empty), sf::Color::White);
+
+    m_useBuffers = sf::VertexBuffer::isAvailable();
+    m_chunks.assign(static_cast<std::size_t>(m_chunkCount.x) * m_chunkCount.y, Chunk());
+    for (Chunk& chunk : m_chunks)
+    {
+        chunk.buffer.setPrimitiveType(sf::PrimitiveType::Triangles);
+        chunk.buffer.setUsage(sf::VertexBuffer::Usage::Static);
+    }
+
+    // Without the shader, animated tiles are simply frozen
+    m_animated = sf::Shader::isAvailable() && m_shader.loadFromMemory(fragmentShaderSource, sf::Shader::Type::Fragment);
+    if (m_animated)
+    {
+        m_shader.setUniform("tileset", sf::Shader::CurrentTexture);
+        m_shader.setUniform("frameOffset", static_cast<float>(tileSize.x) / static_cast<float>(tilesetSize.x));
+    }
+
+    for (unsigned int y = 0; y < m_chunkCount.y; ++y)
+        for (unsigned int x = 0; x < m_chunkCount.x; ++x)
+            bakeChunk({x, y});
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::setTile(const sf::Vector2u& position, std::uint16_t tile)
+{
+    assert((position.x < m_mapSize.x) && (position.y < m_mapSize.y) && "Tile position out of range");
+
+    std::uint16_t& cell = m_tiles[static_cast<std::size_t>(position.y) * m_mapSize.x + position.x];
+    if (cell == tile)
+        return;
+
+    cell = tile;
+    bakeChunk({position.x / m_chunkSize.x, position.y / m_chunkSize.y});
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint16_t TileMap::getTile(const sf::Vector2u& position) const
+{
+    assert((position.x < m_mapSize.x) && (position.y < m_mapSize.y) && "Tile position out of range");
+
+    return m_tiles[static_cast<std::size_t>(position.y) * m_mapSize.x + position.x];
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::setAnimation(std::uint16_t tile, unsigned int frameCount, sf::Time frameDuration)
+{
+    assert((tile < m_animations.size()) && "Tile index out of range");
+    assert((tile % (m_tileset->getSize().x / m_tileSize.x) + frameCount <= m_tileset->getSize().x / m_tileSize.x) &&
+           "Animation frames must be on the same row of the tileset");
+
+    m_animations[tile] = encodeAnimation(frameCount, frameDuration);
+
+    for (unsigned int y = 0; y < m_chunkCount.y; ++y)
+        for (unsigned int x = 0; x < m_chunkCount.x; ++x)
+            bakeChunk({x, y});
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::setTime(sf::Time time)
+{
+    m_time = time.asSeconds() * ticksPerSecond;
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::record(RenderCommandBuffer& frame, const sf::View& view, const sf::RenderStates& states) const
+{
+    const sf::IntRect visible = getVisibleChunks(view, states.transform);
+    if ((visible.width <= 0) || (visible.height <= 0))
+        return;
+
+    if (m_animated)
+        frame.setUniform(m_shader, "time", m_time);
+
+    const sf::RenderStates chunkStates = getStates(states);
+    for (int y = visible.top; y < visible.top + visible.height; ++y)
+    {
+        for (int x = visible.left; x < visible.left + visible.width; ++x)
+        {
+            const Chunk& chunk = m_chunks[static_cast<std::size_t>(y) * m_chunkCount.x + static_cast<std::size_t>(x)];
+            if (chunk.vertexCount == 0)
+                continue;
+
+            if (m_useBuffers)
+                frame.draw(chunk.buffer, 0, chunk.vertexCount, chunkStates);
+            else
+                frame.draw(chunk.vertices.data(), chunk.vertexCount, sf::PrimitiveType::Triangles, chunkStates);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+sf::IntRect TileMap::getVisibleChunks(const sf::View& view, const sf::Transform& transform) const
+{
+    if (m_chunks.empty())
+        return {};
+
+    // Bounds of the view in world coordinates, then in the map's local coordinates
+    const sf::FloatRect viewBounds = view.getInverseTransform().transformRect(sf::FloatRect({-1.f, -1.f}, {2.f, 2.f}));
+    const sf::FloatRect bounds     = transform.getInverse().transformRect(viewBounds);
+
+    // Divide rather than test every chunk; clamping in float also keeps huge views in int range
+    const sf::Vector2f chunkSize(static_cast<float>(m_chunkSize.x * m_tileSize.x),
+                                 static_cast<float>(m_chunkSize.y * m_tileSize.y));
+    const auto toChunk = [](float coordinate, unsigned int count) {
+        return static_cast<int>(std::clamp(coordinate, 0.f, static_cast<float>(count)));
+    };
+
+    const int left   = toChunk(std::floor(bounds.left / chunkSize.x), m_chunkCount.x);
+    const int top    = toChunk(std::floor(bounds.top / chunkSize.y), m_chunkCount.y);
+    const int right  = toChunk(std::ceil((bounds.left + bounds.width) / chunkSize.x), m_chunkCount.x);
+    const int bottom = toChunk(std::ceil((bounds.top + bounds.height) / chunkSize.y), m_chunkCount.y);
+
+    return sf::IntRect({left, top}, {right - left, bottom - top});
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Vector2f TileMap::getSize() const
+{
+    return {static_cast<float>(m_mapSize.x * m_tileSize.x), static_cast<float>(m_mapSize.y * m_tileSize.y)};
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::draw(sf::RenderTarget& target, const sf::RenderStates& states) const
+{
+    const sf::IntRect visible = getVisibleChunks(target.getView(), states.transform);
+    if ((visible.width <= 0) || (visible.height <= 0))
+        return;
+
+    if (m_animated)
+        m_shader.setUniform("time", m_time);
+
+    const sf::RenderStates chunkStates = getStates(states);
+    for (int y = visible.top; y < visible.top + visible.height; ++y)
+    {
+        for (int x = visible.left; x < visible.left + visible.width; ++x)
+        {
+            const Chunk& chunk = m_chunks[static_cast<std::size_t>(y) * m_chunkCount.x + static_cast<std::size_t>(x)];
+            if (chunk.vertexCount == 0)
+                continue;
+
+            if (m_useBuffers)
+                target.draw(chunk.buffer, 0, chunk.vertexCount, chunkStates);
+            else
+                target.draw(chunk.vertices.data(), chunk.vertexCount, sf::PrimitiveType::Triangles, chunkStates);
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void TileMap::bakeChunk(const sf::Vector2u& chunk)
+{
+    const sf::Vector2u first(chunk.x * m_chunkSize.x, chunk.y * m_chunkSize.y);
+    const sf::Vector2u last(std::min(first.x + m_chunkSize.x, m_mapSize.x), std::min(first.y + m_chunkSize.y, m_mapSize.y));
+    const unsigned int columns = m_tileset->getSize().x / m_tileSize.x;
+    const sf::Vector2f tileSize(m_tileSize);
+
+    // Two triangles per tile; the tiles already cover the chunk, so nothing is shared between them
+    m_scratch.clear();
+    for (unsigned int y = first.y; y < last.y; ++y)
+    {
+        for (unsigned int x = first.x; x < last.x; ++x)
+        {
+            const std::uint16_t tile = m_tiles[static_cast<std::size_t>(y) * m_mapSize.x + x];
+            if (tile >= m_animations.size())
+                continue;
+
+            const sf::Color    color = m_animations[tile];
+            const sf::Vector2f position(static_cast<float>(x) * tileSize.x, static_cast<float>(y) * tileSize.y);
+            const sf::Vector2f texCoords(static_cast<float>(tile % columns) * tileSize.x,
+                                         static_cast<float>(tile / columns) * tileSize.y);
+
+            const sf::Vertex topLeft{position, color, texCoords};
+            const sf::Vertex topRight{{position.x + tileSize.x, position.y}, color, {texCoords.x + tileSize.x, texCoords.y}};
+            const sf::Vertex bottomLeft{{position.x, position.y + tileSize.y}, color, {texCoords.x, texCoords.y + tileSize.y}};
+            const sf::Vertex bottomRight{position + tileSize, color, texCoords + tileSize};
+
+            m_scratch.insert(m_scratch.end(), {topLeft, topRight, bottomLeft, bottomLeft, topRight, bottomRight});
+        }
+    }
+
+    Chunk& target      = m_chunks[static_cast<std::size_t>(chunk.y) * m_chunkCount.x + chunk.x];
+    target.vertexCount = m_scratch.size();
+
+    if (!m_useBuffers)
+    {
+        target.vertices = m_scratch;
+        return;
+    }
+
+    if (m_scratch.empty())
+        return;
+
+    if (((target.buffer.getVertexCount() != m_scratch.size()) && !target.buffer.create(m_scratch.size())) ||
+        !target.buffer.update(m_scratch.data()))
+    {
+        sf::err() << "Failed to upload a tile map chunk" << std::endl;
+        target.vertexCount = 0;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+sf::RenderStates TileMap::getStates(const sf::RenderStates& states) const
+{
+    sf::RenderStates result = states;
+    result.texture          = m_tileset;
+    result.shader           = m_animated ? &m_shader : nullptr;
+    return result;
+}
+
+} // namespace pong
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "RenderCommandBuffer.hpp"
+#include "sfml.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Static tile layer for arena backgrounds
+///
+/// The map is split into chunks of chunkSize tiles, each baked
+/// once into a static sf::VertexBuffer as a triangle list.
+/// Drawing only visits the chunks overlapping the view, found
+/// by dividing the view's bounds by the chunk size rather than
+/// by testing every chunk, so the cost of a frame depends on
+/// the screen size and not on the map size.
+///
+/// Animated tiles never touch the geometry: the frames of an
+/// animation are stored next to each other in the tileset,
+/// and the frame count and duration are baked into the color
+/// of the tile's vertices. A fragment shader offsets the
+/// texture coordinates to the current frame from a single time
+/// uniform, set once per frame. Tiles are not tinted.
+///
+/// When vertex buffers are not supported, chunks are kept as
+/// vertex arrays; when shaders are not supported, animated
+/// tiles show their first frame. The shader requires a
+/// compatibility context.
+///
+/// Usage example:
+/// \code
+/// pong::TileMap background;
+/// if (!background.create(tileset, {8, 8}, {256, 256}, tiles.data()))
+///     return;
+///
+/// background.setAnimation(water, 4, sf::milliseconds(250));
+///
+/// // Every frame
+/// background.setTime(clock.getElapsedTime());
+/// frame.setLayer(-1);
+/// background.record(frame, window.getDefaultView());
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class TileMap : public sf::Drawable
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Tile index of cells drawing nothing
+    ///
+    ////////////////////////////////////////////////////////////
+    static constexpr std::uint16_t Empty{0xFFFF}; // NOLINT(readability-identifier-naming)
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Build the map and bake its chunks
+    ///
+    /// Tiles are numbered from left to right and top to bottom in
+    /// the tileset, in cells of tileSize pixels.
+    ///
+    /// \param tileset   Texture holding the tiles, must outlive the map
+    /// \param tileSize  Size of a tile, in pixels
+    /// \param mapSize   Size of the map, in tiles
+    /// \param tiles     mapSize.x * mapSize.y tile indices in row-major order, or null for an empty map
+    /// \param chunkSize Size of a chunk, in tiles
+    ///
+    /// \return True on success
+    ///
+    ////////////////////////////////////////////////////////////
+    [[nodiscard]] bool create(const sf::Texture&   tileset,
+                              const sf::Vector2u&  tileSize,
+                              const sf::Vector2u&  mapSize,
+                              const std::uint16_t* tiles     = nullptr,
+                              const sf::Vector2u&  chunkSize = {16, 16});
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Change a tile
+    ///
+    /// Rebakes the tile's chunk.
+    ///
+    /// \param position Position of the tile in the map, in tiles
+    /// \param tile     Tile index, or Empty
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTile(const sf::Vector2u& position, std::uint16_t tile);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get a tile
+    ///
+    /// \param position Position of the tile in the map, in tiles
+    ///
+    /// \return Tile index, or Empty
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint16_t getTile(const sf::Vector2u& position) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Animate a tile
+    ///
+    /// The frames are the tile and the frameCount - 1 tiles to
+    /// its right in the tileset. Rebakes every chunk: call it
+    /// while setting the map up, not every frame.
+    ///
+    /// \param tile          Index of the first frame
+    /// \param frameCount    Number of frames, in [1, 256]; 1 stops the animation
+    /// \param frameDuration Duration of a frame, rounded to 1/60 s, at most 256/60 s
+    ///
+    ////////////////////////////////////////////////////////////
+    void setAnimation(std::uint16_t tile, unsigned int frameCount, sf::Time frameDuration);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Set the time the animations are shown at
+    ///
+    /// Only stores the time: the uniform is set when the map is
+    /// drawn or replayed.
+    ///
+    /// \param time Time since the animations started
+    ///
+    ////////////////////////////////////////////////////////////
+    void setTime(sf::Time time);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Record the chunks visible in a view into a command buffer
+    ///
+    /// The map must not be modified until the command buffer has
+    /// been replayed.
+    ///
+    /// \param frame  Command buffer to record into
+    /// \param view   View the frame will be drawn with
+    /// \param states Render states to use for drawing; the texture and shader are replaced
+    ///
+    ////////////////////////////////////////////////////////////
+    void record(RenderCommandBuffer& frame, const sf::View& view, const sf::RenderStates& states = sf::RenderStates::Default) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the chunks overlapping a view
+    ///
+    /// \param view      View to cull against
+    /// \param transform Transform the map is drawn with
+    ///
+    /// \return Range of visible chunks, in chunks; empty if none is visible
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::IntRect getVisibleChunks(const sf::View& view, const sf::Transform& transform = sf::Transform::Identity) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the size of the map, in pixels
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Vector2f getSize() const;
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Draw the chunks visible in the target's view
+    ///
+    /// \param target Render target to draw to
+    /// \param states Current render states
+    ///
+    ////////////////////////////////////////////////////////////
+    void draw(sf::RenderTarget& target, const sf::RenderStates& states) const override;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Rebuild the geometry of a chunk from the tiles
+    ///
+    ////////////////////////////////////////////////////////////
+    void bakeChunk(const sf::Vector2u& chunk);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the states a draw of the map uses
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::RenderStates getStates(const sf::RenderStates& states) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Geometry of a chunk
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Chunk
+    {
+        sf::VertexBuffer        buffer;        //!< Baked vertices
+        std::vector<sf::Vertex> vertices;      //!< Baked vertices, when vertex buffers are not supported
+        std::size_t             vertexCount{}; //!< Number of vertices of the chunk
+    };
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    const sf::Texture*         m_tileset{};    //!< Texture holding the tiles
+    sf::Vector2u               m_tileSize;     //!< Size of a tile, in pixels
+    sf::Vector2u               m_mapSize;      //!< Size of the map, in tiles
+    sf::Vector2u               m_chunkSize;    //!< Size of a chunk, in tiles
+    sf::Vector2u               m_chunkCount;   //!< Number of chunks in each direction
+    std::vector<std::uint16_t> m_tiles;        //!< Tile indices, in row-major order
+    std::vector<sf::Color>     m_animations;   //!< Animation of each tile of the tileset, as baked in the vertices
+    std::vector<Chunk>         m_chunks;       //!< Chunks, in row-major order
+    std::vector<sf::Vertex>    m_scratch;      //!< Vertices of the chunk being baked
+    bool                       m_useBuffers{}; //!< Are the chunks stored in vertex buffers?
+    bool                       m_animated{};   //!< Was the animation shader compiled?
+    mutable sf::Shader         m_shader;       //!< Shader selecting the animation frames
+    float                      m_time{};       //!< Animation time, in 1/60 s
+};
+
+} // namespace pong
@@ -0,0 +1,471 @@
+#include "Tournament.hpp"
+
+#include "AimNoise.hpp"
+#include "BinaryIo.hpp"
+#include "Match.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <numeric>
+#include <system_error>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// File format, all little-endian, after the header:
+//   settings and rounds played (41 bytes)
+//   u16 entrant count, then for each: u8 name length, name,
+//     f32 dead zone, reaction delay, aim bias and speed
+//   u32 game count, then for each: u16 round, left, right,
+//     u8 scores, u32 ticks (12 bytes)
+////////////////////////////////////////////////////////////
+constexpr char         fileMagic[] = "PONGTRN";
+constexpr std::uint8_t fileVersion = 2;
+constexpr std::size_t  maxEntrants = 0xFFFF;
+
+
+////////////////////////////////////////////////////////////
+// Play a game to the end, or to the tick limit; its random
+// numbers are the stream of the game's index in the
+// tournament's seed
+////////////////////////////////////////////////////////////
+void playGame(pong::Tournament::Game&           game,
+              const pong::PaddleAi&             left,
+              const pong::PaddleAi&             right,
+              const pong::Tournament::Settings& settings,
+              std::uint64_t                     index)
+{
+    const pong::MatchDefinitions::State state = pong::playNoisyMatch(left,
+                                                                     right,
+                                                                     settings.aimError,
+                                                                     settings.aimTicks,
+                                                                     settings.maxTicks,
+                                                                     settings.seed,
+                                                                     index);
+
+    game.scores[pong::MatchDefinitions::Left]  = static_cast<std::uint8_t>(std::min(state.scores[0], 255u));
+    game.scores[pong::MatchDefinitions::Right] = static_cast<std::uint8_t>(std::min(state.scores[1], 255u));
+    game.ticks                                 = state.tick;
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+Tournament::Tournament(ThreadPool& pool) : Tournament(pool, Settings())
+{
+}
+
+
+////////////////////////////////////////////////////////////
+Tournament::Tournament(ThreadPool& pool, const Settings& settings) :
+m_pool(pool),
+m_settings(settings),
+m_roundsPlayed(0)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+bool Tournament::addEntrant(const std::string& name, const PaddleAi::Parameters& parameters)
+{
+    if ((m_roundsPlayed > 0) || (m_entrants.size() >= maxEntrants))
+        return false;
+
+    Entrant entrant;
+    entrant.name       = name;
+    entrant.parameters = parameters;
+    entrant.rating     = m_settings.initialRating;
+    m_entrants.push_back(entrant);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Tournament::playRound()
+{
+    if (m_roundsPlayed >= getRoundCount())
+        return false;
+
+    // Each pairing plays its games with alternating sides
+    std::vector<Game> games;
+    for (const auto& [first, second] : pairEntrants())
+    {
+        Game game{};
+        game.round = static_cast<std::uint16_t>(m_roundsPlayed);
+
+        if (first == second)
+        {
+            game.left = game.right = first;
+            games.push_back(game);
+            continue;
+        }
+
+        for (std::uint32_t i = 0; i < m_settings.gamesPerPairing; ++i)
+        {
+            game.left  = (i % 2 == 0) ? first : second;
+            game.right = (i % 2 == 0) ? second : first;
+            games.push_back(game);
+        }
+    }
+
+    std::vector<PaddleAi> players;
+    players.reserve(m_entrants.size());
+    for (const Entrant& entrant : m_entrants)
+        players.emplace_back(entrant.parameters);
+
+    const std::size_t        firstIndex = m_games.size();
+    std::atomic<std::size_t> next{0};
+    m_pool.run(
+        [&](std::size_t /* thread */)
+        {
+            for (std::size_t i = next++; i < games.size(); i = next++)
+            {
+                Game& game = games[i];
+                if (game.left != game.right)
+                    playGame(game, players[game.left], players[game.right], m_settings, firstIndex + i);
+            }
+        });
+
+    // Ratings are updated in the order of the games, whichever finished first
+    for (const Game& game : games)
+    {
+        m_games.push_back(game);
+        rate(game);
+    }
+
+    ++m_roundsPlayed;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+void Tournament::play()
+{
+    while (playRound())
+    {
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint32_t Tournament::getRoundCount() const
+{
+    const auto count = static_cast<std::uint32_t>(m_entrants.size());
+    if (count < 2)
+        return 0;
+
+    if (m_settings.format == Format::RoundRobin)
+        return count + (count % 2) - 1;
+
+    if (m_settings.rounds > 0)
+        return m_settings.rounds;
+
+    return static_cast<std::uint32_t>(std::ceil(std::log2(static_cast<double>(count))));
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint32_t Tournament::getRoundsPlayed() const
+{
+    return m_roundsPlayed;
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<Tournament::Entrant>& Tournament::getEntrants() const
+{
+    return m_entrants;
+}
+
+
+////////////////////////////////////////////////////////////
+const std::vector<Tournament::Game>& Tournament::getGames() const
+{
+    return m_games;
+}
+
+
+////////////////////////////////////////////////////////////
+const Tournament::Settings& Tournament::getSettings() const
+{
+    return m_settings;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Tournament::saveToFile(const std::filesystem::path& filename) const
+{
+    std::filesystem::path temporary = filename;
+    temporary += ".tmp";
+
+    std::ofstream file(temporary, std::ios::binary);
+    if (!file)
+    {
+        sf::err() << "Failed to open tournament file " << temporary << " for writing" << std::endl;
+        return false;
+    }
+
+    using binary::write;
+    binary::writeHeader(file, fileMagic, fileVersion);
+
+    write(file, static_cast<std::uint8_t>(m_settings.format));
+    write(file, m_settings.rounds);
+    write(file, m_settings.gamesPerPairing);
+    write(file, m_settings.kFactor);
+    write(file, m_settings.initialRating);
+    write(file, m_settings.aimError);
+    write(file, m_settings.aimTicks);
+    write(file, m_settings.maxTicks);
+    write(file, m_settings.seed);
+    write(file, m_roundsPlayed);
+
+    write(file, static_cast<std::uint16_t>(m_entrants.size()));
+    for (const Entrant& entrant : m_entrants)
+    {
+        write(file, entrant.name);
+        write(file, entrant.parameters.deadZone);
+        write(file, entrant.parameters.reactionDelay);
+        write(file, entrant.parameters.aimBias);
+        write(file, entrant.parameters.speed);
+    }
+
+    write(file, static_cast<std::uint32_t>(m_games.size()));
+    for (const Game& game : m_games)
+    {
+        write(file, game.round);
+        write(file, game.left);
+        write(file, game.right);
+        write(file, game.scores[MatchDefinitions::Left]);
+        write(file, game.scores[MatchDefinitions::Right]);
+        write(file, game.ticks);
+    }
+
+    std::error_code error;
+    file.close();
+    if (!file)
+    {
+        sf::err() << "Failed to write tournament file " << temporary << std::endl;
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+
+    // Replace the previous file only once the new one is complete
+    std::filesystem::rename(temporary, filename, error);
+    if (error)
+    {
+        sf::err() << "Failed to replace tournament file " << filename << ": " << error.message() << std::endl;
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+bool Tournament::loadFromFile(const std::filesystem::path& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        sf::err() << "Failed to open tournament file " << filename << std::endl;
+        return false;
+    }
+
+    using binary::read;
+    if (!binary::readHeader(file, fileMagic, fileVersion))
+    {
+        sf::err() << "Failed to load tournament file " << filename << ": not a version " << int{fileVersion}
+                  << " tournament file" << std::endl;
+        return false;
+    }
+
+    Settings      settings;
+    std::uint8_t  format       = 0;
+    std::uint32_t roundsPlayed = 0;
+    read(file, format);
+    read(file, settings.rounds);
+    read(file, settings.gamesPerPairing);
+    read(file, settings.kFactor);
+    read(file, settings.initialRating);
+    read(file, settings.aimError);
+    read(file, settings.aimTicks);
+    read(file, settings.maxTicks);
+    read(file, settings.seed);
+    read(file, roundsPlayed);
+    settings.format = static_cast<Format>(format);
+    if (format > static_cast<std::uint8_t>(Format::Swiss))
+        file.setstate(std::ios::failbit);
+
+    std::uint16_t entrantCount = 0;
+    read(file, entrantCount);
+    std::vector<Entrant> entrants(entrantCount);
+    for (Entrant& entrant : entrants)
+    {
+        read(file, entrant.name);
+        read(file, entrant.parameters.deadZone);
+        read(file, entrant.parameters.reactionDelay);
+        read(file, entrant.parameters.aimBias);
+        read(file, entrant.parameters.speed);
+        entrant.rating = settings.initialRating;
+    }
+
+    std::uint32_t gameCount = 0;
+    read(file, gameCount);
+    std::vector<Game> games;
+    for (std::uint32_t i = 0; (i < gameCount) && file; ++i)
+    {
+        Game game{};
+        read(file, game.round);
+        read(file, game.left);
+        read(file, game.right);
+        read(file, game.scores[MatchDefinitions::Left]);
+        read(file, game.scores[MatchDefinitions::Right]);
+        read(file, game.ticks);
+
+        if ((game.left >= entrantCount) || (game.right >= entrantCount) || (game.round >= roundsPlayed))
+            file.setstate(std::ios::failbit);
+
+        games.push_back(game);
+    }
+
+    if (!file)
+    {
+        sf::err() << "Failed to load tournament file " << filename << ": the file is truncated or corrupt" << std::endl;
+        return false;
+    }
+
+    m_settings     = settings;
+    m_entrants     = std::move(entrants);
+    m_games        = std::move(games);
+    m_roundsPlayed = roundsPlayed;
+    for (const Game& game : m_games)
+        rate(game);
+
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////
+std::vector<std::pair<std::uint16_t, std::uint16_t>> Tournament::pairEntrants() const
+{
+    const auto count = static_cast<std::uint16_t>(m_entrants.size());
+    std::vector<std::pair<std::uint16_t, std::uint16_t>> pairs;
+
+    if (m_settings.format == Format::RoundRobin)
+    {
+        // Circle method: the last entrant stays, the others rotate
+        // around it; with an odd count, the last one is a sit-out
+        const std::uint32_t size  = count + (count % 2);
+        const std::uint32_t round = m_roundsPlayed;
+        for (std::uint32_t i = 0; i < size / 2; ++i)
+        {
+            const std::uint32_t first  = (i == 0) ? size - 1 : (round + i) % (size - 1);
+            const std::uint32_t second = (round + size - 1 - i) % (size - 1);
+            if ((first < count) && (second < count))
+            {
+                if ((round + i) % 2 == 0)
+                    pairs.emplace_back(first, second);
+                else
+                    pairs.emplace_back(second, first);
+            }
+        }
+
+        return pairs;
+    }
+
+    // Swiss: rank by points then rating, and pair each entrant with
+    // the best ranked one it hasn't met yet, or the next one if it
+    // has met all of them
+    std::vector<bool>          met(std::size_t{count} * count);
+    std::vector<std::uint32_t> byes(count);
+    for (const Game& game : m_games)
+    {
+        if (game.left == game.right)
+            ++byes[game.left];
+
+        met[std::size_t{game.left} * count + game.right] = true;
+        met[std::size_t{game.right} * count + game.left] = true;
+    }
+
+    std::vector<std::uint16_t> ranking(count);
+    std::iota(ranking.begin(), ranking.end(), std::uint16_t{0});
+    std::stable_sort(ranking.begin(),
+                     ranking.end(),
+                     [this](std::uint16_t a, std::uint16_t b)
+                     {
+                         if (m_entrants[a].points != m_entrants[b].points)
+                             return m_entrants[a].points > m_entrants[b].points;
+                         return m_entrants[a].rating > m_entrants[b].rating;
+                     });
+
+    // The lowest ranked entrant with the fewest byes gets the bye
+    if (count % 2 == 1)
+    {
+        auto bye = ranking.rbegin();
+        for (auto it = ranking.rbegin(); it != ranking.rend(); ++it)
+        {
+            if (byes[*it] < byes[*bye])
+                bye = it;
+        }
+
+        pairs.emplace_back(*bye, *bye);
+        ranking.erase(std::next(bye).base());
+    }
+
+    while (!ranking.empty())
+    {
+        const std::uint16_t first = ranking.front();
+        const auto          unmet = [&](std::uint16_t other) { return !met[std::size_t{first} * count + other]; };
+
+        auto opponent = std::find_if(ranking.begin() + 1, ranking.end(), unmet);
+        if (opponent == ranking.end())
+            opponent = ranking.begin() + 1;
+
+        if (m_roundsPlayed % 2 == 0)
+            pairs.emplace_back(first, *opponent);
+        else
+            pairs.emplace_back(*opponent, first);
+
+        ranking.erase(opponent);
+        ranking.erase(ranking.begin());
+    }
+
+    return pairs;
+}
+
+
+////////////////////////////////////////////////////////////
+void Tournament::rate(const Game& game)
+{
+    Entrant& left = m_entrants[game.left];
+    if (game.left == game.right)
+    {
+        left.points += static_cast<float>(m_settings.gamesPerPairing);
+        return;
+    }
+
+    Entrant& right = m_entrants[game.right];
+    float    score = 0.5f;
+    if (game.scores[MatchDefinitions::Left] != game.scores[MatchDefinitions::Right])
+        score = (game.scores[MatchDefinitions::Left] > game.scores[MatchDefinitions::Right]) ? 1.f : 0.f;
+
+    const float expected = 1.f / (1.f + std::pow(10.f, (right.rating - left.rating) / 400.f));
+    const float change   = m_settings.kFactor * (score - expected);
+
+    left.rating += change;
+    right.rating -= change;
+    left.points += score;
+    right.points += 1.f - score;
+    ++left.games;
+    ++right.games;
+}
+
+} // namespace pong
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "PaddleAi.hpp"
+#include "ThreadPool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Tournament between computer player configurations
+///
+/// Entrants meet in rounds, either every one against every
+/// other (round-robin) or against entrants with similar scores
+/// (Swiss). The games of a round are played in parallel on a
+/// ThreadPool, as ClassicMatch with aim noise, then the Elo
+/// ratings are updated game by game, in the order of the games.
+///
+/// Game i draws its random numbers from Philox stream i of the
+/// tournament's seed only, so that a tournament plays the same
+/// way whatever the number of threads, including when it is
+/// resumed from a file.
+///
+/// Usage example:
+/// \code
+/// pong::ThreadPool pool;
+/// pong::Tournament tournament(pool);
+/// tournament.addEntrant("sharp", pong::PaddleAi::Parameters{2.f});
+/// tournament.addEntrant("sloppy", pong::PaddleAi::Parameters{12.f});
+/// tournament.play();
+///
+/// for (const pong::Tournament::Entrant& entrant : tournament.getEntrants())
+///     std::cout << entrant.name << ": " << entrant.rating << std::endl;
+///
+/// tournament.saveToFile("tournament.bin");
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class Tournament
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Pairing system
+    ///
+    ////////////////////////////////////////////////////////////
+    enum class Format : std::uint8_t
+    {
+        RoundRobin, //!< Every entrant meets every other once
+        Swiss       //!< Entrants meet others with the same score, never twice if possible
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Rules of the tournament
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Settings
+    {
+        Format        format{Format::RoundRobin}; //!< Pairing system
+        std::uint32_t rounds{};                    //!< Rounds of a Swiss tournament, 0 for log2 of the entrants
+        std::uint32_t gamesPerPairing{2};          //!< Games between two entrants in a round, alternating sides
+        float         kFactor{16.f};               //!< Largest rating change of a game
+        float         initialRating{1500.f};       //!< Rating of new entrants
+        float         aimError{24.f};              //!< Aim noise of the players, see AimNoise
+        std::uint32_t aimTicks{30};                //!< Ticks between changes of aim, see AimNoise
+        std::uint32_t maxTicks{60 * 60 * 10};      //!< Ticks after which a game is a draw
+        std::uint64_t seed{};                      //!< Seed of the games
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Player configuration and its standing
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Entrant
+    {
+        std::string          name;       //!< Name of the configuration, at most 255 bytes in files
+        PaddleAi::Parameters parameters; //!< Behavior of the player
+        float                rating{};   //!< Elo rating
+        float                points{};   //!< 1 per game won, 0.5 per draw; a bye counts as won games
+        std::uint32_t        games{};    //!< Games played
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Result of a game
+    ///
+    ////////////////////////////////////////////////////////////
+    struct Game
+    {
+        std::uint16_t round;     //!< Index of the round
+        std::uint16_t left;      //!< Index of the entrant playing the left side
+        std::uint16_t right;     //!< Index of the entrant playing the right side, the same for a Swiss bye
+        std::uint8_t  scores[2]; //!< Final score of each side
+        std::uint32_t ticks;     //!< Duration of the game, in ticks
+    };
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create an empty tournament with the default settings
+    ///
+    /// \param pool Threads to play the games on
+    ///
+    ////////////////////////////////////////////////////////////
+    explicit Tournament(ThreadPool& pool);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Create an empty tournament
+    ///
+    /// \param pool     Threads to play the games on
+    /// \param settings Rules of the tournament
+    ///
+    ////////////////////////////////////////////////////////////
+    Tournament(ThreadPool& pool, const Settings& settings);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Add an entrant, before the first round
+    ///
+    /// \return True if added, false if the tournament has started or is full
+    ///
+    ////////////////////////////////////////////////////////////
+    bool addEntrant(const std::string& name, const PaddleAi::Parameters& parameters);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Play the next round
+    ///
+    /// \return True if a round was played, false if the tournament is over
+    ///
+    ////////////////////////////////////////////////////////////
+    bool playRound();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Play all the remaining rounds
+    ///
+    ////////////////////////////////////////////////////////////
+    void play();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of rounds of the tournament
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint32_t getRoundCount() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of rounds played so far
+    ///
+    ////////////////////////////////////////////////////////////
+    std::uint32_t getRoundsPlayed() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the entrants, in the order they were added
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<Entrant>& getEntrants() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the results of the games played so far, in order
+    ///
+    ////////////////////////////////////////////////////////////
+    const std::vector<Game>& getGames() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the rules of the tournament
+    ///
+    ////////////////////////////////////////////////////////////
+    const Settings& getSettings() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Save the settings, entrants and results to a file
+    ///
+    /// The file is little-endian binary: a header with the
+    /// settings, the entrants' names and parameters, then 12
+    /// bytes per game. Standings aren't stored, they're replayed
+    /// from the games when loading.
+    ///
+    /// The file is written next to \a filename first, then
+    /// renamed over it, so an interrupted save leaves the
+    /// previous file intact.
+    ///
+    /// \return True if saved
+    ///
+    ////////////////////////////////////////////////////////////
+    bool saveToFile(const std::filesystem::path& filename) const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Replace the tournament with one saved to a file
+    ///
+    /// The loaded tournament can be resumed with playRound(),
+    /// and plays its remaining rounds as if it never stopped.
+    ///
+    /// \return True if loaded, false if the tournament is unchanged
+    ///
+    ////////////////////////////////////////////////////////////
+    bool loadFromFile(const std::filesystem::path& filename);
+
+private:
+    ////////////////////////////////////////////////////////////
+    /// \brief Pair the entrants for the next round
+    ///
+    /// \return Pairs of entrant indices; a bye is paired with itself
+    ///
+    ////////////////////////////////////////////////////////////
+    std::vector<std::pair<std::uint16_t, std::uint16_t>> pairEntrants() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Count the result of a game in the standings
+    ///
+    ////////////////////////////////////////////////////////////
+    void rate(const Game& game);
+
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    ThreadPool&          m_pool;         //!< Threads to play the games on
+    Settings             m_settings;     //!< Rules of the tournament
+    std::vector<Entrant> m_entrants;     //!< Entrants and their standings
+    std::vector<Game>    m_games;        //!< Results of the games played
+    std::uint32_t        m_roundsPlayed; //!< Number of rounds played
+};
+
+} // namespace pong
@@ -0,0 +1,215 @@
+#include "TscClock.hpp"
+
+#include <chrono>
+#include <cmath>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define PONG_TSC_MSVC
+#include <intrin.h>
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PONG_TSC_GNU
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Length of each of the two calibration windows
+constexpr auto calibrationWindow = std::chrono::milliseconds(5);
+
+// Largest relative difference between the two windows' rates
+constexpr double calibrationTolerance = 0.005;
+
+
+////////////////////////////////////////////////////////////
+struct Calibration
+{
+    bool          tsc{};          // Are ticks read from the time-stamp counter?
+    std::uint64_t frequency{};    // Ticks per second
+    double        microseconds{}; // Microseconds per tick
+};
+
+
+////////////////////////////////////////////////////////////
+// Nanoseconds of the steady clock, the reference and fallback.
+// Like the counter, it measures wall-clock time whether the
+// thread runs, sleeps or is preempted
+////////////////////////////////////////////////////////////
+std::uint64_t readReference()
+{
+    const auto time = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count());
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint64_t readCounter()
+{
+#if defined(PONG_TSC_MSVC) || defined(PONG_TSC_GNU)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+
+////////////////////////////////////////////////////////////
+// CPUID 8000_0007h, EDX bit 8: the counter runs at a constant
+// rate in every power state
+////////////////////////////////////////////////////////////
+bool isCounterInvariant()
+{
+#if defined(PONG_TSC_MSVC)
+    int registers[4];
+    __cpuid(registers, 0x80000000);
+    if (static_cast<unsigned int>(registers[0]) < 0x80000007)
+        return false;
+
+    __cpuid(registers, 0x80000007);
+    return (registers[3] & (1 << 8)) != 0;
+#elif defined(PONG_TSC_GNU)
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+        return false;
+
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+
+////////////////////////////////////////////////////////////
+// Counter rate over a window, in ticks per nanosecond; also
+// moves the window's start to its end
+////////////////////////////////////////////////////////////
+double measureRate(std::uint64_t& reference, std::uint64_t& counter)
+{
+    const std::uint64_t end = reference + static_cast<std::uint64_t>(
+                                              std::chrono::nanoseconds(calibrationWindow).count());
+
+    // Spin rather than sleep: waking up late only costs time,
+    // but a thread moved to another core mid-window shows as a
+    // mismatch between the windows instead of going unnoticed
+    std::uint64_t nextReference = readReference();
+    while (nextReference < end)
+        nextReference = readReference();
+    const std::uint64_t nextCounter = readCounter();
+
+    const double rate = (nextCounter > counter)
+                            ? static_cast<double>(nextCounter - counter) / static_cast<double>(nextReference - reference)
+                            : 0.0;
+
+    reference = nextReference;
+    counter   = nextCounter;
+    return rate;
+}
+
+
+////////////////////////////////////////////////////////////
+Calibration calibrate()
+{
+    Calibration fallback;
+    fallback.frequency    = 1000000000;
+    fallback.microseconds = 0.001;
+
+    if (!isCounterInvariant())
+        return fallback;
+
+    std::uint64_t reference = readReference();
+    std::uint64_t counter   = readCounter();
+
+    const double first  = measureRate(reference, counter);
+    const double second = measureRate(reference, counter);
+    if ((first <= 0.0) || (second <= 0.0) || (std::abs(first - second) > calibrationTolerance * second))
+        return fallback;
+
+    const double rate = (first + second) / 2.0;
+
+    Calibration calibration;
+    calibration.tsc          = true;
+    calibration.frequency    = static_cast<std::uint64_t>(std::llround(rate * 1e9));
+    calibration.microseconds = 0.001 / rate;
+    return calibration;
+}
+
+
+////////////////////////////////////////////////////////////
+const Calibration& getCalibration()
+{
+    static const Calibration calibration = calibrate();
+    return calibration;
+}
+
+} // namespace
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+TscClock::TscClock() : m_start(now())
+{
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Time TscClock::getElapsedTime() const
+{
+    return toTime(now() - m_start);
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Time TscClock::restart()
+{
+    const std::uint64_t current = now();
+    const sf::Time      elapsed = toTime(current - m_start);
+    m_start                     = current;
+    return elapsed;
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint64_t TscClock::now()
+{
+    return getCalibration().tsc ? readCounter() : readReference();
+}
+
+
+////////////////////////////////////////////////////////////
+sf::Time TscClock::toTime(std::uint64_t ticks)
+{
+    return sf::microseconds(static_cast<std::int64_t>(static_cast<double>(ticks) * getCalibration().microseconds));
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint64_t TscClock::toTicks(sf::Time time)
+{
+    const std::int64_t microseconds = time.asMicroseconds();
+    if (microseconds <= 0)
+        return 0;
+
+    return static_cast<std::uint64_t>(static_cast<double>(microseconds) / getCalibration().microseconds);
+}
+
+
+////////////////////////////////////////////////////////////
+std::uint64_t TscClock::getFrequency()
+{
+    return getCalibration().frequency;
+}
+
+
+////////////////////////////////////////////////////////////
+bool TscClock::isTscUsed()
+{
+    return getCalibration().tsc;
+}
+
+} // namespace pong
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "sfml.h"
+
+#include <cstdint>
+
+
+namespace pong
+{
+////////////////////////////////////////////////////////////
+/// \brief Clock reading the CPU's time-stamp counter
+///
+/// Reading the time-stamp counter costs a few nanoseconds,
+/// far less than sf::Clock, so it can time zones as short as
+/// a single function call. The counter's frequency is measured
+/// against std::chrono::steady_clock the first time any
+/// TscClock is used, which takes about 10 ms.
+///
+/// The counter is only used if the CPU reports it invariant,
+/// i.e. ticking at a constant rate whatever the core's power
+/// state and synchronized between cores, and if two successive
+/// calibrations agree. Otherwise, and on CPUs other than x86,
+/// ticks are nanoseconds of std::chrono::steady_clock, so the
+/// class behaves like sf::Clock.
+///
+/// Usage example:
+/// \code
+/// const std::uint64_t start = pong::TscClock::now();
+/// // ...
+/// const sf::Time elapsed = pong::TscClock::toTime(pong::TscClock::now() - start);
+/// \endcode
+///
+////////////////////////////////////////////////////////////
+class TscClock
+{
+public:
+    ////////////////////////////////////////////////////////////
+    /// \brief Default constructor
+    ///
+    /// The clock starts automatically after being constructed.
+    ///
+    ////////////////////////////////////////////////////////////
+    TscClock();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the time elapsed since the clock was started
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Time getElapsedTime() const;
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Restart the clock
+    ///
+    /// \return Time elapsed before the restart
+    ///
+    ////////////////////////////////////////////////////////////
+    sf::Time restart();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Read the current time, in ticks
+    ///
+    /// Only differences between ticks are meaningful.
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::uint64_t now();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Convert a number of ticks to a time
+    ///
+    ////////////////////////////////////////////////////////////
+    static sf::Time toTime(std::uint64_t ticks);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Convert a time to a number of ticks
+    ///
+    /// \param time Time to convert, negative times give 0
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::uint64_t toTicks(sf::Time time);
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Get the number of ticks per second
+    ///
+    ////////////////////////////////////////////////////////////
+    static std::uint64_t getFrequency();
+
+    ////////////////////////////////////////////////////////////
+    /// \brief Tell whether ticks come from the time-stamp counter
+    ///
+    /// \return False if the clock fell back to std::chrono::steady_clock
+    ///
+    ////////////////////////////////////////////////////////////
+    static bool isTscUsed();
+
+private:
+    ////////////////////////////////////////////////////////////
+    // Member data
+    ////////////////////////////////////////////////////////////
+    std::uint64_t m_start; //!< Ticks when the clock was started
+};
+
+} // namespace pong
@@ -0,0 +1,431 @@
+#include "VectorKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define PONG_VECTORS_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(PONG_VECTORS_SSE2) && defined(__AVX2__)
+#define PONG_VECTORS_AVX2
+#include <immintrin.h>
+#endif
+
+
+namespace
+{
+static_assert(sizeof(sf::Vector2f) == 2 * sizeof(float), "sf::Vector2f must be two packed floats");
+static_assert(sizeof(sf::FloatRect) == 4 * sizeof(float), "sf::FloatRect must be four packed floats");
+
+#ifdef PONG_VECTORS_SSE2
+////////////////////////////////////////////////////////////
+// Two vectors per register: [x0 y0 x1 y1]
+////////////////////////////////////////////////////////////
+__m128 load2(const sf::Vector2f* in)
+{
+    return _mm_loadu_ps(&in->x);
+}
+
+
+////////////////////////////////////////////////////////////
+void store2(sf::Vector2f* out, __m128 value)
+{
+    _mm_storeu_ps(&out->x, value);
+}
+
+
+////////////////////////////////////////////////////////////
+// x * x + y * y of both vectors, in both of their lanes
+////////////////////////////////////////////////////////////
+__m128 lengthSq2(__m128 value)
+{
+    const __m128 squares = _mm_mul_ps(value, value);
+    return _mm_add_ps(squares, _mm_shuffle_ps(squares, squares, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+
+////////////////////////////////////////////////////////////
+// x + y of four vectors, from their components in two registers
+////////////////////////////////////////////////////////////
+__m128 sum4(__m128 first, __m128 second)
+{
+    const __m128 xs = _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 ys = _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+    return _mm_add_ps(xs, ys);
+}
+
+
+////////////////////////////////////////////////////////////
+// The six elements of a transform's matrix used in 2D, each
+// one splat over the four lanes of a register
+////////////////////////////////////////////////////////////
+struct Splats
+{
+    explicit Splats(const float* m) :
+    m0(_mm_set1_ps(m[0])),
+    m1(_mm_set1_ps(m[1])),
+    m4(_mm_set1_ps(m[4])),
+    m5(_mm_set1_ps(m[5])),
+    m12(_mm_set1_ps(m[12])),
+    m13(_mm_set1_ps(m[13]))
+    {
+    }
+
+    __m128 m0, m1, m4, m5, m12, m13;
+};
+
+
+////////////////////////////////////////////////////////////
+// Transform four points given as xs and ys, in the same order
+// of operations as sf::Transform::transformPoint
+////////////////////////////////////////////////////////////
+void transform4(const Splats& m, __m128 xs, __m128 ys, __m128& outXs, __m128& outYs)
+{
+    outXs = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m.m0, xs), _mm_mul_ps(m.m4, ys)), m.m12);
+    outYs = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m.m1, xs), _mm_mul_ps(m.m5, ys)), m.m13);
+}
+#endif
+
+#ifdef PONG_VECTORS_AVX2
+////////////////////////////////////////////////////////////
+// Four vectors per register: [x0 y0 x1 y1 | x2 y2 x3 y3]
+////////////////////////////////////////////////////////////
+__m256 load4(const sf::Vector2f* in)
+{
+    return _mm256_loadu_ps(&in->x);
+}
+
+
+////////////////////////////////////////////////////////////
+void store4(sf::Vector2f* out, __m256 value)
+{
+    _mm256_storeu_ps(&out->x, value);
+}
+
+
+////////////////////////////////////////////////////////////
+__m256 lengthSq4(__m256 value)
+{
+    const __m256 squares = _mm256_mul_ps(value, value);
+    return _mm256_add_ps(squares, _mm256_permute_ps(squares, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+
+////////////////////////////////////////////////////////////
+// x + y of eight vectors; shuffles work within 128-bit lanes,
+// so the pairs come out as [0 2 1 3] and are put back in order
+////////////////////////////////////////////////////////////
+__m256 sum8(__m256 first, __m256 second)
+{
+    const __m256 xs  = _mm256_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m256 ys  = _mm256_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+    const __m256 sum = _mm256_add_ps(xs, ys);
+    return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(sum), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+#endif
+
+
+////////////////////////////////////////////////////////////
+float lengthOf(const sf::Vector2f& vector)
+{
+    return std::sqrt(vector.lengthSq());
+}
+
+} // namespace
+
+
+namespace pong::vectors
+{
+////////////////////////////////////////////////////////////
+void add(const sf::Vector2f* a, const sf::Vector2f* b, sf::Vector2f* out, std::size_t count)
+{
+    std::size_t i = 0;
+
+#ifdef PONG_VECTORS_AVX2
+    for (; i + 4 <= count; i += 4)
+        store4(out + i, _mm256_add_ps(load4(a + i), load4(b + i)));
+#endif
+
+#ifdef PONG_VECTORS_SSE2
+    for (; i + 2 <= count; i += 2)
+        store2(out + i, _mm_add_ps(load2(a + i), load2(b + i)));
+#endif
+
+    for (; i < count; ++i)
+        out[i] = a[i] + b[i];
+}
+
+
+////////////////////////////////////////////////////////////
+void scale(const sf::Vector2f* in, float factor, sf::Vector2f* out, std::size_t count)
+{
+    std::size_t i = 0;
+
+#ifdef PONG_VECTORS_AVX2
+    const __m256 factor4 = _mm256_set1_ps(factor);
+    for (; i + 4 <= count; i += 4)
+        store4(out + i, _mm256_mul_ps(load4(in + i), factor4));
+#endif
+
+#ifdef PONG_VECTORS_SSE2
+    const __m128 factor2 = _mm_set1_ps(factor);
+    for (; i + 2 <= count; i += 2)
+        store2(out + i, _mm_mul_ps(load2(in + i), factor2));
+#endif
+
+    for (; i < count; ++i)
+        out[i] = in[i] * factor;
+}
+
+
+////////////////////////////////////////////////////////////
+void multiplyAdd(const sf::Vector2f* a, float factor, const sf::Vector2f* b, sf::Vector2f* out, std::size_t count)
+{
+    std::size_t i = 0;
+
+    // Separate multiplies and adds, never fused: FMA rounds once
+    // and wouldn't match the scalar operators, which the build
+    // keeps from being contracted with -ffp-contract=off
+#ifdef PONG_VECTORS_AVX2
+    const __m256 factor4 = _mm256_set1_ps(factor);
+    for (; i + 4 <= count; i += 4)
+        store4(out + i, _mm256_add_ps(_mm256_mul_ps(load4(a + i), factor4), load4(b + i)));
+#endif
+
+#ifdef PONG_VECTORS_SSE2
+    const __m128 factor2 = _mm_set1_ps(factor);
+    for (; i + 2 <= count; i += 2)
+        store2(out + i, _mm_add_ps(_mm_mul_ps(load2(a + i), factor2), load2(b + i)));
+#endif
+
+    for (; i < count; ++i)
+        out[i] = a[i] * factor + b[i];
+}
+
+
+////////////////////////////////////////////////////////////
+void dot(const sf::Vector2f* a, const sf::Vector2f* b, float* out, std::size_t count)
+{
+    std::size_t i = 0;
+
+#ifdef PONG_VECTORS_AVX2
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 first  = _mm256_mul_ps(load4(a + i), load4(b + i));
+        const __m256 second = _mm256_mul_ps(load4(a + i + 4), load4(b + i + 4));
+        _mm256_storeu_ps(out + i, sum8(first, second));
+    }
+#endif
+
+#ifdef PONG_VECTORS_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 first  = _mm_mul_ps(load2(a + i), load2(b + i));
+        const __m128 second = _mm_mul_ps(load2(a + i + 2), load2(b + i + 2));
+        _mm_storeu_ps(out + i, sum4(first, second));
+    }
+#endif
+
+    for (; i < count; ++i)
+        out[i] = a[i].dot(b[i]);
+}
+
+
+////////////////////////////////////////////////////////////
+void length(const sf::Vector2f* in, float* out, std::size_t count)
+{
+    std::size_t i = 0;
+
+#ifdef PONG_VECTORS_AVX2
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 first  = load4(in + i);
+        const __m256 second = load4(in + i + 4);
+        const __m256 sum    = sum8(_mm256_mul_ps(first, first), _mm256_mul_ps(second, second));
+        _mm256_storeu_ps(out + i, _mm256_sqrt_ps(sum));
+    }
+#endif
+
+#ifdef PONG_VECTORS_SSE2
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 first  = load2(in + i);
+        const __m128 second = load2(in + i + 2);
+        const __m128 sum    = sum4(_mm_mul_ps(first, first), _mm_mul_ps(second, second));
+        _mm_storeu_ps(out + i, _mm_sqrt_ps(sum));
+    }
+#endif
+
+    for (; i < count; ++i)
+        out[i] = lengthOf(in[i]);
+}
+
+
+////////////////////////////////////////////////////////////
+void normalize(const sf::Vector2f* in, sf::Vector2f* out, std::size_t count)
+{
+    std::size_t i = 0;
+
+    // Divide by the length rather than multiply by its inverse,
+    // which would round twice; zero vectors are masked out
+#ifdef PONG_VECTORS_AVX2
+    const __m256 zero4 = _mm256_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256 value   = load4(in + i);
+        const __m256 lengths = _mm256_sqrt_ps(lengthSq4(value));
+        const __m256 nonZero = _mm256_cmp_ps(lengths, zero4, _CMP_NEQ_UQ);
+        store4(out + i, _mm256_and_ps(_mm256_div_ps(value, lengths), nonZero));
+    }
+#endif
+
+#ifdef PONG_VECTORS_SSE2
+    const __m128 zero2 = _mm_setzero_ps();
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m128 value   = load2(in + i);
+        const __m128 lengths = _mm_sqrt_ps(lengthSq2(value));
+        const __m128 nonZero = _mm_cmpneq_ps(lengths, zero2);
+        store2(out + i, _mm_and_ps(_mm_div_ps(value, lengths), nonZero));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        const float norm = lengthOf(in[i]);
+        out[i]           = (norm != 0.f) ? in[i] / norm : sf::Vector2f();
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void clampToRect(const sf::Vector2f* in, const sf::FloatRect& rect, sf::Vector2f* out, std::size_t count)
+{
+    const sf::Vector2f low(rect.left, rect.top);
+    const sf::Vector2f high(rect.left + rect.width, rect.top + rect.height);
+
+    std::size_t i = 0;
+
+    // The bounds go first, so that NaNs pass through as with std::max and std::min
+#ifdef PONG_VECTORS_AVX2
+    const __m256 low4  = _mm256_setr_ps(low.x, low.y, low.x, low.y, low.x, low.y, low.x, low.y);
+    const __m256 high4 = _mm256_setr_ps(high.x, high.y, high.x, high.y, high.x, high.y, high.x, high.y);
+    for (; i + 4 <= count; i += 4)
+        store4(out + i, _mm256_min_ps(high4, _mm256_max_ps(low4, load4(in + i))));
+#endif
+
+#ifdef PONG_VECTORS_SSE2
+    const __m128 low2  = _mm_setr_ps(low.x, low.y, low.x, low.y);
+    const __m128 high2 = _mm_setr_ps(high.x, high.y, high.x, high.y);
+    for (; i + 2 <= count; i += 2)
+        store2(out + i, _mm_min_ps(high2, _mm_max_ps(low2, load2(in + i))));
+#endif
+
+    for (; i < count; ++i)
+        out[i] = sf::Vector2f(std::min(std::max(in[i].x, low.x), high.x), std::min(std::max(in[i].y, low.y), high.y));
+}
+
+
+
+////////////////////////////////////////////////////////////
+void transformPoints(const sf::Transform& transform, const sf::Vector2f* in, sf::Vector2f* out, std::size_t count)
+{
+    std::size_t i = 0;
+
+#ifdef PONG_VECTORS_SSE2
+    const float* m = transform.getMatrix();
+#endif
+
+    // Each x and y is duplicated, then multiplied by a column
+    // of the matrix repeated for every point
+#ifdef PONG_VECTORS_AVX2
+    const __m256 xColumn4 = _mm256_setr_ps(m[0], m[1], m[0], m[1], m[0], m[1], m[0], m[1]);
+    const __m256 yColumn4 = _mm256_setr_ps(m[4], m[5], m[4], m[5], m[4], m[5], m[4], m[5]);
+    const __m256 offset4  = _mm256_setr_ps(m[12], m[13], m[12], m[13], m[12], m[13], m[12], m[13]);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256 points = load4(in + i);
+        const __m256 xs     = _mm256_permute_ps(points, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m256 ys     = _mm256_permute_ps(points, _MM_SHUFFLE(3, 3, 1, 1));
+        const __m256 sum    = _mm256_add_ps(_mm256_mul_ps(xColumn4, xs), _mm256_mul_ps(yColumn4, ys));
+        store4(out + i, _mm256_add_ps(sum, offset4));
+    }
+#endif
+
+#ifdef PONG_VECTORS_SSE2
+    const __m128 xColumn2 = _mm_setr_ps(m[0], m[1], m[0], m[1]);
+    const __m128 yColumn2 = _mm_setr_ps(m[4], m[5], m[4], m[5]);
+    const __m128 offset2  = _mm_setr_ps(m[12], m[13], m[12], m[13]);
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m128 points = load2(in + i);
+        const __m128 xs     = _mm_shuffle_ps(points, points, _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128 ys     = _mm_shuffle_ps(points, points, _MM_SHUFFLE(3, 3, 1, 1));
+        const __m128 sum    = _mm_add_ps(_mm_mul_ps(xColumn2, xs), _mm_mul_ps(yColumn2, ys));
+        store2(out + i, _mm_add_ps(sum, offset2));
+    }
+#endif
+
+    for (; i < count; ++i)
+        out[i] = transform.transformPoint(in[i]);
+}
+
+
+////////////////////////////////////////////////////////////
+void transformRects(const sf::Transform& transform, const sf::FloatRect* in, sf::FloatRect* out, std::size_t count)
+{
+    std::size_t i = 0;
+
+#ifdef PONG_VECTORS_SSE2
+    const Splats m(transform.getMatrix());
+
+    for (; i + 4 <= count; i += 4)
+    {
+        // One rectangle per register, transposed to one field per register
+        __m128 lefts   = _mm_loadu_ps(&in[i].left);
+        __m128 tops    = _mm_loadu_ps(&in[i + 1].left);
+        __m128 widths  = _mm_loadu_ps(&in[i + 2].left);
+        __m128 heights = _mm_loadu_ps(&in[i + 3].left);
+        _MM_TRANSPOSE4_PS(lefts, tops, widths, heights);
+
+        const __m128 rights  = _mm_add_ps(lefts, widths);
+        const __m128 bottoms = _mm_add_ps(tops, heights);
+
+        // Corners in the order of transformRect, which only keeps a
+        // later corner when it is strictly beyond the bounds so far
+        __m128 xs[4];
+        __m128 ys[4];
+        transform4(m, lefts, tops, xs[0], ys[0]);
+        transform4(m, lefts, bottoms, xs[1], ys[1]);
+        transform4(m, rights, tops, xs[2], ys[2]);
+        transform4(m, rights, bottoms, xs[3], ys[3]);
+
+        __m128 minX = xs[0];
+        __m128 maxX = xs[0];
+        __m128 minY = ys[0];
+        __m128 maxY = ys[0];
+        for (int corner = 1; corner < 4; ++corner)
+        {
+            minX = _mm_min_ps(xs[corner], minX);
+            maxX = _mm_max_ps(xs[corner], maxX);
+            minY = _mm_min_ps(ys[corner], minY);
+            maxY = _mm_max_ps(ys[corner], maxY);
+        }
+
+        __m128 width  = _mm_sub_ps(maxX, minX);
+        __m128 height = _mm_sub_ps(maxY, minY);
+        _MM_TRANSPOSE4_PS(minX, minY, width, height);
+        _mm_storeu_ps(&out[i].left, minX);
+        _mm_storeu_ps(&out[i + 1].left, minY);
+        _mm_storeu_ps(&out[i + 2].left, width);
+        _mm_storeu_ps(&out[i + 3].left, height);
+    }
+#endif
+
+    for (; i < count; ++i)
+        out[i] = transform.transformRect(in[i]);
+}
+
+} // namespace pong::vectors
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "sfml.h"
+
+#include <cstddef>
+
+
+namespace pong::vectors
+{
+////////////////////////////////////////////////////////////
+// Bulk operations over arrays of sf::Vector2f
+//
+// Each function applies one of sf::Vector2f's operators, or
+// an sf::Transform, to count vectors or rectangles. Arrays are
+// processed with SSE, or AVX2 when the build enables it, in
+// the layout of sf::Vector2f and sf::FloatRect themselves, so
+// existing arrays can be used as is. Leftover elements, and
+// builds without SSE2, use the scalar operators.
+//
+// Results are identical to the scalar operators, bit for bit,
+// as long as the compiler doesn't contract a * b + c into
+// fused multiply-adds: the SIMD paths shuffle products before
+// adding them, so they are never fused, while the scalar
+// operators would be. The CMake build passes -ffp-contract=off
+// to GCC and Clang, which otherwise contract by default, e.g.
+// with -march=native on CPUs with FMA. Square roots and
+// divisions are exact in every path. Lengths are the square
+// roots of lengthSq(), like SFML's length() up to the last
+// bit, which uses std::hypot. Outputs may be the same arrays
+// as inputs, but may not overlap them otherwise.
+//
+// For instance, positions += velocities * dt is
+// multiplyAdd(velocities, dt, positions, positions, count).
+////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////
+/// \brief out[i] = a[i] + b[i]
+///
+////////////////////////////////////////////////////////////
+void add(const sf::Vector2f* a, const sf::Vector2f* b, sf::Vector2f* out, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief out[i] = in[i] * factor
+///
+////////////////////////////////////////////////////////////
+void scale(const sf::Vector2f* in, float factor, sf::Vector2f* out, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief out[i] = a[i] * factor + b[i]
+///
+////////////////////////////////////////////////////////////
+void multiplyAdd(const sf::Vector2f* a, float factor, const sf::Vector2f* b, sf::Vector2f* out, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief out[i] = a[i].dot(b[i])
+///
+////////////////////////////////////////////////////////////
+void dot(const sf::Vector2f* a, const sf::Vector2f* b, float* out, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief out[i] = std::sqrt(in[i].lengthSq())
+///
+////////////////////////////////////////////////////////////
+void length(const sf::Vector2f* in, float* out, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief out[i] = in[i] / std::sqrt(in[i].lengthSq()), or a zero vector for a zero vector
+///
+////////////////////////////////////////////////////////////
+void normalize(const sf::Vector2f* in, sf::Vector2f* out, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief Clamp each point into a rectangle, edges included
+///
+/// \param rect Rectangle, with a positive width and height
+///
+////////////////////////////////////////////////////////////
+void clampToRect(const sf::Vector2f* in, const sf::FloatRect& rect, sf::Vector2f* out, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief out[i] = transform.transformPoint(in[i])
+///
+////////////////////////////////////////////////////////////
+void transformPoints(const sf::Transform& transform, const sf::Vector2f* in, sf::Vector2f* out, std::size_t count);
+
+////////////////////////////////////////////////////////////
+/// \brief out[i] = transform.transformRect(in[i])
+///
+/// Rectangles are transformed four at a time, with all their
+/// corners in flight at once instead of one after the other.
+///
+////////////////////////////////////////////////////////////
+void transformRects(const sf::Transform& transform, const sf::FloatRect* in, sf::FloatRect* out, std::size_t count);
+
+} // namespace pong::vectors
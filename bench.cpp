@@ -0,0 +1,1187 @@
+#include "AimNoise.hpp"
+#include "FastTrig.hpp"
+#include "HeadlessRenderTarget.hpp"
+#include "InstancedSpriteRenderer.hpp"
+#include "Match.hpp"
+#include "MatchEstimator.hpp"
+#include "MatchRenderer.hpp"
+#include "PaddleAi.hpp"
+#include "ParticleSystem.hpp"
+#include "Philox.hpp"
+#include "PreTransformBatcher.hpp"
+#include "RectSet.hpp"
+#include "RenderBackend.hpp"
+#include "RenderCommandBuffer.hpp"
+#include "RenderThread.hpp"
+#include "ThreadPool.hpp"
+#include "TscClock.hpp"
+#include "VectorKernels.hpp"
+#include "sfml.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+#ifndef PONG_HEADLESS_EGL
+#error "bench needs the headless EGL render target, build it with PONG_HEADLESS_EGL"
+#endif
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Draw-call overhead of the legacy and core profile backends.
+//
+// Every draw has its own transform, so that neither SFML's
+// vertex cache nor any batching can merge them: each one costs
+// a matrix change and a draw call. Submission time is what the
+// CPU spends in draw(), frame time adds display() and hence
+// the driver's flush.
+////////////////////////////////////////////////////////////
+template <typename Target>
+void measureDrawCalls(const char* name, Target& target)
+{
+    constexpr std::size_t drawsPerFrame = 2000;
+    constexpr int         warmupFrames  = 20;
+    constexpr int         frames        = 200;
+    constexpr std::size_t vertexCounts[] = {6, 60};
+
+    const sf::ContextSettings settings = target.getSettings();
+    const auto                backend  = pong::createRenderBackend(target, settings);
+
+    std::cout << name << " (OpenGL " << settings.majorVersion << '.' << settings.minorVersion
+              << ((settings.attributeFlags & sf::ContextSettings::Core) ? " core" : "") << ")\n";
+
+    for (const std::size_t vertexCount : vertexCounts)
+    {
+        // Small triangles fanning out of the top-left corner
+        std::vector<sf::Vertex> vertices(vertexCount);
+        for (std::size_t i = 0; i < vertexCount; ++i)
+            vertices[i].position = sf::Vector2f(static_cast<float>(i % 3) * 2.f, static_cast<float>(i / 3 % 2) * 2.f);
+
+        sf::Time submission;
+        sf::Time frameTime;
+
+        for (int frame = 0; frame < warmupFrames + frames; ++frame)
+        {
+            if constexpr (std::is_same_v<Target, sf::RenderWindow>)
+            {
+                sf::Event event;
+                while (target.pollEvent(event))
+                {
+                }
+            }
+
+            sf::Clock frameClock;
+            backend->clear();
+
+            sf::Clock submitClock;
+            for (std::size_t i = 0; i < drawsPerFrame; ++i)
+            {
+                sf::Transform transform;
+                transform.translate({static_cast<float>(i % 250), static_cast<float>(i / 250 * 4)});
+                backend->draw(vertices.data(), vertexCount, sf::PrimitiveType::Triangles, sf::RenderStates(transform));
+            }
+            const sf::Time submitted = submitClock.getElapsedTime();
+
+            target.display();
+
+            if (frame >= warmupFrames)
+            {
+                submission += submitted;
+                frameTime += frameClock.getElapsedTime();
+            }
+        }
+
+        const float draws = static_cast<float>(drawsPerFrame) * frames;
+        std::cout << "  " << std::setw(3) << vertexCount << " vertices/draw: " << std::fixed << std::setprecision(3)
+                  << submission.asSeconds() * 1e6f / draws << " us/draw submitted, "
+                  << frameTime.asSeconds() * 1e6f / draws << " us/draw with display" << std::endl;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void measureDrawCalls(const char* name, const sf::ContextSettings& requested)
+{
+    sf::RenderWindow window(sf::VideoMode(256, 240), "bench", sf::Style::Default, requested);
+    window.setVerticalSyncEnabled(false);
+
+    measureDrawCalls(name, window);
+}
+
+
+////////////////////////////////////////////////////////////
+void benchDrawCalls()
+{
+    measureDrawCalls("legacy", sf::ContextSettings());
+    measureDrawCalls("core", sf::ContextSettings(0, 0, 0, 3, 3, sf::ContextSettings::Core));
+}
+
+
+////////////////////////////////////////////////////////////
+// Same measurement without a window, for containers; only
+// the core profile backend can draw to a headless target.
+// Run it on its own: OpenGL is resolved for the first kind of
+// context a process creates.
+////////////////////////////////////////////////////////////
+void benchDrawCallsHeadless()
+{
+    pong::HeadlessRenderTarget target;
+    if (!target.create({256, 240}))
+        return;
+
+    measureDrawCalls("headless core", target);
+}
+
+
+////////////////////////////////////////////////////////////
+// Throughput of the render thread under a CPU-bound load.
+//
+// Each frame simulates a batch of headless matches and keeps
+// a particle system busy, then records them; the serial loop
+// replays and displays every frame on the simulating thread,
+// the threaded one hands it to a RenderThread and simulates
+// the next frame meanwhile. Vertical sync is off, so frames/s
+// is all the CPU can do, and heavier simulations show how
+// much of the rendering the render thread hides.
+////////////////////////////////////////////////////////////
+struct LoadedWorld
+{
+    std::vector<pong::Match> matches;
+    pong::ParticleSystem     particles{1};
+    pong::MatchRenderer      renderer;
+};
+
+
+////////////////////////////////////////////////////////////
+void simulateFrame(LoadedWorld& world, std::uint32_t ticksPerMatch)
+{
+    const pong::PaddleAi ai;
+
+    for (pong::Match& match : world.matches)
+    {
+        for (std::uint32_t tick = 0; tick < ticksPerMatch; ++tick)
+        {
+            if (match.getState().phase == pong::Match::Phase::Over)
+                match.start();
+
+            match.step(ai.decide(match, pong::Match::Left), ai.decide(match, pong::Match::Right));
+        }
+    }
+
+    const sf::Vector2f size(world.matches.front().getRules().fieldSize);
+    if (world.particles.getCount() < 20000)
+        world.particles.burst(size / 2.f, 5000, sf::Color(64, 160, 255), 160.f, sf::seconds(2.f));
+
+    world.particles.update(sf::seconds(1.f / 60.f));
+}
+
+
+////////////////////////////////////////////////////////////
+void recordFrame(LoadedWorld& world, pong::RenderCommandBuffer& frame)
+{
+    frame.clear();
+    world.particles.record(frame);
+    world.renderer.record(frame, world.matches.front());
+    frame.sort();
+}
+
+
+////////////////////////////////////////////////////////////
+float measureRenderLoop(sf::RenderWindow& window, bool threaded, std::uint32_t ticksPerMatch)
+{
+    constexpr int warmupFrames = 20;
+    constexpr int frames       = 200;
+
+    LoadedWorld world;
+    for (std::uint64_t i = 0; i < 64; ++i)
+    {
+        world.matches.emplace_back(pong::Match::Rules(), 1, i);
+        world.matches.back().start();
+    }
+
+    sf::Clock clock;
+    if (threaded)
+    {
+        pong::RenderThread renderThread(window);
+        for (int frame = 0; frame < warmupFrames + frames; ++frame)
+        {
+            if (frame == warmupFrames)
+                clock.restart();
+
+            simulateFrame(world, ticksPerMatch);
+            recordFrame(world, renderThread.beginFrame());
+            renderThread.submitFrame();
+        }
+
+        // Leaving the scope waits for the last frame to be displayed
+    }
+    else
+    {
+        const auto                backend = pong::createRenderBackend(window, window.getSettings());
+        pong::PreTransformBatcher batcher;
+        pong::RenderCommandBuffer buffer;
+        batcher.calibrate(*backend);
+
+        for (int frame = 0; frame < warmupFrames + frames; ++frame)
+        {
+            if (frame == warmupFrames)
+                clock.restart();
+
+            simulateFrame(world, ticksPerMatch);
+            recordFrame(world, buffer);
+            buffer.replay(*backend, &batcher);
+            window.display();
+        }
+    }
+
+    return static_cast<float>(frames) / clock.getElapsedTime().asSeconds();
+}
+
+
+////////////////////////////////////////////////////////////
+void benchRenderThread()
+{
+    sf::RenderWindow window(sf::VideoMode(256, 240), "bench");
+    window.setVerticalSyncEnabled(false);
+
+    for (const std::uint32_t ticksPerMatch : {0u, 50u, 200u, 800u})
+    {
+        sf::Event event;
+        while (window.pollEvent(event))
+        {
+        }
+
+        const float serial   = measureRenderLoop(window, false, ticksPerMatch);
+        const float threaded = measureRenderLoop(window, true, ticksPerMatch);
+        std::cout << "  " << std::setw(3) << ticksPerMatch << " ticks x 64 matches/frame: " << std::fixed
+                  << std::setprecision(1) << serial << " frames/s serial, " << threaded << " frames/s threaded ("
+                  << std::setprecision(2) << threaded / serial << "x)" << std::endl;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+// Instanced sprites: one draw call for the whole batch.
+//
+// A grid of opaque squares, each tinted with its own color,
+// is drawn to a render texture and read back: the center of
+// every square must have the square's color, which checks
+// the vertex expansion, the texture rectangles and the color
+// attribute on any driver, llvmpipe included. Then batches
+// of growing size are drawn unchanged and with every instance
+// changed each frame: the difference is the upload cost.
+////////////////////////////////////////////////////////////
+sf::Color getInstanceColor(std::size_t index)
+{
+    return sf::Color(static_cast<std::uint8_t>(index * 37),
+                     static_cast<std::uint8_t>(index * 11 + 64),
+                     static_cast<std::uint8_t>(index * 101 + 128));
+}
+
+
+////////////////////////////////////////////////////////////
+void benchInstancedSprites()
+{
+    constexpr unsigned int cellSize = 8;
+    constexpr unsigned int gridSize = 64;
+    constexpr int          frames   = 200;
+
+    sf::RenderTexture target;
+    if (!target.create({cellSize * gridSize, cellSize * gridSize}))
+        return;
+
+    if (!target.setActive(true) || !pong::InstancedSpriteRenderer::isAvailable())
+    {
+        std::cout << "  instanced drawing is not supported" << std::endl;
+        return;
+    }
+
+    // A white atlas: the instances' colors come out unchanged
+    sf::Image atlas;
+    atlas.create({4, 4}, sf::Color::White);
+    sf::Texture texture;
+    if (!texture.loadFromImage(atlas))
+        return;
+
+    pong::InstancedSpriteRenderer renderer;
+    if (!renderer.create())
+        return;
+
+    renderer.setTexture(texture);
+
+    // Squares of 4 texels scaled to 6 pixels, centered in their cell
+    for (std::size_t i = 0; i < gridSize * gridSize; ++i)
+    {
+        pong::InstancedSpriteRenderer::Instance instance;
+        instance.position       = sf::Vector2f(static_cast<float>(i % gridSize * cellSize + cellSize / 2),
+                                               static_cast<float>(i / gridSize * cellSize + cellSize / 2));
+        instance.scale          = sf::Vector2f(1.5f, 1.5f);
+        instance.textureRect[2] = 4;
+        instance.textureRect[3] = 4;
+        instance.color          = getInstanceColor(i);
+        renderer.append(instance);
+    }
+
+    target.clear();
+    target.draw(renderer);
+    target.display();
+
+    const sf::Image image      = target.getTexture().copyToImage();
+    std::size_t     mismatches = 0;
+    for (unsigned int i = 0; i < gridSize * gridSize; ++i)
+    {
+        const sf::Color expected = getInstanceColor(i);
+        const sf::Color actual   = image.getPixel(
+            {i % gridSize * cellSize + cellSize / 2, i / gridSize * cellSize + cellSize / 2});
+        mismatches += (std::abs(expected.r - actual.r) > 1) || (std::abs(expected.g - actual.g) > 1) ||
+                      (std::abs(expected.b - actual.b) > 1);
+    }
+
+    // The gaps between the squares must stay clear
+    mismatches += image.getPixel({0, 0}) != sf::Color::Black;
+
+    std::cout << "  " << gridSize * gridSize << " instances drawn"
+              << (mismatches ? ", MISMATCH: " + std::to_string(mismatches) + " wrong pixels" : ", pixels match")
+              << std::endl;
+
+    std::mt19937                          random(1);
+    std::uniform_real_distribution<float> position(0.f, static_cast<float>(cellSize * gridSize));
+
+    for (const std::size_t instanceCount : {std::size_t{1000}, std::size_t{10000}, std::size_t{100000}})
+    {
+        renderer.clear();
+        for (std::size_t i = 0; i < instanceCount; ++i)
+        {
+            pong::InstancedSpriteRenderer::Instance instance;
+            instance.position       = sf::Vector2f(position(random), position(random));
+            instance.textureRect[2] = 4;
+            instance.textureRect[3] = 4;
+            instance.color          = getInstanceColor(i);
+            renderer.append(instance);
+        }
+
+        // Submission time of unchanged instances, then of instances all changed every frame
+        sf::Time times[2];
+        for (const bool changed : {false, true})
+        {
+            for (int frame = 0; frame < frames; ++frame)
+            {
+                if (changed)
+                {
+                    for (std::size_t i = 0; i < instanceCount; ++i)
+                        renderer[i].rotation += 0.01f;
+                }
+
+                target.clear();
+                sf::Clock clock;
+                target.draw(renderer);
+                times[changed] += clock.getElapsedTime();
+                target.display();
+            }
+        }
+
+        const float staticTime  = times[0].asSeconds() * 1e6f / frames;
+        const float dynamicTime = times[1].asSeconds() * 1e6f / frames;
+        const float uploadTime  = std::max(dynamicTime - staticTime, 0.f) * 1000.f / static_cast<float>(instanceCount);
+        std::cout << "  " << std::setw(6) << instanceCount << " instances: " << std::fixed << std::setprecision(1)
+                  << staticTime << " us/draw unchanged, " << dynamicTime << " us/draw changed, "
+                  << std::setprecision(2) << uploadTime << " ns/instance uploaded" << std::endl;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+// Cost of reading the time, which bounds how short a profiled
+// zone can be before timing it distorts it
+////////////////////////////////////////////////////////////
+template <typename Clock>
+void measureClockReads(const char* name)
+{
+    constexpr int reads = 10000000;
+
+    Clock                 clock;
+    volatile std::int64_t sink = 0;
+    sf::Clock             total;
+    for (int i = 0; i < reads; ++i)
+        sink = clock.getElapsedTime().asMicroseconds();
+    static_cast<void>(sink);
+
+    std::cout << "  " << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(2)
+              << total.getElapsedTime().asSeconds() * 1e9f / reads << " ns/read" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+void benchClockReads()
+{
+    const std::uint64_t frequency = pong::TscClock::getFrequency();
+    std::cout << "TscClock: " << (pong::TscClock::isTscUsed() ? "invariant TSC" : "steady clock fallback") << ", "
+              << frequency / 1000000 << " MHz" << std::endl;
+
+    measureClockReads<sf::Clock>("sf::Clock");
+    measureClockReads<pong::TscClock>("TscClock");
+}
+
+
+////////////////////////////////////////////////////////////
+// Headless simulation throughput of rules chosen at run time
+// (Match) against the same rules folded at compile time
+// (ClassicMatch). A sharp computer player faces a sloppy one,
+// so that points are scored and matches end; both kinds of
+// matches must end in the same states.
+////////////////////////////////////////////////////////////
+template <typename MatchType>
+std::uint64_t playMatches(const char* name, const typename MatchType::Rules& rules)
+{
+    constexpr std::uint64_t matches = 256;
+    constexpr std::uint32_t ticks   = 20000;
+
+    const pong::PaddleAi sharp;
+    const pong::PaddleAi sloppy(pong::PaddleAi::Parameters{12.f});
+    std::uint64_t        checksum = 0;
+    pong::TscClock       clock;
+
+    for (std::uint64_t seed = 0; seed < matches; ++seed)
+    {
+        MatchType match(rules, seed);
+        match.start();
+
+        for (std::uint32_t tick = 0; tick < ticks; ++tick)
+        {
+            match.step(sharp.decide(match, pong::Match::Left), sloppy.decide(match, pong::Match::Right));
+            if (match.getState().phase == pong::Match::Phase::Over)
+                match.start();
+        }
+
+        const pong::MatchDefinitions::State& state = match.getState();
+        checksum = checksum * 31 + state.scores[pong::Match::Left] * 1000 + state.scores[pong::Match::Right];
+        checksum = checksum * 31 + static_cast<std::uint64_t>(state.ballPosition.y);
+    }
+
+    const float seconds = clock.getElapsedTime().asSeconds();
+    std::cout << "  " << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(2)
+              << static_cast<float>(matches * ticks) / seconds / 1e6f << " M ticks/s" << std::endl;
+
+    return checksum;
+}
+
+
+////////////////////////////////////////////////////////////
+void benchMatchTicks()
+{
+    pong::MatchRules options;
+    options.spin     = pong::MatchRules::FixedOne / 2;
+    options.winByTwo = true;
+
+    const std::uint64_t generic     = playMatches<pong::Match>("generic", pong::MatchRules());
+    const std::uint64_t specialized = playMatches<pong::ClassicMatch>("specialized (classic)", pong::ClassicRules());
+    playMatches<pong::Match>("generic (spin, win by 2)", options);
+
+    if (generic != specialized)
+        std::cout << "  MISMATCH: the specialized matches ended differently" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+// Throughput of a bulk vector kernel against the scalar loop
+// it replaces; both must write the same bits. The count is
+// odd, so that the scalar tails of the kernels run too.
+////////////////////////////////////////////////////////////
+template <typename Output, typename Kernel, typename Reference>
+void measureVectorKernel(const char* name, std::size_t count, Kernel kernel, Reference reference)
+{
+    constexpr int repeats = 2000;
+
+    std::vector<Output> fast(count);
+    std::vector<Output> slow(count);
+
+    pong::TscClock kernelClock;
+    for (int i = 0; i < repeats; ++i)
+        kernel(fast.data());
+    const float kernelSeconds = kernelClock.getElapsedTime().asSeconds();
+
+    pong::TscClock referenceClock;
+    for (int i = 0; i < repeats; ++i)
+        reference(slow.data());
+    const float referenceSeconds = referenceClock.getElapsedTime().asSeconds();
+
+    const float vectors = static_cast<float>(count) * repeats;
+    std::cout << "  " << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8) << vectors / kernelSeconds / 1e6f << " M/s, scalar " << std::setw(8)
+              << vectors / referenceSeconds / 1e6f << " M/s" << std::endl;
+
+    if (std::memcmp(fast.data(), slow.data(), count * sizeof(Output)) != 0)
+        std::cout << "  MISMATCH: " << name << " differs from the scalar operators" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+void benchVectorKernels()
+{
+    constexpr std::size_t count = 4099;
+
+    // Random vectors, with a few zero ones for normalize()
+    std::mt19937                          random(42);
+    std::uniform_real_distribution<float> distribution(-300.f, 300.f);
+    std::vector<sf::Vector2f>             a(count);
+    std::vector<sf::Vector2f>             b(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        a[i] = (i % 97 == 0) ? sf::Vector2f() : sf::Vector2f(distribution(random), distribution(random));
+        b[i] = sf::Vector2f(distribution(random), distribution(random));
+    }
+
+    const float         factor = 0.016f;
+    const sf::FloatRect rect({0.f, 0.f}, {256.f, 240.f});
+
+    using sf::Vector2f;
+    namespace vectors = pong::vectors;
+
+    measureVectorKernel<Vector2f>(
+        "add",
+        count,
+        [&](Vector2f* out) { vectors::add(a.data(), b.data(), out, count); },
+        [&](Vector2f* out)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = a[i] + b[i];
+        });
+
+    measureVectorKernel<Vector2f>(
+        "scale",
+        count,
+        [&](Vector2f* out) { vectors::scale(a.data(), factor, out, count); },
+        [&](Vector2f* out)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = a[i] * factor;
+        });
+
+    measureVectorKernel<Vector2f>(
+        "multiplyAdd",
+        count,
+        [&](Vector2f* out) { vectors::multiplyAdd(a.data(), factor, b.data(), out, count); },
+        [&](Vector2f* out)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = a[i] * factor + b[i];
+        });
+
+    measureVectorKernel<float>(
+        "dot",
+        count,
+        [&](float* out) { vectors::dot(a.data(), b.data(), out, count); },
+        [&](float* out)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = a[i].dot(b[i]);
+        });
+
+    measureVectorKernel<float>(
+        "length",
+        count,
+        [&](float* out) { vectors::length(a.data(), out, count); },
+        [&](float* out)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = std::sqrt(a[i].lengthSq());
+        });
+
+    measureVectorKernel<Vector2f>(
+        "normalize",
+        count,
+        [&](Vector2f* out) { vectors::normalize(a.data(), out, count); },
+        [&](Vector2f* out)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                const float norm = std::sqrt(a[i].lengthSq());
+                out[i]           = (norm != 0.f) ? a[i] / norm : Vector2f();
+            }
+        });
+
+    measureVectorKernel<Vector2f>(
+        "clampToRect",
+        count,
+        [&](Vector2f* out) { vectors::clampToRect(a.data(), rect, out, count); },
+        [&](Vector2f* out)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = Vector2f(std::clamp(a[i].x, rect.left, rect.left + rect.width),
+                                  std::clamp(a[i].y, rect.top, rect.top + rect.height));
+        });
+}
+
+
+////////////////////////////////////////////////////////////
+// Batched transforms against per-call transformPoint and
+// transformRect, with a rotation so that every corner counts
+////////////////////////////////////////////////////////////
+void benchTransforms()
+{
+    constexpr std::size_t count = 4099;
+
+    std::mt19937                          random(7);
+    std::uniform_real_distribution<float> distribution(-300.f, 300.f);
+    std::vector<sf::Vector2f>             points(count);
+    std::vector<sf::FloatRect>            rects(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        points[i] = sf::Vector2f(distribution(random), distribution(random));
+        rects[i]  = sf::FloatRect({distribution(random), distribution(random)},
+                                 {std::abs(distribution(random)), std::abs(distribution(random))});
+    }
+
+    // Rotation by 30 degrees and scale by (2, 1.5) around the center of the field
+    const sf::Transform transform(1.732f, -0.75f, 128.f, 1.f, 1.299f, 120.f, 0.f, 0.f, 1.f);
+
+    namespace vectors = pong::vectors;
+
+    measureVectorKernel<sf::Vector2f>(
+        "transformPoints",
+        count,
+        [&](sf::Vector2f* out) { vectors::transformPoints(transform, points.data(), out, count); },
+        [&](sf::Vector2f* out)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = transform.transformPoint(points[i]);
+        });
+
+    measureVectorKernel<sf::FloatRect>(
+        "transformRects",
+        count,
+        [&](sf::FloatRect* out) { vectors::transformRects(transform, rects.data(), out, count); },
+        [&](sf::FloatRect* out)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                out[i] = transform.transformRect(rects[i]);
+        });
+}
+
+
+////////////////////////////////////////////////////////////
+// Broad-phase queries of a RectSet against loops calling
+// sf::FloatRect::findIntersection; both must find the same
+// pairs, in the same order.
+////////////////////////////////////////////////////////////
+template <typename Fast, typename Slow>
+void measureRectQueries(const char* name, Fast fast, Slow slow)
+{
+    constexpr int repeats = 200;
+
+    std::vector<pong::RectSet::Pair> fastPairs;
+    std::vector<pong::RectSet::Pair> slowPairs;
+
+    pong::TscClock fastClock;
+    for (int i = 0; i < repeats; ++i)
+        fast(fastPairs);
+    const float fastSeconds = fastClock.getElapsedTime().asSeconds();
+
+    pong::TscClock slowClock;
+    for (int i = 0; i < repeats; ++i)
+        slow(slowPairs);
+    const float slowSeconds = slowClock.getElapsedTime().asSeconds();
+
+    std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8) << fastSeconds * 1e6f / repeats << " us, loop " << std::setw(8)
+              << slowSeconds * 1e6f / repeats << " us (" << fastPairs.size() << " pairs)" << std::endl;
+
+    const bool same = (fastPairs.size() == slowPairs.size()) &&
+                      std::equal(fastPairs.begin(),
+                                 fastPairs.end(),
+                                 slowPairs.begin(),
+                                 [](const pong::RectSet::Pair& a, const pong::RectSet::Pair& b)
+                                 { return (a.first == b.first) && (a.second == b.second); });
+    if (!same)
+        std::cout << "  MISMATCH: " << name << " differs from findIntersection()" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+void benchRectIntersections()
+{
+    using pong::RectSet;
+
+    // A wall of 32x16 bricks, 64 balls and 1024 assorted objects over the field
+    std::mt19937                          random(3);
+    std::uniform_real_distribution<float> x(0.f, 248.f);
+    std::uniform_real_distribution<float> y(0.f, 232.f);
+    std::uniform_real_distribution<float> size(2.f, 16.f);
+
+    std::vector<sf::FloatRect> bricks;
+    std::vector<sf::FloatRect> balls;
+    std::vector<sf::FloatRect> objects;
+    for (int row = 0; row < 16; ++row)
+    {
+        for (int column = 0; column < 32; ++column)
+            bricks.emplace_back(sf::Vector2f(column * 8.f, 24.f + row * 6.f), sf::Vector2f(7.f, 5.f));
+    }
+    for (int i = 0; i < 64; ++i)
+        balls.emplace_back(sf::Vector2f(x(random), y(random)), sf::Vector2f(8.f, 8.f));
+    for (int i = 0; i < 1024; ++i)
+        objects.emplace_back(sf::Vector2f(x(random), y(random)), sf::Vector2f(size(random), size(random)));
+
+    RectSet brickSet;
+    RectSet ballSet;
+    RectSet objectSet;
+    for (const sf::FloatRect& brick : bricks)
+        brickSet.add(brick);
+    for (const sf::FloatRect& ball : balls)
+        ballSet.add(ball);
+    for (const sf::FloatRect& object : objects)
+        objectSet.add(object);
+
+    std::vector<RectSet::Index> hits;
+
+    measureRectQueries(
+        "ball vs bricks",
+        [&](std::vector<RectSet::Pair>& pairs)
+        {
+            pairs.clear();
+            for (std::size_t i = 0; i < balls.size(); ++i)
+            {
+                brickSet.findIntersecting(balls[i], hits);
+                for (const RectSet::Index hit : hits)
+                    pairs.push_back({static_cast<RectSet::Index>(i), hit});
+            }
+        },
+        [&](std::vector<RectSet::Pair>& pairs)
+        {
+            pairs.clear();
+            for (std::size_t i = 0; i < balls.size(); ++i)
+            {
+                for (std::size_t j = 0; j < bricks.size(); ++j)
+                {
+                    if (balls[i].findIntersection(bricks[j]))
+                        pairs.push_back({static_cast<RectSet::Index>(i), static_cast<RectSet::Index>(j)});
+                }
+            }
+        });
+
+    measureRectQueries(
+        "balls x bricks",
+        [&](std::vector<RectSet::Pair>& pairs) { ballSet.findIntersections(brickSet, pairs); },
+        [&](std::vector<RectSet::Pair>& pairs)
+        {
+            pairs.clear();
+            for (std::size_t i = 0; i < balls.size(); ++i)
+            {
+                for (std::size_t j = 0; j < bricks.size(); ++j)
+                {
+                    if (balls[i].findIntersection(bricks[j]))
+                        pairs.push_back({static_cast<RectSet::Index>(i), static_cast<RectSet::Index>(j)});
+                }
+            }
+        });
+
+    measureRectQueries(
+        "objects among themselves",
+        [&](std::vector<RectSet::Pair>& pairs) { objectSet.findIntersections(pairs); },
+        [&](std::vector<RectSet::Pair>& pairs)
+        {
+            pairs.clear();
+            for (std::size_t i = 0; i < objects.size(); ++i)
+            {
+                for (std::size_t j = i + 1; j < objects.size(); ++j)
+                {
+                    if (objects[i].findIntersection(objects[j]))
+                        pairs.push_back({static_cast<RectSet::Index>(i), static_cast<RectSet::Index>(j)});
+                }
+            }
+        });
+
+    // Points, as for clicks or the centers of particles
+    std::vector<RectSet::Index> fastHits;
+    std::size_t                 mismatches = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        const sf::Vector2f point(x(random), y(random));
+        objectSet.findContaining(point, fastHits);
+
+        hits.clear();
+        for (std::size_t j = 0; j < objects.size(); ++j)
+        {
+            if (objects[j].contains(point))
+                hits.push_back(static_cast<RectSet::Index>(j));
+        }
+
+        mismatches += (fastHits != hits);
+    }
+
+    if (mismatches > 0)
+        std::cout << "  MISMATCH: findContaining() differs from contains() for " << mismatches << " points"
+                  << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+// Error of each accuracy of pong::trig over the whole range
+// it supports, against the documented bounds, and throughput
+// of the batch sincos() against std::sin and std::cos.
+////////////////////////////////////////////////////////////
+void benchFastTrig()
+{
+    using pong::trig::Accuracy;
+
+    constexpr std::size_t count   = 1 << 20;
+    constexpr float       range   = 8192.f;
+    constexpr int         repeats = 20;
+
+    // Evenly spread angles, then more of them within a turn, in radians:
+    // sfml.h doesn't define sf::radians() to build sf::Angles with
+    std::vector<float> angles(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const float unit = static_cast<float>(i) / count * 2.f - 1.f;
+        angles[i]        = unit * ((i % 2) ? range : 6.2831853f);
+    }
+
+    std::vector<float> sines(count);
+    std::vector<float> cosines(count);
+
+    pong::TscClock referenceClock;
+    for (int repeat = 0; repeat < repeats; ++repeat)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            sines[i]   = std::sin(angles[i]);
+            cosines[i] = std::cos(angles[i]);
+        }
+    }
+    const float referenceSeconds = referenceClock.getElapsedTime().asSeconds();
+    std::cout << "  std::sin/cos  " << std::fixed << std::setprecision(1) << std::setw(8)
+              << static_cast<float>(count) * repeats / referenceSeconds / 1e6f << " M/s" << std::endl;
+
+    const std::pair<const char*, Accuracy> accuracies[] = {{"Low", Accuracy::Low},
+                                                           {"Medium", Accuracy::Medium},
+                                                           {"High", Accuracy::High}};
+
+    for (const auto& [name, accuracy] : accuracies)
+    {
+        pong::TscClock clock;
+        for (int repeat = 0; repeat < repeats; ++repeat)
+            pong::trig::sincos(angles.data(), sines.data(), cosines.data(), count, accuracy);
+        const float seconds = clock.getElapsedTime().asSeconds();
+
+        // Errors against double precision, of the batch and of single angles
+        double maxError = 0.0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const double radians = angles[i];
+            float        sine    = 0.f;
+            float        cosine  = 0.f;
+            pong::trig::sincos(angles[i], sine, cosine, accuracy);
+
+            maxError = std::max({maxError,
+                                 std::abs(sines[i] - std::sin(radians)),
+                                 std::abs(cosines[i] - std::cos(radians)),
+                                 std::abs(sine - std::sin(radians)),
+                                 std::abs(cosine - std::cos(radians))});
+        }
+
+        std::cout << "  " << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << static_cast<float>(count) * repeats / seconds / 1e6f << " M/s, max error "
+                  << std::scientific << std::setprecision(2) << maxError << " (bound "
+                  << pong::trig::getMaxError(accuracy) << ")" << std::endl;
+
+        if (maxError > pong::trig::getMaxError(accuracy))
+            std::cout << "  MISMATCH: " << name << " exceeds its documented error bound" << std::endl;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+// Latency and precision of the Monte Carlo estimator, on one
+// thread and on every hardware thread, from the first serve
+// and from later stages of a match between a sharp and a
+// sloppy computer player.
+////////////////////////////////////////////////////////////
+void benchMatchEstimator()
+{
+    const pong::PaddleAi sharp;
+    const pong::PaddleAi sloppy(pong::PaddleAi::Parameters{12.f});
+
+    // Snapshots of one match after each goal; the players take
+    // turns aiming off the ball's center so that points are scored
+    const pong::MatchEstimator::Settings settings;
+    std::vector<pong::ClassicMatch>      snapshots;
+    pong::ClassicMatch                   match(pong::ClassicRules(), 1);
+    match.start();
+    snapshots.push_back(match);
+    for (std::uint32_t tick = 0; (tick < 100000) && (match.getState().phase != pong::Match::Phase::Over); ++tick)
+    {
+        const auto aim = static_cast<pong::Match::Fixed>(((tick / 500) % 3) * 16 - 16) * pong::Match::FixedOne;
+        if (match.step(sharp.decide(match, pong::Match::Left, aim), sloppy.decide(match, pong::Match::Right, -aim)) &
+            pong::Match::Goal)
+            snapshots.push_back(match);
+    }
+
+    for (const std::size_t threadCount : {std::size_t{1}, std::size_t{0}})
+    {
+        pong::ThreadPool           pool(threadCount);
+        const pong::MatchEstimator estimator(pool, settings);
+        std::cout << "  " << pool.getThreadCount() << " thread(s), budget " << std::fixed << std::setprecision(2)
+                  << settings.budget.asMicroseconds() / 1000.f << " ms" << std::endl;
+
+        for (const pong::ClassicMatch& snapshot : snapshots)
+        {
+            const pong::MatchEstimator::Estimate estimate = estimator.estimate(snapshot, sharp, sloppy);
+            const pong::Match::State&            state    = snapshot.getState();
+
+            std::cout << "    " << std::setw(2) << state.scores[pong::Match::Left] << '-' << std::left << std::setw(2)
+                      << state.scores[pong::Match::Right] << std::right << std::fixed << std::setprecision(3)
+                      << ": p = " << estimate.probability << " [" << estimate.low << ", " << estimate.high << "], "
+                      << std::setw(5) << estimate.continuations << " continuations in " << std::setprecision(2)
+                      << estimate.elapsed.asMicroseconds() / 1000.f << " ms"
+                      << (estimate.converged ? "" : " (budget ran out)") << std::endl;
+
+            // Continuations in flight notice the deadline within 1024 ticks
+            if (estimate.elapsed > settings.budget + settings.budget / 2.f)
+                std::cout << "  MISMATCH: the estimate overran its budget" << std::endl;
+        }
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+// Headless matches between computer players with aim noise,
+// simulated tick by tick and with event skipping; both must
+// end in exactly the same states. The players cover slow and
+// late ones, and dead zones too small to stay still in.
+////////////////////////////////////////////////////////////
+bool isSameState(const pong::MatchDefinitions::State& a, const pong::MatchDefinitions::State& b)
+{
+    return (a.phase == b.phase) && (a.tick == b.tick) && (a.phaseTicks == b.phaseTicks) &&
+           (a.ballPosition == b.ballPosition) && (a.ballVelocity == b.ballVelocity) &&
+           std::equal(a.paddles, a.paddles + 2, b.paddles) && std::equal(a.directions, a.directions + 2, b.directions) &&
+           std::equal(a.scores, a.scores + 2, b.scores) && (a.receiver == b.receiver) && (a.hits == b.hits) &&
+           (a.seed == b.seed) && (a.matchId == b.matchId);
+}
+
+
+template <typename MatchType>
+void measureEventSkipping(const char* name, const typename MatchType::Rules& rules)
+{
+    using Parameters = pong::PaddleAi::Parameters;
+
+    constexpr std::uint64_t matches  = 200;
+    constexpr std::uint32_t maxTicks = 36000;
+    constexpr std::size_t   left     = pong::Match::Left;
+    constexpr std::size_t   right    = pong::Match::Right;
+
+    const pong::PaddleAi players[] = {pong::PaddleAi(Parameters{2.f}),
+                                      pong::PaddleAi(Parameters{12.f}),
+                                      pong::PaddleAi(Parameters{0.5f}),
+                                      pong::PaddleAi(Parameters{4.f, 6.f, 3.f}),
+                                      pong::PaddleAi(Parameters{6.f, 2.f, -5.f, 0.7f})};
+    constexpr std::uint64_t playerCount = std::size(players);
+
+    std::vector<pong::MatchDefinitions::State> states;
+    std::uint64_t                              ticks = 0;
+    pong::TscClock                             tickClock;
+
+    for (std::uint64_t seed = 0; seed < matches; ++seed)
+    {
+        MatchType      match(rules, seed);
+        pong::AimNoise noise(24.f, 30, seed);
+        match.start();
+
+        const pong::PaddleAi& leftPlayer  = players[seed % playerCount];
+        const pong::PaddleAi& rightPlayer = players[seed / playerCount % playerCount];
+        for (std::uint32_t tick = 0; (tick < maxTicks) && (match.getState().phase != pong::Match::Phase::Over); ++tick)
+        {
+            match.step(leftPlayer.decide(match, left, noise.getAim(left)),
+                       rightPlayer.decide(match, right, noise.getAim(right)));
+            noise.step();
+        }
+
+        states.push_back(match.getState());
+        ticks += match.getState().tick;
+    }
+
+    const float   tickSeconds = tickClock.getElapsedTime().asSeconds();
+    std::uint64_t calls       = 0;
+    std::uint64_t mismatches  = 0;
+    pong::TscClock eventClock;
+
+    for (std::uint64_t seed = 0; seed < matches; ++seed)
+    {
+        MatchType      match(rules, seed);
+        pong::AimNoise noise(24.f, 30, seed);
+        match.start();
+
+        const pong::PaddleAi& leftPlayer  = players[seed % playerCount];
+        const pong::PaddleAi& rightPlayer = players[seed / playerCount % playerCount];
+        for (std::uint32_t tick = 0; (tick < maxTicks) && (match.getState().phase != pong::Match::Phase::Over); ++calls)
+            tick += pong::playNoisyTicks(match, leftPlayer, rightPlayer, noise, maxTicks - tick);
+
+        mismatches += !isSameState(match.getState(), states[seed]);
+    }
+
+    const float eventSeconds = eventClock.getElapsedTime().asSeconds();
+    std::cout << "  " << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(2)
+              << static_cast<float>(ticks) / tickSeconds / 1e6f << " M ticks/s tick by tick, "
+              << static_cast<float>(ticks) / eventSeconds / 1e6f << " M ticks/s skipping ("
+              << std::setprecision(1) << static_cast<float>(ticks) / static_cast<float>(calls) << " ticks per call, "
+              << tickSeconds / eventSeconds << "x)" << std::endl;
+
+    if (mismatches > 0)
+        std::cout << "  MISMATCH: " << mismatches << " matches ended differently when skipping" << std::endl;
+}
+
+
+////////////////////////////////////////////////////////////
+void benchEventSkipping()
+{
+    pong::MatchRules options;
+    options.spin     = pong::MatchRules::FixedOne / 2;
+    options.winByTwo = true;
+
+    measureEventSkipping<pong::ClassicMatch>("specialized (classic)", pong::ClassicRules());
+    measureEventSkipping<pong::Match>("generic (spin, win by 2)", options);
+}
+
+
+////////////////////////////////////////////////////////////
+// Philox blocks generated one at a time and in SIMD batches,
+// which must be the same, then noisy matches played on one
+// thread and on every hardware thread, each from its own
+// stream of a shared seed, which must end the same.
+////////////////////////////////////////////////////////////
+void benchPhilox()
+{
+    using Block = pong::Philox::Block;
+
+    constexpr std::uint32_t count   = 1 << 16;
+    constexpr std::uint64_t repeats = 64;
+    const pong::Philox      philox(0x5EED);
+    std::vector<Block>      single(count);
+    std::vector<Block>      batch(count);
+
+    pong::TscClock singleClock;
+    for (std::uint64_t repeat = 0; repeat < repeats; ++repeat)
+        for (std::uint32_t i = 0; i < count; ++i)
+            single[i] = philox.generate(repeat, i, 0);
+    const float singleSeconds = singleClock.getElapsedTime().asSeconds();
+
+    pong::TscClock batchClock;
+    for (std::uint64_t repeat = 0; repeat < repeats; ++repeat)
+        philox.generate(repeat, 0, 1, 0, batch.data(), count);
+    const float batchSeconds = batchClock.getElapsedTime().asSeconds();
+
+    std::cout << "  one at a time  " << std::fixed << std::setprecision(1) << std::setw(8)
+              << static_cast<float>(count * repeats) / singleSeconds / 1e6f << " M blocks/s\n"
+              << "  batches        " << std::setw(8) << static_cast<float>(count * repeats) / batchSeconds / 1e6f
+              << " M blocks/s" << std::endl;
+
+    if (single != batch)
+        std::cout << "  MISMATCH: batches differ from single blocks" << std::endl;
+
+    constexpr std::uint64_t    matches = 256;
+    const pong::PaddleAi       sharp;
+    const pong::PaddleAi       sloppy(pong::PaddleAi::Parameters{12.f});
+    std::vector<std::uint32_t> reference;
+
+    for (const std::size_t threadCount : {std::size_t{1}, std::size_t{0}})
+    {
+        pong::ThreadPool           pool(threadCount);
+        std::vector<std::uint32_t> results(matches);
+        std::atomic<std::uint64_t> next{0};
+        pong::TscClock             clock;
+
+        pool.run(
+            [&](std::size_t /* thread */)
+            {
+                for (std::uint64_t index = next++; index < matches; index = next++)
+                {
+                    const pong::MatchDefinitions::State state =
+                        pong::playNoisyMatch(sharp, sloppy, 24.f, 30, 36000, 1, index);
+                    results[index] = state.tick * 256 + state.scores[pong::Match::Left] * 16 +
+                                     state.scores[pong::Match::Right];
+                }
+            });
+
+        const float seconds = clock.getElapsedTime().asSeconds();
+        std::cout << "  " << pool.getThreadCount() << " thread(s)    " << std::setw(8)
+                  << static_cast<float>(matches) / seconds << " matches/s" << std::endl;
+
+        if (reference.empty())
+            reference = results;
+        else if (results != reference)
+            std::cout << "  MISMATCH: matches ended differently on " << pool.getThreadCount() << " threads" << std::endl;
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+struct Benchmark
+{
+    const char* name;
+    void (*run)();
+};
+
+constexpr Benchmark benchmarks[] = {
+    {"draw-calls", benchDrawCalls},
+    {"draw-calls-headless", benchDrawCallsHeadless},
+    {"instanced-sprites", benchInstancedSprites},
+    {"render-thread", benchRenderThread},
+    {"clock-reads", benchClockReads},
+    {"match-ticks", benchMatchTicks},
+    {"vector-kernels", benchVectorKernels},
+    {"transforms", benchTransforms},
+    {"rect-intersections", benchRectIntersections},
+    {"fast-trig", benchFastTrig},
+    {"match-estimator", benchMatchEstimator},
+    {"event-skipping", benchEventSkipping},
+    {"philox", benchPhilox},
+};
+
+} // namespace
+
+
+////////////////////////////////////////////////////////////
+/// Runs every benchmark, or only the ones named on the command line
+////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    bool found = (argc <= 1);
+
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        const bool selected = (argc <= 1) ||
+                              std::any_of(argv + 1, argv + argc, [&](const char* arg)
+                                          { return std::strcmp(arg, benchmark.name) == 0; });
+        if (!selected)
+            continue;
+
+        found = true;
+        std::cout << "== " << benchmark.name << " ==" << std::endl;
+        benchmark.run();
+    }
+
+    if (!found)
+    {
+        std::cerr << "Available benchmarks:";
+        for (const Benchmark& benchmark : benchmarks)
+            std::cerr << ' ' << benchmark.name;
+        std::cerr << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
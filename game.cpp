@@ -1,35 +1,514 @@
+#include "FramePacer.hpp"
+#include "IndexedTexture.hpp"
+#include "MatchEstimator.hpp"
+#include "MatchRenderer.hpp"
+#include "PaddleAi.hpp"
+#include "PowerManager.hpp"
+#include "RenderThread.hpp"
+#include "Replay.hpp"
+#include "TileMap.hpp"
 #include "sfml.h"
 
-int main() {
-  sf::RenderWindow window(sf::VideoMode(256, 240), "game");
+#ifdef __linux__
+#include "EventLoop.hpp"
+#endif
+
+#ifdef PONG_HEADLESS_EGL
+#include "HeadlessRenderTarget.hpp"
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+#ifdef PONG_HEADLESS_EGL
+namespace
+{
+////////////////////////////////////////////////////////////
+// The game loop without a window: frames are recorded and
+// replayed as usual, into an offscreen core profile target,
+// and the last one is saved to headless.png
+////////////////////////////////////////////////////////////
+int runHeadless(std::size_t frameCount)
+{
+    pong::HeadlessRenderTarget target;
+    if (!target.create({256, 240}))
+        return 1;
+
+    const auto                backend = pong::createRenderBackend(target, target.getSettings());
+    pong::PreTransformBatcher batcher;
+    pong::RenderCommandBuffer frame;
+    batcher.calibrate(*backend);
+
+    // Textures need SFML's own context: the ball is a plain square, as in the original Pong
+    const sf::Vertex ball[] = {{{0.f, 0.f}, sf::Color::White},
+                               {{16.f, 0.f}, sf::Color::White},
+                               {{0.f, 16.f}, sf::Color::White},
+                               {{0.f, 16.f}, sf::Color::White},
+                               {{16.f, 0.f}, sf::Color::White},
+                               {{16.f, 16.f}, sf::Color::White}};
+
+    sf::Clock clock;
+    for (std::size_t i = 0; i < frameCount; ++i)
+    {
+        sf::Transform transform;
+        transform.translate({static_cast<float>(i % 240), static_cast<float>(i % 224)});
+
+        frame.clear(sf::Color::Cyan);
+        frame.draw(ball, 6, sf::PrimitiveType::Triangles, sf::RenderStates(transform));
+        frame.sort();
+        frame.replay(*backend, &batcher);
+        target.display();
+    }
+
+    std::cout << "headless: " << frameCount << " frames, "
+              << clock.getElapsedTime().asSeconds() * 1000.f / static_cast<float>(frameCount) << " ms/frame" << std::endl;
+
+    return target.capture().saveToFile("headless.png") ? 0 : 1;
+}
+
+} // namespace
+#endif
+
+
+int main(int argc, char* argv[]) {
+  // --serial replays each frame on the main thread, for comparison with the render thread
+  // --core renders with an OpenGL 3.3 core profile context instead of SFML's legacy pipeline
+  // --crt applies the CRT post-process (render thread only)
+  // --indexed renders through a palette-indexed framebuffer (render thread only)
+  // --tiles draws an animated tile-map background (compatibility context, not with --indexed)
+  // --trace writes the render thread's timeline of the last frames to trace.json
+  // --headless renders 600 frames offscreen through EGL, without a window, e.g. in a container;
+  //   only in builds with the headless target (PONG_HEADLESS_EGL)
+  // --pace paces frames with the TSC-timed frame pacer instead of the epoll event loop, for comparison;
+  //   outside Linux, which has no epoll, the frame pacer always paces them
+  // --attract enters attract mode after 5 s without input instead of 30 s
+  // --odds prints the player's chances of winning after each goal, playing the player as the computer
+  // --record file records the player's match to a replay file, saved on exit
+  // --replay file plays a recorded match back instead of the player and the computer
+  bool serial   = false;
+  bool core     = false;
+  bool crt      = false;
+  bool indexed  = false;
+  bool tiles    = false;
+  bool trace    = false;
+  bool headless = false;
+  bool pace     = false;
+  bool attract  = false;
+  bool odds     = false;
+  std::string recordFile;
+  std::string replayFile;
+  for (int i = 1; i < argc; ++i)
+  {
+      const std::string argument = argv[i];
+      if ((argument == "--record") && (i + 1 < argc))
+          recordFile = argv[++i];
+      else if ((argument == "--replay") && (i + 1 < argc))
+          replayFile = argv[++i];
+      serial |= (argument == "--serial");
+      core |= (argument == "--core");
+      crt |= (argument == "--crt");
+      indexed |= (argument == "--indexed");
+      tiles |= (argument == "--tiles");
+      trace |= (argument == "--trace");
+      headless |= (argument == "--headless");
+      pace |= (argument == "--pace");
+      attract |= (argument == "--attract");
+      odds |= (argument == "--odds");
+  }
+
+  if (headless)
+  {
+#ifdef PONG_HEADLESS_EGL
+      return runHeadless(600);
+#else
+      std::cerr << "--headless needs a build with the headless EGL target (PONG_HEADLESS_EGL)" << std::endl;
+      return 1;
+#endif
+  }
+
+  const sf::ContextSettings settings = core ? sf::ContextSettings(0, 0, 0, 3, 3, sf::ContextSettings::Core) : sf::ContextSettings();
+  sf::RenderWindow window(sf::VideoMode(256, 240), "game", sf::Style::Default, settings);
   sf::Texture ballTexture;
     if (!ballTexture.loadFromFile("ball.png")) {
     window.close();
+    return 1;
 }
   sf::Sprite ball;
   ball.setTexture(ballTexture);
   ball.setPosition(sf::Vector2f(0,0));
-    while (window.isOpen())
+
+    // Index 1 is the background, the ball's colors follow
+    constexpr std::uint8_t   backgroundIndex = 1;
+    pong::IndexedFramebuffer indexedFramebuffer;
+    pong::IndexedTexture     ballIndices;
+    sf::RenderStates         ballStates;
+    sf::Color                clearColor = sf::Color::Cyan;
+    if (indexed && !serial)
+    {
+        sf::Image     ballImage;
+        pong::Palette palette{};
+        palette[backgroundIndex] = sf::Color::Cyan;
+
+        if (!ballImage.loadFromFile("ball.png") || !indexedFramebuffer.create())
+        {
+            window.close();
+            return 1;
+        }
+
+        // The match is drawn in white, which reads as index 255
+        palette[255] = sf::Color::White;
+
+        pong::addImageColors(ballImage, palette, backgroundIndex + 1);
+        if (!ballIndices.loadFromImage(ballImage, palette))
+        {
+            window.close();
+            return 1;
+        }
+
+        indexedFramebuffer.setPalette(0, palette);
+        ball.setTexture(ballIndices.getTexture(), true);
+        ballStates.shader = indexedFramebuffer.getIndexShader();
+        clearColor        = pong::IndexedFramebuffer::getClearColor(backgroundIndex);
+    }
+
+    // A checkerboard bigger than the screen, bordered by blinking tiles
+    constexpr unsigned int tileSize = 8;
+    constexpr unsigned int mapSize  = 64;
+    sf::Texture            tileset;
+    pong::TileMap          background;
+    sf::Clock              animationClock;
+    if (tiles && (core || indexed))
+    {
+        std::cout << "--tiles needs a compatibility context and can't be combined with --indexed, ignoring it" << std::endl;
+        tiles = false;
+    }
+    if (tiles)
+    {
+        // Tiles: dark, light, then the two frames of the border
+        const sf::Color tileColors[] = {{0, 96, 128}, {0, 128, 160}, {255, 255, 255}, {255, 128, 0}};
+
+        sf::Image tilesetImage;
+        tilesetImage.create({tileSize * 4, tileSize});
+        for (unsigned int x = 0; x < tileSize * 4; ++x)
+            for (unsigned int y = 0; y < tileSize; ++y)
+                tilesetImage.setPixel({x, y}, tileColors[x / tileSize]);
+
+        std::vector<std::uint16_t> cells(mapSize * mapSize);
+        for (unsigned int y = 0; y < mapSize; ++y)
+        {
+            for (unsigned int x = 0; x < mapSize; ++x)
+            {
+                const bool border = (x == 0) || (y == 0) || (x == mapSize - 1) || (y == mapSize - 1);
+                cells[y * mapSize + x] = border ? 2 : static_cast<std::uint16_t>((x + y) % 2);
+            }
+        }
+
+        if (!tileset.loadFromImage(tilesetImage) ||
+            !background.create(tileset, {tileSize, tileSize}, {mapSize, mapSize}, cells.data()))
+        {
+            window.close();
+            return 1;
+        }
+
+        background.setAnimation(2, 2, sf::milliseconds(500));
+    }
+
+    pong::RenderCommandBuffer            serialFrame;
+    pong::PreTransformBatcher            serialBatcher;
+    std::unique_ptr<pong::RenderBackend> serialBackend;
+    if (serial)
+    {
+        serialBackend = pong::createRenderBackend(window, window.getSettings());
+        serialBatcher.calibrate(*serialBackend);
+    }
+
+    const std::uint32_t crtEffects = crt ? pong::CrtPostProcess::All : pong::CrtPostProcess::None;
+    auto renderThread = serial ? nullptr : std::make_unique<pong::RenderThread>(window, crtEffects, indexed ? &indexedFramebuffer : nullptr);
+
+    std::size_t                             frames = 0;
+    pong::RenderCommandBuffer::StateChanges unsortedChanges;
+    pong::RenderCommandBuffer::StateChanges sortedChanges;
+    const auto accumulate = [](pong::RenderCommandBuffer::StateChanges& total, const pong::RenderCommandBuffer::StateChanges& changes)
+    {
+        total.drawCalls += changes.drawCalls;
+        total.shaderChanges += changes.shaderChanges;
+        total.textureBinds += changes.textureBinds;
+        total.blendChanges += changes.blendChanges;
+    };
+
+    // Space starts a match, W/S or Up/Down move the left paddle, P pauses;
+    // the computer plays the right paddle, and both in the attract-mode demo
+    const sf::Time       tickTime = sf::seconds(1.f / 60.f);
+    const pong::PaddleAi ai;
+    pong::Match          match;
+    pong::Match          demo;
+    pong::MatchRenderer  matchRenderer;
+    pong::PowerManager   power(window);
+    pong::TscClock       tickClock;
+    sf::Time             tickDebt;
+    auto                 lastState = power.getState();
+    if (attract)
+        power.setAttractDelay(sf::seconds(5.f));
+
+    // A replay gives the inputs of every tick of the match, from its first one
+    pong::Replay recording;
+    pong::Replay replay;
+    const bool   replaying = !replayFile.empty();
+    if (replaying)
+    {
+        if (!replay.loadFromFile(replayFile))
+        {
+            window.close();
+            return 1;
+        }
+
+        match     = replay.createMatch(pong::Match::Rules());
+        recording = pong::Replay(replay.getSeed(), replay.getMatchId());
+    }
+
+    std::unique_ptr<pong::ThreadPool>     oddsPool;
+    std::unique_ptr<pong::MatchEstimator> estimator;
+    if (odds)
+    {
+        oddsPool  = std::make_unique<pong::ThreadPool>();
+        estimator = std::make_unique<pong::MatchEstimator>(*oddsPool);
+    }
+
+    // While active, sleep until a tick is due or the window has events;
+    // frames are drawn flat out if the event loop can't be set up
+    pong::FramePacer pacer;
+#ifdef __linux__
+    enum : pong::EventLoop::Key
+    {
+        windowSource,
+        tickSource
+    };
+    pong::EventLoop eventLoop;
+    const bool      eventDriven = !pace && eventLoop.create() && eventLoop.addWindow(windowSource) &&
+                                eventLoop.addTimer(tickSource, tickTime);
+#else
+    pace = true;
+#endif
+
+    bool running = true;
+    while (running)
     {
+        if (power.getState() == pong::PowerManager::State::Active)
+        {
+            if (pace)
+                pacer.wait();
+#ifdef __linux__
+            else if (eventDriven)
+                eventLoop.wait();
+#endif
+        }
+
         sf::Event event;
-        while (window.pollEvent(event))
+        while (power.pollEvent(event))
         {
             if (event.type == sf::Event::Closed)
-                window.close();
+                running = false;
+
+            const bool playing = (match.getState().phase != pong::Match::Phase::Start) &&
+                                 (match.getState().phase != pong::Match::Phase::Over);
+            if ((event.type == sf::Event::KeyPressed) && (event.key.code == sf::Keyboard::P) && playing)
+                power.setPaused(!power.isPaused());
+            else if ((event.type == sf::Event::KeyPressed) && (event.key.code == sf::Keyboard::Space) && !playing && !replaying)
+            {
+                recording.recordStart();
+                match.start();
+            }
+        }
+
+        // Idle states don't catch up on the time they spent
+        const pong::PowerManager::State state = power.getState();
+        if (state != lastState)
+        {
+            tickClock.restart();
+            tickDebt = sf::Time::Zero;
+            pacer.restart();
+#ifdef __linux__
+            eventLoop.resetTimer(tickSource);
+#endif
+
+            if (state == pong::PowerManager::State::Attract)
+            {
+                demo = pong::Match(pong::Match::Rules(), frames);
+                demo.start();
+            }
+
+            lastState = state;
+        }
+
+        tickDebt = std::min(tickDebt + tickClock.restart(), tickTime * 4.f);
+        for (; tickDebt >= tickTime; tickDebt -= tickTime)
+        {
+            if (state == pong::PowerManager::State::Attract)
+            {
+                demo.step(ai.decide(demo, pong::Match::Left), ai.decide(demo, pong::Match::Right));
+                if (demo.getState().phase == pong::Match::Phase::Over)
+                    demo.start();
+            }
+            else if (state == pong::PowerManager::State::Active)
+            {
+                // The match stays as it ended once the replay is over
+                const std::uint32_t tick = match.getState().tick;
+                if (replaying && (tick >= replay.getTickCount()))
+                    continue;
+
+                const bool up   = sf::Keyboard::isKeyPressed(sf::Keyboard::W) || sf::Keyboard::isKeyPressed(sf::Keyboard::Up);
+                const bool down = sf::Keyboard::isKeyPressed(sf::Keyboard::S) || sf::Keyboard::isKeyPressed(sf::Keyboard::Down);
+                const pong::Replay::Input input = replaying ? replay.getInput(tick)
+                                                            : pong::Replay::Input{down - up, ai.decide(match, pong::Match::Right), false};
+                if (input.start)
+                    match.start();
+
+                recording.record(input.left, input.right);
+                const std::uint32_t events = match.step(input.left, input.right);
+
+                if (estimator && (events & pong::Match::Goal))
+                {
+                    const pong::MatchEstimator::Estimate estimate = estimator->estimate(match, ai, ai);
+                    std::cout << "Chances of winning: " << static_cast<int>(estimate.probability * 100.f + 0.5f)
+                              << "% (" << static_cast<int>(estimate.low * 100.f + 0.5f) << "-"
+                              << static_cast<int>(estimate.high * 100.f + 0.5f) << "%, " << estimate.continuations
+                              << " matches in " << estimate.elapsed.asMilliseconds() << " ms)" << std::endl;
+                }
+            }
+        }
+
+        // Nobody is playing on the title and game-over screens
+        const pong::Match::Phase phase = match.getState().phase;
+        power.setAttractEnabled((phase == pong::Match::Phase::Start) || (phase == pong::Match::Phase::Over));
+
+        pong::RenderCommandBuffer& frame = renderThread ? renderThread->beginFrame() : serialFrame;
+        frame.clear(clearColor);
+
+        if (tiles)
+        {
+            background.setTime(animationClock.getElapsedTime());
+            frame.setLayer(-1);
+            background.record(frame, window.getDefaultView());
+            frame.setLayer(0);
         }
 
-        window.clear(sf::Color::Cyan);
-      
 
         // start of frame
-      
-        window.draw(ball);
+
+        frame.draw(ball, ballStates);
+        matchRenderer.record(frame, (state == pong::PowerManager::State::Attract) ? demo : match);
 
 
         // end of frame
-        window.display();
+        accumulate(unsortedChanges, frame.countStateChanges());
+        frame.sort();
+        accumulate(sortedChanges, frame.countStateChanges());
+        ++frames;
+
+        if (renderThread)
+        {
+            renderThread->submitFrame();
+        }
+        else
+        {
+            frame.replay(*serialBackend, &serialBatcher);
+            window.display();
+        }
     }
 
+    if (frames > 0)
+    {
+        const auto perFrame = [frames](std::size_t count) { return static_cast<float>(count) / static_cast<float>(frames); };
+
+        std::cout << "texture binds: " << perFrame(unsortedChanges.textureBinds) << " -> "
+                  << perFrame(sortedChanges.textureBinds) << " per frame\n"
+                  << "blend changes: " << perFrame(unsortedChanges.blendChanges) << " -> "
+                  << perFrame(sortedChanges.blendChanges) << " per frame\n"
+                  << "shader changes: " << perFrame(unsortedChanges.shaderChanges) << " -> "
+                  << perFrame(sortedChanges.shaderChanges) << " per frame" << std::endl;
+    }
+
+    if (pace && (pacer.getStatistics().frames > 0))
+    {
+        const pong::FramePacer::Statistics& statistics = pacer.getStatistics();
+        std::cout << "pacing: " << statistics.missed << " missed deadlines in " << statistics.frames << " frames, jitter "
+                  << statistics.totalJitter.asSeconds() * 1e6f / static_cast<float>(statistics.frames) << " us mean, "
+                  << statistics.maxJitter.asSeconds() * 1e6f << " us max ("
+                  << (pong::TscClock::isTscUsed() ? "TSC" : "steady clock") << ')' << std::endl;
+    }
+
+#ifdef __linux__
+    if (eventDriven && (eventLoop.getStatistics().expirations > 0))
+    {
+        const pong::EventLoop::Statistics& statistics = eventLoop.getStatistics();
+        std::cout << "event loop: " << statistics.missed << " missed ticks in " << statistics.expirations << " ticks, jitter "
+                  << statistics.totalJitter.asSeconds() * 1e6f / static_cast<float>(statistics.expirations) << " us mean, "
+                  << statistics.maxJitter.asSeconds() * 1e6f << " us max" << std::endl;
+    }
+#endif
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(pong::PowerManager::State::Count); ++i)
+    {
+        const auto                      state = static_cast<pong::PowerManager::State>(i);
+        const pong::PowerManager::Usage usage = power.getUsage(state);
+        if (usage.wallTime > sf::Time::Zero)
+            std::cout << "power " << pong::PowerManager::getName(state) << ": " << usage.wallTime.asSeconds() << " s, "
+                      << static_cast<float>(usage.frames) / usage.wallTime.asSeconds() << " frames/s, "
+                      << usage.getCpuLoad() * 100.f << "% CPU" << std::endl;
+    }
+
+    if (renderThread)
+    {
+        const pong::RenderThread::Statistics statistics = renderThread->getStatistics();
+        const auto perFrame = [&](sf::Time time) { return time.asSeconds() * 1000.f / static_cast<float>(statistics.frames); };
+
+        if (statistics.frames > 0)
+            std::cout << "frames: " << statistics.frames << '\n'
+                      << "draws: " << statistics.draws << " -> " << statistics.drawCalls
+                      << " draw calls (pre-transform threshold " << statistics.threshold << " vertices)\n"
+                      << "record: " << perFrame(statistics.recordTime) << " ms/frame (stalled " << perFrame(statistics.recordStall) << ")\n"
+                      << "render: " << perFrame(statistics.renderTime) << " ms/frame (stalled " << perFrame(statistics.renderStall) << ")\n"
+                      << "record/render overlap: " << statistics.getSpeedup() << 'x' << std::endl;
+
+        if ((statistics.frames > 0) && (statistics.bytesStreamed > 0))
+            std::cout << "streamed: " << statistics.bytesStreamed / statistics.frames << " bytes/frame, "
+                      << statistics.fenceWaits << " fence waits (" << statistics.fenceWaitTime.asSeconds() * 1000.f << " ms)" << std::endl;
+
+        if (statistics.crtGpuTime != sf::Time::Zero)
+            std::cout << "crt pass: " << statistics.crtGpuTime.asSeconds() * 1000.f << " ms GPU"
+                      << (statistics.crtWithinBudget ? "" : " (over budget)") << std::endl;
+
+        if (statistics.frames > 0)
+        {
+            for (const pong::FrameProfiler::Average& pass : statistics.passes)
+                std::cout << pass.name << " pass: " << pass.time.asSeconds() * 1000.f << " ms "
+                          << (pass.domain == pong::FrameProfiler::Domain::Cpu ? "CPU" : "GPU") << '\n';
+            std::cout << std::flush;
+        }
+
+        if (trace)
+        {
+            std::ofstream file("trace.json");
+            renderThread->writeTrace(file);
+        }
+
+        // Give the context back to this thread before closing the window
+        renderThread.reset();
+    }
+
+    serialBackend.reset();
+    window.close();
+
+    if (!recordFile.empty() && !recording.saveToFile(recordFile))
+        return 1;
+
     return 0;
 
 
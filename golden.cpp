@@ -0,0 +1,295 @@
+#include "HeadlessRenderTarget.hpp"
+#include "Match.hpp"
+#include "MatchRenderer.hpp"
+#include "PaddleAi.hpp"
+#include "ParticleSystem.hpp"
+#include "RenderBackend.hpp"
+#include "RenderCommandBuffer.hpp"
+#include "sfml.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+
+#ifndef PONG_HEADLESS_EGL
+#error "golden needs the headless EGL render target, build it with PONG_HEADLESS_EGL"
+#endif
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Golden-image regression suite.
+//
+// Each scene sets a match up deterministically, then renders
+// a number of frames to a headless target; the last frame is
+// compared with golden/<scene>.png, and the mean frame time
+// (recording, replay and the GPU's work) with the scene's
+// budget. Pixels may differ by a few levels, since drivers
+// don't rasterize identically, but only a handful of them.
+//
+// Run with --update to record new golden images after an
+// intended visual change, and give scene names to run only
+// those. Differing frames are written next to the golden
+// images as <scene>.actual.png and <scene>.diff.png. A scene
+// without a golden image fails, so that a missing golden/
+// directory can't pass unnoticed; --update records it.
+////////////////////////////////////////////////////////////
+const std::filesystem::path goldenDirectory = "golden";
+constexpr int               channelTolerance = 16;     // Largest difference of a channel that still matches
+constexpr float             pixelTolerance   = 0.001f; // Fraction of the pixels allowed not to match
+const sf::Time              tickTime         = sf::seconds(1.f / 60.f);
+
+
+////////////////////////////////////////////////////////////
+struct World
+{
+    pong::Match          match{pong::Match::Rules(), 1};
+    pong::ParticleSystem particles{1};
+};
+
+
+////////////////////////////////////////////////////////////
+// Simulate a tick: the left paddle follows the ball, and the
+// right one too unless it is told to give the point away
+////////////////////////////////////////////////////////////
+std::uint32_t tick(World& world, bool rightMisses = false)
+{
+    const pong::PaddleAi ai;
+    const int            right  = rightMisses ? -1 : ai.decide(world.match, pong::Match::Right);
+    const std::uint32_t  events = world.match.step(ai.decide(world.match, pong::Match::Left), right);
+
+    if (events & pong::Match::Goal)
+    {
+        const sf::FloatRect ball = world.match.getBallBounds();
+        const sf::Vector2f  size(world.match.getRules().fieldSize);
+        const sf::Vector2f  goal(std::clamp(ball.left, 0.f, size.x), std::clamp(ball.top, 0.f, size.y));
+        world.particles.burst(goal, 512, sf::Color(255, 160, 64));
+    }
+
+    world.particles.update(tickTime);
+    return events;
+}
+
+
+////////////////////////////////////////////////////////////
+// Scenes: each setup brings the world to the moment to check
+////////////////////////////////////////////////////////////
+void setupStart(World&)
+{
+}
+
+
+////////////////////////////////////////////////////////////
+void setupRally(World& world)
+{
+    world.match.start();
+    for (int i = 0; i < 240; ++i)
+        tick(world);
+}
+
+
+////////////////////////////////////////////////////////////
+void setupGoal(World& world)
+{
+    world.match.start();
+    for (int i = 0; (i < 10000) && !(tick(world, true) & pong::Match::Goal); ++i)
+    {
+    }
+}
+
+
+////////////////////////////////////////////////////////////
+void setupBurst(World& world)
+{
+    setupRally(world);
+
+    const sf::Vector2f size(world.match.getRules().fieldSize);
+    world.particles.burst(size / 2.f, 10000, sf::Color(64, 160, 255), 160.f, sf::seconds(2.f));
+}
+
+
+////////////////////////////////////////////////////////////
+struct Scene
+{
+    const char* name;        //!< Name of the scene and of its golden image
+    void (*setup)(World&);   //!< Bring a new world to the start of the scene
+    bool        rightMisses; //!< Does the right paddle give points away while rendering?
+    int         frames;      //!< Number of frames rendered, the last one is compared
+    float       budget;      //!< Highest mean frame time, in milliseconds
+};
+
+constexpr Scene scenes[] = {
+    {"start", setupStart, false, 60, 2.f},
+    {"rally", setupRally, false, 60, 2.f},
+    {"goal", setupGoal, true, 30, 3.f},
+    {"burst", setupBurst, false, 30, 8.f},
+};
+
+
+////////////////////////////////////////////////////////////
+// Count the pixels that differ by more than the tolerance,
+// and paint them red over a dimmed copy of the expected image
+////////////////////////////////////////////////////////////
+std::size_t compareImages(const sf::Image& expected, const sf::Image& actual, sf::Image& diff)
+{
+    const sf::Vector2u size = expected.getSize();
+    if (actual.getSize() != size)
+        return static_cast<std::size_t>(size.x) * size.y;
+
+    const std::uint8_t* expectedPixels = expected.getPixelsPtr();
+    const std::uint8_t* actualPixels   = actual.getPixelsPtr();
+    std::size_t         mismatches     = 0;
+
+    diff.create(size);
+    for (unsigned int y = 0; y < size.y; ++y)
+    {
+        for (unsigned int x = 0; x < size.x; ++x)
+        {
+            const std::size_t offset = (static_cast<std::size_t>(y) * size.x + x) * 4;
+
+            int delta = 0;
+            for (std::size_t channel = 0; channel < 4; ++channel)
+                delta = std::max(delta, std::abs(expectedPixels[offset + channel] - actualPixels[offset + channel]));
+
+            const auto gray = static_cast<std::uint8_t>(
+                (expectedPixels[offset] + expectedPixels[offset + 1] + expectedPixels[offset + 2]) / 12);
+            const bool mismatch = delta > channelTolerance;
+            diff.setPixel({x, y}, mismatch ? sf::Color::Red : sf::Color(gray, gray, gray));
+            mismatches += mismatch;
+        }
+    }
+
+    return mismatches;
+}
+
+
+////////////////////////////////////////////////////////////
+// Render a scene and check it; returns true if it passed
+////////////////////////////////////////////////////////////
+bool runScene(const Scene& scene, pong::HeadlessRenderTarget& target, pong::RenderBackend& backend, bool update)
+{
+    World world;
+    scene.setup(world);
+
+    pong::MatchRenderer       renderer;
+    pong::RenderCommandBuffer frame;
+    sf::Time                  elapsed;
+
+    // The first frame is left out of the mean: it sizes the buffers
+    for (int i = 0; i < scene.frames; ++i)
+    {
+        sf::Clock clock;
+
+        frame.clear();
+        renderer.record(frame, world.match);
+        world.particles.record(frame);
+        frame.sort();
+        frame.replay(backend);
+        target.display();
+
+        if (i > 0)
+            elapsed += clock.getElapsedTime();
+
+        if (i + 1 < scene.frames)
+            tick(world, scene.rightMisses);
+    }
+
+    const float frameTime    = elapsed.asSeconds() * 1000.f / static_cast<float>(std::max(scene.frames - 1, 1));
+    const bool  withinBudget = frameTime <= scene.budget;
+
+    const sf::Image             actual = target.capture();
+    const std::filesystem::path golden = goldenDirectory / (std::string(scene.name) + ".png");
+    std::string                 result;
+    bool                        matches = true;
+
+    if (update)
+    {
+        std::filesystem::create_directories(goldenDirectory);
+        matches = actual.saveToFile(golden);
+        result  = matches ? "updated" : "FAILED to save";
+    }
+    else
+    {
+        sf::Image expected;
+        sf::Image diff;
+        if (!std::filesystem::exists(golden))
+        {
+            matches = false;
+            result  = "FAILED, no golden image (run with --update to record it)";
+        }
+        else if (!expected.loadFromFile(golden))
+        {
+            matches = false;
+            result  = "FAILED to load the golden image";
+        }
+        else
+        {
+            const sf::Vector2u size       = expected.getSize();
+            const std::size_t  mismatches = compareImages(expected, actual, diff);
+            matches = mismatches <= static_cast<std::size_t>(static_cast<float>(size.x * size.y) * pixelTolerance);
+            result  = matches ? "matches" : "DIFFERS (" + std::to_string(mismatches) + " pixels)";
+
+            if (!matches)
+            {
+                const std::string prefix = (goldenDirectory / scene.name).string();
+                if (!actual.saveToFile(prefix + ".actual.png") || !diff.saveToFile(prefix + ".diff.png"))
+                    result += ", failed to save the actual and diff images";
+            }
+        }
+    }
+
+    std::cout << std::left << std::setw(8) << scene.name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(8) << frameTime << " ms/frame (budget " << scene.budget << ")"
+              << (withinBudget ? "" : " OVER BUDGET") << ", " << result << std::endl;
+
+    return matches && withinBudget;
+}
+
+} // namespace
+
+
+////////////////////////////////////////////////////////////
+/// Runs every scene, or only the ones named on the command line
+////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    const bool update = std::any_of(argv + 1, argv + argc, [](const char* arg) { return std::strcmp(arg, "--update") == 0; });
+    const bool all    = std::all_of(argv + 1, argv + argc, [](const char* arg) { return std::strncmp(arg, "--", 2) == 0; });
+
+    pong::HeadlessRenderTarget target;
+    if (!target.create({256, 240}))
+        return 1;
+
+    const auto backend = pong::createRenderBackend(target, target.getSettings());
+
+    bool found  = all;
+    bool passed = true;
+    for (const Scene& scene : scenes)
+    {
+        const bool selected = all || std::any_of(argv + 1, argv + argc, [&](const char* arg)
+                                                 { return std::strcmp(arg, scene.name) == 0; });
+        if (!selected)
+            continue;
+
+        found = true;
+        passed &= runScene(scene, target, *backend, update);
+    }
+
+    if (!found)
+    {
+        std::cerr << "Available scenes:";
+        for (const Scene& scene : scenes)
+            std::cerr << ' ' << scene.name;
+        std::cerr << std::endl;
+        return 1;
+    }
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+#include "ThreadPool.hpp"
+#include "Tournament.hpp"
+#include "TscClock.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Tournament between computer player configurations.
+//
+// Each number on the command line adds a player with that
+// dead zone, in pixels; without any, a ladder of dead zones
+// from 1 to 24 pixels plays. Games run on every hardware
+// thread unless --threads says otherwise, and the results are
+// written to tournament.bin, or the file given with --output.
+//
+//   --swiss       Swiss pairings instead of a round-robin
+//   --rounds n    Rounds of a Swiss tournament
+//   --games n     Games per pairing and round
+//   --seed n      Seed of the games; the same seed replays the
+//                 same tournament, whatever the thread count
+//   --threads n   Threads playing the games
+//   --output file Results file, saved after every round
+//   --resume file Continue a saved tournament, e.g. one that
+//                 was interrupted, and save it back
+////////////////////////////////////////////////////////////
+const float defaultDeadZones[] = {1.f, 2.f, 4.f, 6.f, 8.f, 12.f, 16.f, 24.f};
+
+
+////////////////////////////////////////////////////////////
+void printStandings(const pong::Tournament& tournament)
+{
+    const std::vector<pong::Tournament::Entrant>& entrants = tournament.getEntrants();
+
+    std::vector<std::size_t> ranking(entrants.size());
+    std::iota(ranking.begin(), ranking.end(), std::size_t{0});
+    std::stable_sort(ranking.begin(),
+                     ranking.end(),
+                     [&](std::size_t a, std::size_t b) { return entrants[a].rating > entrants[b].rating; });
+
+    std::cout << "Standings after " << tournament.getRoundsPlayed() << " of " << tournament.getRoundCount()
+              << " rounds:" << std::endl;
+    for (std::size_t rank = 0; rank < ranking.size(); ++rank)
+    {
+        const pong::Tournament::Entrant& entrant = entrants[ranking[rank]];
+        std::cout << std::setw(4) << rank + 1 << ". " << std::left << std::setw(16) << entrant.name << std::right
+                  << std::fixed << std::setprecision(0) << std::setw(6) << entrant.rating << std::setprecision(1)
+                  << std::setw(8) << entrant.points << " / " << entrant.games << std::endl;
+    }
+}
+
+} // namespace
+
+
+////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    pong::Tournament::Settings settings;
+    std::size_t                threadCount = 0;
+    std::string                output      = "tournament.bin";
+    std::string                resume;
+    std::vector<float>         deadZones;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        const char*       value    = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (argument == "--swiss")
+        {
+            settings.format = pong::Tournament::Format::Swiss;
+        }
+        else if ((argument == "--rounds") && value)
+        {
+            settings.rounds = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            ++i;
+        }
+        else if ((argument == "--games") && value)
+        {
+            settings.gamesPerPairing = static_cast<std::uint32_t>(std::max(std::strtoul(value, nullptr, 10), 1ul));
+            ++i;
+        }
+        else if ((argument == "--seed") && value)
+        {
+            settings.seed = std::strtoull(value, nullptr, 10);
+            ++i;
+        }
+        else if ((argument == "--threads") && value)
+        {
+            threadCount = std::strtoul(value, nullptr, 10);
+            ++i;
+        }
+        else if ((argument == "--output") && value)
+        {
+            output = value;
+            ++i;
+        }
+        else if ((argument == "--resume") && value)
+        {
+            resume = output = value;
+            ++i;
+        }
+        else if (std::strtof(argument.c_str(), nullptr) > 0.f)
+        {
+            deadZones.push_back(std::strtof(argument.c_str(), nullptr));
+        }
+        else
+        {
+            std::cerr << "Usage: tournament [--swiss] [--rounds n] [--games n] [--seed n] [--threads n] "
+                         "[--output file] [--resume file] [dead zones...]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    pong::ThreadPool pool(threadCount);
+    pong::Tournament tournament(pool, settings);
+
+    if (!resume.empty())
+    {
+        if (!tournament.loadFromFile(resume))
+            return 1;
+    }
+    else
+    {
+        if (deadZones.empty())
+            deadZones.assign(std::begin(defaultDeadZones), std::end(defaultDeadZones));
+
+        for (const float deadZone : deadZones)
+        {
+            std::ostringstream name;
+            name << "deadzone-" << deadZone;
+            tournament.addEntrant(name.str(), pong::PaddleAi::Parameters{deadZone});
+        }
+    }
+
+    const std::size_t firstGame = tournament.getGames().size();
+    pong::TscClock    clock;
+    while (tournament.playRound())
+    {
+        std::cout << "Round " << tournament.getRoundsPlayed() << " of " << tournament.getRoundCount() << " played"
+                  << std::endl;
+
+        // Saved after every round, so an interrupted tournament
+        // resumes from its last completed round
+        if (!tournament.saveToFile(output))
+            return 1;
+    }
+    const float seconds = clock.getElapsedTime().asSeconds();
+
+    // Byes aren't games
+    const std::vector<pong::Tournament::Game>& games     = tournament.getGames();
+    std::size_t                                gameCount = 0;
+    std::uint64_t                              ticks     = 0;
+    for (std::size_t i = firstGame; i < games.size(); ++i)
+    {
+        gameCount += (games[i].left != games[i].right);
+        ticks += games[i].ticks;
+    }
+
+    printStandings(tournament);
+    if (gameCount > 0)
+        std::cout << gameCount << " games in " << std::setprecision(2) << seconds << " s on " << pool.getThreadCount()
+                  << " thread(s): " << std::setprecision(1) << static_cast<float>(gameCount) / seconds << " games/s, "
+                  << std::setprecision(2) << static_cast<float>(ticks) / seconds / 1e6f << " M ticks/s" << std::endl;
+
+    // Rounds already played were saved as they completed, but a
+    // resumed tournament may have had none left to play
+    return tournament.saveToFile(output) ? 0 : 1;
+}
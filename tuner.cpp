@@ -0,0 +1,128 @@
+#include "GeneticTuner.hpp"
+#include "ThreadPool.hpp"
+#include "TscClock.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+
+namespace
+{
+////////////////////////////////////////////////////////////
+// Evolve the parameters of the computer player against the
+// default one, and print the best of each generation. A
+// checkpoint is written to tuner.bin, or the file given with
+// --checkpoint, after every generation.
+//
+//   --generations n   Generations to evaluate
+//   --population n    Candidates per generation
+//   --games n         Games per candidate
+//   --seed n          Seed of the evolution and of the games
+//   --threads n       Threads playing the games
+//   --checkpoint file Checkpoint file
+//   --resume          Continue from the checkpoint, with its
+//                     settings, e.g. after an interruption
+////////////////////////////////////////////////////////////
+void printCandidate(const pong::GeneticTuner::Candidate& candidate)
+{
+    const pong::PaddleAi::Parameters& parameters = candidate.parameters;
+    std::cout << std::showpos << std::fixed << std::setprecision(2) << candidate.fitness << std::noshowpos
+              << " points per game (dead zone " << parameters.deadZone << ", reaction delay "
+              << parameters.reactionDelay << ", aim bias " << parameters.aimBias << ", speed " << parameters.speed
+              << ")";
+}
+
+} // namespace
+
+
+////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+    pong::GeneticTuner::Settings settings;
+    std::uint32_t                generations = 30;
+    std::size_t                  threadCount = 0;
+    std::string                  checkpoint  = "tuner.bin";
+    bool                         resume      = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        const char*       value    = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+        if (argument == "--resume")
+        {
+            resume = true;
+        }
+        else if ((argument == "--generations") && value)
+        {
+            generations = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            ++i;
+        }
+        else if ((argument == "--population") && value)
+        {
+            settings.populationSize = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            ++i;
+        }
+        else if ((argument == "--games") && value)
+        {
+            settings.gamesPerCandidate = static_cast<std::uint32_t>(std::strtoul(value, nullptr, 10));
+            ++i;
+        }
+        else if ((argument == "--seed") && value)
+        {
+            settings.seed = std::strtoull(value, nullptr, 10);
+            ++i;
+        }
+        else if ((argument == "--threads") && value)
+        {
+            threadCount = std::strtoul(value, nullptr, 10);
+            ++i;
+        }
+        else if ((argument == "--checkpoint") && value)
+        {
+            checkpoint = value;
+            ++i;
+        }
+        else
+        {
+            std::cerr << "Usage: tuner [--generations n] [--population n] [--games n] [--seed n] [--threads n] "
+                         "[--checkpoint file] [--resume]"
+                      << std::endl;
+            return 1;
+        }
+    }
+
+    pong::ThreadPool   pool(threadCount);
+    pong::GeneticTuner tuner(pool, settings);
+    if (resume && !tuner.loadFromFile(checkpoint))
+        return 1;
+
+    const std::uint32_t firstGeneration = tuner.getGeneration();
+    bool                saved           = true;
+    pong::TscClock      clock;
+
+    tuner.evolve(generations,
+                 [&](const pong::GeneticTuner& evolving)
+                 {
+                     std::cout << "Generation " << evolving.getGeneration() << ": ";
+                     printCandidate(evolving.getBest());
+                     std::cout << std::endl;
+
+                     saved &= evolving.saveToFile(checkpoint);
+                 });
+
+    const float         seconds = clock.getElapsedTime().asSeconds();
+    const std::uint64_t games   = std::uint64_t{tuner.getGeneration() - firstGeneration} *
+                                tuner.getSettings().populationSize * tuner.getSettings().gamesPerCandidate;
+
+    if (games > 0)
+        std::cout << games << " games in " << std::setprecision(2) << seconds << " s on " << pool.getThreadCount()
+                  << " thread(s): " << std::setprecision(1) << static_cast<float>(games) / seconds << " games/s"
+                  << std::endl;
+
+    return saved ? 0 : 1;
+}